@@ -13,7 +13,13 @@
 
 using namespace stk;
 
-static Kernel<KERNEL_DYNAMIC, _STK_BENCH_TASK_MAX + 1, SwitchStrategyRoundRobin, PlatformDefault> g_Kernel;
+#if _STK_BENCH_STRIDE
+typedef SwitchStrategyStride<_STK_BENCH_TASK_MAX + 1> BenchStrategy;
+#else
+typedef SwitchStrategyRoundRobin BenchStrategy;
+#endif
+
+static Kernel<KERNEL_DYNAMIC, _STK_BENCH_TASK_MAX + 1, BenchStrategy, PlatformDefault> g_Kernel;
 static volatile int64_t g_Ticks = 0;
 static volatile bool g_Enable = false;
 
@@ -31,12 +37,12 @@ extern "C" void SysTick_Handler()
 class BenchTask : public Task<_STK_BENCH_STACK_SIZE, ACCESS_PRIVILEGED>
 {
 public:
-    BenchTask() : m_id(~0), m_exited(false) {}
+    BenchTask() : m_id(~0) {}
     RunFuncType GetFunc() { return forced_cast<RunFuncType>(&BenchTask::RunInner); }
     void *GetFuncUserData() { return this; }
+    uint32_t GetWeight() const { return g_BenchWeight[m_id]; }
 
     void Initialize(uint8_t id) { m_id = id; }
-    bool IsExited() const { return m_exited; }
 
 private:
     void RunInner()
@@ -49,12 +55,9 @@ private:
         {
             g_Bench[index].Process();
         }
-
-        m_exited = true;
     }
 
-    uint8_t       m_id;
-    volatile bool m_exited;
+    uint8_t m_id;
 };
 
 static BenchTask g_Tasks[_STK_BENCH_TASK_MAX];
@@ -73,11 +76,9 @@ private:
             g_KernelService->Sleep(_STK_BENCH_WINDOW + 2);
         }
 
-    wait:
         for (int32_t i = 0; i < _STK_BENCH_TASK_MAX; ++i)
         {
-            if (!g_Tasks[i].IsExited())
-                goto wait;
+            g_Kernel.Join(&g_Tasks[i]);
         }
 
         Crc32Bench::ShowResults();
@@ -93,6 +94,10 @@ int main(int argc, char **argv)
 
     g_Kernel.Initialize();
 
+#if !_STK_BENCH_STRIDE
+    g_Kernel.GetStrategy().SetQuantum(_STK_BENCH_QUANTUM);
+#endif
+
     for (int32_t i = 0; i < _STK_BENCH_TASK_MAX; ++i)
     {
         g_Bench[i].Initialize();
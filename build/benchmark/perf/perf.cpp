@@ -11,6 +11,7 @@
 #include "perf.h"
 
 Crc32Bench g_Bench[_STK_BENCH_TASK_MAX];
+const uint32_t g_BenchWeight[_STK_BENCH_TASK_MAX] = _STK_BENCH_WEIGHTS;
 
 Crc32Bench::Crc32Bench()
 {
@@ -69,9 +70,24 @@ void Crc32Bench::ShowResults()
 
     printf("tasks %d | sum=%u avr=%u min=%u max=%u jitter=%u\n", _STK_BENCH_TASK_MAX, (uint)sum, (uint)average, (uint)min, (uint)max, (uint)jitter);
 
+#if _STK_BENCH_STRIDE
+    uint tickets = 0;
+    for (int32_t i = 0; i < _STK_BENCH_TASK_MAX; ++i)
+        tickets += g_BenchWeight[i];
+#endif
+
     for (int32_t i = 0; i < _STK_BENCH_TASK_MAX; ++i)
     {
-        printf("task %d = %u\n", (int)i, (uint)g_Bench[i].m_round);
+        // share of CPU time in percents
+        uint share = (sum != 0 ? (uint)((g_Bench[i].m_round * 100) / sum) : 0);
+
+    #if _STK_BENCH_STRIDE
+        // expected share is the share of tickets of the task (see stk::SwitchStrategyStride)
+        printf("task %d = %u (%u%%, tickets %u%%)\n", (int)i, (uint)g_Bench[i].m_round, share,
+            (uint)((g_BenchWeight[i] * 100) / tickets));
+    #else
+        printf("task %d = %u (%u%%)\n", (int)i, (uint)g_Bench[i].m_round, share);
+    #endif
     }
 }
 
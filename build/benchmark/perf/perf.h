@@ -16,6 +16,20 @@
 #define _STK_BENCH_STACK_SIZE 128
 #define _STK_BENCH_WINDOW     1000
 
+// time quantum of Round-Robin (ticks), larger quantum increases throughput (sum) at the cost of jitter
+#ifndef _STK_BENCH_QUANTUM
+    #define _STK_BENCH_QUANTUM    1
+#endif
+
+// 1 - schedule benchmark tasks with Stride (proportional-share) instead of Round-Robin, tasks get distinct weights
+// (tickets) from _STK_BENCH_WEIGHTS and printed shares of CPU time can be compared with the shares of tickets
+#ifndef _STK_BENCH_STRIDE
+    #define _STK_BENCH_STRIDE     0
+#endif
+
+// weights (tickets) of the benchmark tasks when _STK_BENCH_STRIDE is 1
+#define _STK_BENCH_WEIGHTS    { 6, 3, 1 }
+
 struct Crc32Bench
 {
     Crc32Bench();
@@ -29,5 +43,6 @@ struct Crc32Bench
 };
 
 extern Crc32Bench g_Bench[_STK_BENCH_TASK_MAX];
+extern const uint32_t g_BenchWeight[_STK_BENCH_TASK_MAX];
 
 #endif /* BENCH_H_ */
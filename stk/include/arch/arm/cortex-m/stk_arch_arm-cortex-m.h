@@ -27,10 +27,13 @@ public:
     void SetAccessMode(EAccessMode mode);
     void SwitchToNext();
     void SleepTicks(uint32_t ticks);
+    void Reschedule();
     void ProcessTick();
     void ProcessHardFault();
     void SetEventOverrider(IEventOverrider *overrider);
     size_t GetCallerSP();
+    void EnterCriticalSection();
+    void ExitCriticalSection();
 };
 
 /*! \typedef PlatformDefault
@@ -57,6 +57,26 @@ public:
         return stack_top;
     }
 
+    /*! \brief     Initialize initial frame at the top of the stack memory by filling it with STK_STACK_MEMORY_FILLER,
+                   the rest of the stack memory is not touched (see stk::STACK_USER_TASK_RESTART).
+        \note      Returned pointer is for a stack growing from top to down.
+        \param[in] memory: Stack memory which was initialized with InitStackMemory.
+        \param[in] frame_size: Size of the initial frame (number of size_t elements).
+        \return    Pointer to initialized stack memory.
+    */
+    static inline size_t *InitStackFrame(IStackMemory *memory, int32_t frame_size)
+    {
+        size_t *stack_top = memory->GetStack() + memory->GetStackSize();
+        size_t *itr = stack_top - frame_size;
+
+        STK_ASSERT(memory->GetStackSize() >= STACK_SIZE_MIN);
+
+        while (itr < stack_top)
+            *itr++ = STK_STACK_MEMORY_FILLER;
+
+        return stack_top;
+    }
+
     IPlatform::IEventHandler *m_handler;         //!< kernel event handler
     Stack                    *m_stack_idle;      //!< idle task stack
     Stack                    *m_stack_active;    //!< active task stack
@@ -12,7 +12,23 @@
 
 #include "stk_helper.h"
 #include "stk_arch.h"
+#include "stk_sched_analysis.h"
+#include "stk_timer.h"
+#include "stk_deferred.h"
+#include "stk_worker_pool.h"
+#include "stk_future.h"
+#include "stk_ipc.h"
+#include "stk_sync.h"
+#include "stk_channel.h"
+#include "stk_stream.h"
+#include "stk_state_channel.h"
+#include "stk_rcu.h"
 #include "strategy/stk_strategy_rrobin.h"
+#include "strategy/stk_strategy_cyclic.h"
+#include "strategy/stk_strategy_partitioned.h"
+#include "strategy/stk_strategy_rm.h"
+#include "strategy/stk_strategy_mlfq.h"
+#include "strategy/stk_strategy_stride.h"
 
 /*! \file  stk.h
     \brief Contains core implementation (Kernel) of the task scheduler.
@@ -58,6 +74,14 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
     */
     typedef StackMemoryWrapper<STACK_SIZE_MIN> TrapStackStackMemory;
 
+    /*! \enum  EModeInfo
+        \brief Info derived from the kernel operating mode.
+    */
+    enum EModeInfo
+    {
+        MODE_SRT_TASKS = (((_Mode & KERNEL_HRT) == 0) || ((_Mode & KERNEL_MIXED) != 0)) //!< 1 if soft real-time tasks are supported (non stk::KERNEL_HRT mode or stk::KERNEL_MIXED mode)
+    };
+
     /*! \enum  ERequest
         \brief Request flags.
     */
@@ -79,8 +103,16 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
         */
         enum EStateFlags
         {
-            STATE_NONE           = 0,       //!< none
-            STATE_REMOVE_PENDING = (1 << 0) //!< task signaled that it exited
+            STATE_NONE            = 0,        //!< none
+            STATE_REMOVE_PENDING  = (1 << 0), //!< task signaled that it exited
+            STATE_DEADLINE_MISSED = (1 << 1), //!< deadline of the current job is missed and the miss is handled
+            STATE_RESTART_PENDING = (1 << 2), //!< task must be restarted from its entry function when switched in
+            STATE_DEMOTED         = (1 << 3), //!< HRT task is demoted to a soft task due to the missed deadline
+            STATE_PREEMPTED       = (1 << 4), //!< HRT job is preempted by a higher priority task and will be resumed
+            STATE_WAITING         = (1 << 5), //!< task waits for a notification (see IKernelService::Wait)
+            STATE_NOTIFIED        = (1 << 6), //!< notification is pending (see IKernelService::Notify)
+            STATE_SUSPENDED       = (1 << 7), //!< task is suspended (see Kernel::Suspend)
+            STATE_DETACHED        = (1 << 8)  //!< suspended task is taken off the task switching strategy
         };
 
     public:
@@ -93,21 +125,41 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
             ITask *user_task; //!< user task to add
         };
 
+        /*! \class JoinRequest
+            \brief Request of the task waiting for the exit of this task (see Kernel::Join).
+            \note  Related to stk::KERNEL_DYNAMIC mode only.
+        */
+        struct JoinRequest
+        {
+            KernelTask   *joiner;    //!< waiting task
+            int32_t      *exit_code; //!< exit code destination, can be NULL
+            volatile bool done;      //!< true if task exited and its slot is released
+        };
+
         /*! \brief Default initializer.
         */
         explicit KernelTask() : m_user(NULL), m_stack(), m_state(STATE_NONE), m_access_mode(ACCESS_PRIVILEGED),
-            m_time_sleep(0), m_srt(), m_hrt() {}
+            m_time_sleep(0), m_asleep(false), m_quiescent(false), m_gp_pending(false), m_exit_code(0), m_join(NULL),
+            m_wait(NULL), m_wake_ticks(-1), m_index(0), m_srt(), m_hrt() {}
 
         ITask *GetUserTask() { return m_user; }
 
         Stack *GetUserStack() { return &m_stack; }
 
+        bool IsSleeping() const { return (m_time_sleep < 0) || ((m_state & STATE_SUSPENDED) != 0); }
+
+        uint32_t GetHrtPeriodicity() const { return (IsHrt() ? m_hrt[0].periodicity : 0); }
+
+        uint32_t GetHrtWcet() const { return (IsHrt() ? m_hrt[0].wcet : 0); }
+
+        uint32_t GetIndex() const { return m_index; }
+
         bool IsBusy() const { return (m_user != NULL); }
 
     private:
         /*! \class SrtInfo
             \brief Soft Real-Time info of the bound task.
-            \note  Related to non stk::KERNEL_HRT mode only.
+            \note  Related to non stk::KERNEL_HRT or stk::KERNEL_MIXED modes only.
         */
         struct SrtInfo
         {
@@ -121,9 +173,17 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
             void Clear()
             {
                 add_task_req = NULL;
+                budget       = 0;
+                period       = 0;
+                budget_left  = 0;
+                replenish    = 0;
             }
 
             AddTaskRequest *add_task_req; //!< add task request made from another active task (see Kernel::AddTask)
+            int32_t         budget;       //!< CPU budget reserved within the period (ticks), 0 if task has no reservation
+            int32_t         period;       //!< budget replenishment period (ticks)
+            int32_t         budget_left;  //!< budget left within the current period (ticks)
+            int32_t         replenish;    //!< time left until budget is replenished (ticks)
         };
 
         /*! \class HrtInfo
@@ -143,12 +203,14 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
             {
                 periodicity = 0;
                 deadline    = 0;
+                wcet        = 0;
                 duration    = 0;
                 last_ticks  = 0;
             }
 
             int32_t periodicity; //!< scheduling periodicity (ticks)
             int32_t deadline;    //!< work deadline (ticks)
+            int32_t wcet;        //!< worst-case execution time hint (ticks), 0 if not provided
             int32_t duration;    //!< current duration of the active state when work is being carried out by the task (ticks)
             int64_t last_ticks;  //!< last saved tick value obtained by IKernelService::GetTicks (ticks)
         };
@@ -177,13 +239,40 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
             m_state       = STATE_NONE;
             m_access_mode = ACCESS_PRIVILEGED;
             m_time_sleep  = 0;
+            m_asleep      = false;
+            m_quiescent   = false;
+            m_gp_pending  = false;
+            m_exit_code   = 0;
+            m_join        = NULL;
+            m_wait        = NULL;
+            m_wake_ticks  = -1;
 
             if (_Mode & KERNEL_HRT)
                 m_hrt[0].Clear();
-            else
+
+            if (MODE_SRT_TASKS)
                 m_srt[0].Clear();
         }
 
+        /*! \brief     Restart task from its entry function: initial frame is rebuilt in the same stack memory and
+                       task is ready to be scheduled (sleep, wait, suspension and pending exit are cancelled).
+            \note      Task must not be running, its context would overwrite the rebuilt frame when switched out.
+            \param[in] platform: Platform driver instance.
+        */
+        void Restart(_TyPlatform *platform)
+        {
+            if (!platform->InitStack(STACK_USER_TASK_RESTART, &m_stack, m_user, m_user))
+            {
+                STK_ASSERT(false);
+            }
+
+            m_state     &= ~(STATE_REMOVE_PENDING | STATE_WAITING | STATE_NOTIFIED | STATE_SUSPENDED);
+            m_time_sleep = 0;
+            m_wake_ticks = -1;
+            m_quiescent  = false;
+            m_exit_code  = 0;
+        }
+
         /*! \brief     Schedule the removal of the task from the kernel on next tick.
         */
         void ScheduleRemoval() { m_state |= STATE_REMOVE_PENDING; }
@@ -203,24 +292,102 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
             return (SP >= (size_t)start) && (SP <= (size_t)end);
         }
 
+        /*! \brief     Check if task is a periodic HRT task.
+            \note      In stk::KERNEL_MIXED mode soft tasks do not have periodicity assigned, HRT task becomes soft
+                       if demoted (see stk::DEADLINE_MISS_DEMOTE).
+        */
+        bool IsHrt() const
+        {
+            return ((_Mode & KERNEL_HRT) != 0) && (((_Mode & KERNEL_MIXED) == 0) || (m_hrt[0].periodicity != 0)) &&
+                ((m_state & STATE_DEMOTED) == 0);
+        }
+
+        /*! \brief     Reserve CPU budget for the soft task.
+            \note      Related to soft tasks only.
+            \param[in] budget_tc: CPU budget within the period (ticks), 0 to remove reservation.
+            \param[in] period_tc: Replenishment period (ticks).
+        */
+        void SrtSetBudget(uint32_t budget_tc, uint32_t period_tc)
+        {
+            m_srt[0].budget      = budget_tc;
+            m_srt[0].period      = period_tc;
+            m_srt[0].budget_left = budget_tc;
+            m_srt[0].replenish   = period_tc;
+        }
+
+        /*! \brief     Check if CPU budget is reserved for the soft task.
+            \note      Related to soft tasks only.
+        */
+        bool SrtHasBudget() const { return (m_srt[0].budget != 0); }
+
+        /*! \brief     Called on every tick while soft task is active, charges tick to the budget and throttles
+                       task when budget is exhausted.
+            \note      Related to soft tasks with a budget only.
+        */
+        void SrtOnTick()
+        {
+            if (m_srt[0].budget_left > 0)
+                --m_srt[0].budget_left;
+
+            // throttle until replenishment (keep longer sleep if task is going to sleep by itself)
+            if ((m_srt[0].budget_left == 0) && (m_time_sleep > -m_srt[0].replenish))
+                m_time_sleep = -m_srt[0].replenish;
+        }
+
+        /*! \brief     Called on every tick to replenish budget when its period elapses.
+            \note      Related to soft tasks with a budget only. Throttled task wakes up on the same tick.
+        */
+        void SrtUpdateBudget()
+        {
+            if (--m_srt[0].replenish == 0)
+            {
+                m_srt[0].replenish   = m_srt[0].period;
+                m_srt[0].budget_left = m_srt[0].budget;
+            }
+        }
+
         /*! \brief     Initialize task with HRT info.
             \note      Related to stk::KERNEL_HRT mode only.
             \param[in] periodicity_tc: Periodicity time at which task is scheduled (ticks).
             \param[in] deadline_tc: Deadline time within which a task must complete its work (ticks).
             \param[in] start_delay_tc: Initial start delay for the task (ticks).
+            \param[in] wcet_tc: Worst-case execution time hint (ticks), 0 if not provided.
         */
-        void HrtInit(uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc)
+        void HrtInit(uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc, uint32_t wcet_tc)
         {
             m_hrt[0].periodicity = periodicity_tc;
             m_hrt[0].deadline    = deadline_tc;
+            m_hrt[0].wcet        = wcet_tc;
             m_time_sleep         = -start_delay_tc;
         }
 
         /*! \brief     Called when task is switched into the scheduling process.
             \note      Related to stk::KERNEL_HRT mode only.
+            \param[in] platform: Platform driver instance.
             \param[in] ticks: Current ticks of the Kernel.
         */
-        void HrtOnSwitchedIn(int64_t ticks) { m_hrt[0].last_ticks = ticks; }
+        void HrtOnSwitchedIn(IPlatform *platform, int64_t ticks)
+        {
+            // aborted job: start task anew, its previous context was saved when it was switched out
+            if (m_state & STATE_RESTART_PENDING)
+            {
+                m_state &= ~STATE_RESTART_PENDING;
+
+                if (!platform->InitStack(STACK_USER_TASK_RESTART, &m_stack, m_user, m_user))
+                {
+                    STK_ASSERT(false);
+                }
+            }
+
+            // resumed job keeps its start time
+            if (m_state & STATE_PREEMPTED)
+            {
+                m_state &= ~STATE_PREEMPTED;
+                return;
+            }
+
+            m_hrt[0].last_ticks = ticks;
+        }
 
         /*! \brief     Called when task is switched out from the scheduling process.
             \note      Related to stk::KERNEL_HRT mode only.
@@ -234,15 +401,104 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
 
             STK_ASSERT(duration >= 0);
 
-            // check if deadline is missed (HRT failure)
+            // check if deadline is missed (HRT failure) unless already handled while job was running
+            if (HrtIsDeadlineMissed(duration) && ((m_state & STATE_DEADLINE_MISSED) == 0))
+                HrtOnDeadlineMissed(platform, duration);
+
+            // job is not completed but its time window is over (see ITaskSwitchStrategy::WINDOWED)
+            if (_TyStrategy::WINDOWED && (m_time_sleep >= 0) && !IsPendingRemoval() &&
+                ((m_state & (STATE_DEADLINE_MISSED | STATE_DEMOTED)) == 0))
+            {
+                HrtOnDeadlineMissed(platform, duration);
+            }
+
+            // demoted task continues as a soft task
+            if (m_state & STATE_DEMOTED)
+            {
+                m_time_sleep = 0;
+                return;
+            }
+
+            // job is not completed but preempted by a higher priority task (see ITaskSwitchStrategy::PREEMPTIVE)
+            if (_TyStrategy::PREEMPTIVE && (m_time_sleep >= 0) && ((m_state & STATE_DEADLINE_MISSED) == 0))
+            {
+                m_state |= STATE_PREEMPTED;
+                return;
+            }
+
+            if ((m_state & STATE_DEADLINE_MISSED) == 0)
+            {
+                m_time_sleep = -(m_hrt[0].periodicity - duration);
+                return;
+            }
+
+            m_state &= ~STATE_DEADLINE_MISSED;
+
+            // late job: wait for the next period boundary (skipping one more period if requested)
+            int32_t periodicity = m_hrt[0].periodicity;
+            int32_t release     = (periodicity - (duration % periodicity)) % periodicity;
+
+            if (m_user->GetDeadlineMissPolicy() == DEADLINE_MISS_SKIP_NEXT)
+                m_time_sleep = -(release + periodicity);
+            else
+                m_time_sleep = -release;
+        }
+
+        /*! \brief     Called on every tick while task is active to detect deadline miss of the running job as soon
+                       as it happens.
+            \note      Related to stk::KERNEL_HRT mode only.
+            \param[in] platform: Platform driver instance.
+            \param[in] ticks: Current ticks of the Kernel.
+        */
+        void HrtOnTick(IPlatform *platform, int64_t ticks)
+        {
+            // job is completed (see HrtOnWorkCompleted) or its miss is handled already
+            if ((m_time_sleep < 0) || (m_state & STATE_DEADLINE_MISSED))
+                return;
+
+            int32_t duration = m_hrt[0].duration + (ticks - m_hrt[0].last_ticks);
+
             if (HrtIsDeadlineMissed(duration))
             {
-                m_user->OnDeadlineMissed(duration);
+                HrtOnDeadlineMissed(platform, duration);
+
+                // aborted job must not run anymore, kernel will switch it out on this tick
+                if (m_state & STATE_RESTART_PENDING)
+                    HrtOnWorkCompleted();
+            }
+        }
+
+        /*! \brief     Called when deadline of the job is missed, applies policy of the task.
+            \note      Related to stk::KERNEL_HRT mode only.
+            \param[in] platform: Platform driver instance.
+            \param[in] duration: Duration of the job (ticks).
+        */
+        void HrtOnDeadlineMissed(IPlatform *platform, int32_t duration)
+        {
+            m_user->OnDeadlineMissed(duration);
+
+            switch (m_user->GetDeadlineMissPolicy())
+            {
+            case DEADLINE_MISS_SKIP_NEXT:
+                break;
+
+            case DEADLINE_MISS_RESTART:
+                // nothing to abort if job is completed already
+                if (m_time_sleep >= 0)
+                    m_state |= STATE_RESTART_PENDING;
+                break;
+
+            case DEADLINE_MISS_DEMOTE:
+                m_state |= STATE_DEMOTED;
+                return; // task is not HRT anymore
+
+            default:
                 platform->ProcessHardFault();
                 STK_ASSERT(false);
+                break;
             }
 
-            m_time_sleep = -(m_hrt[0].periodicity - duration);
+            m_state |= STATE_DEADLINE_MISSED;
         }
 
         /*! \brief     Called when task process called IKernelService::SwitchToNext to inform Kernel that work is completed.
@@ -260,7 +516,15 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
         uint32_t    m_state;      //!< state flags
         EAccessMode m_access_mode;//!< hw access mode
         int32_t     m_time_sleep; //!< time to sleep (ticks)
-        SrtInfo     m_srt[_Mode & KERNEL_HRT ? 0 : 1]; //!< Soft Real-Time info (does not occupy memory if kernel operation mode is stk::KERNEL_HRT)
+        bool        m_asleep;     //!< sleep state reported to the strategy (see Kernel::UpdateTaskReadiness)
+        volatile bool m_quiescent; //!< task gave CPU up voluntarily (sleeps or waits), it does not read data protected by RCU
+        bool        m_gp_pending; //!< task must pass a quiescent state to complete the current grace period
+        int32_t     m_exit_code;  //!< exit code (see IKernelService::SetExitCode)
+        JoinRequest *m_join;      //!< request of the task waiting for the exit, NULL if none (see Kernel::Join)
+        IWaitRegistration *m_wait;//!< active wait registration of the task, NULL if none (see IWaitRegistration)
+        int64_t     m_wake_ticks; //!< absolute tick to wake up at, -1 if sleep is relative (see OnTaskSleepUntil)
+        uint32_t    m_index;      //!< index of the slot in the task storage (see IKernelTask::GetIndex)
+        SrtInfo     m_srt[MODE_SRT_TASKS ? 1 : 0];     //!< Soft Real-Time info (does not occupy memory if kernel operation mode is stk::KERNEL_HRT without stk::KERNEL_MIXED)
         HrtInfo     m_hrt[_Mode & KERNEL_HRT ? 1 : 0]; //!< Hard Real-Time info (does not occupy memory if kernel operation mode is not stk::KERNEL_HRT)
     };
 
@@ -299,23 +563,108 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
 
         __stk_attr_noinline void Sleep(uint32_t sleep_ms)
         {
-            if ((_Mode & KERNEL_HRT) == 0)
+            if (MODE_SRT_TASKS)
             {
                 m_platform->SleepTicks((uint32_t)GetTicksFromMilliseconds(sleep_ms, GetTickResolution()));
             }
             else
             {
                 // sleeping is not supported in HRT mode, task will sleep according its periodicity and workload
+                // (except soft tasks of the KERNEL_MIXED mode)
+                STK_ASSERT(false);
+            }
+        }
+
+        __stk_attr_noinline void SleepUntil(int64_t ticks)
+        {
+            if (MODE_SRT_TASKS)
+            {
+                m_kernel->OnTaskSleepUntil(m_platform->GetCallerSP(), ticks);
+            }
+            else
+            {
+                // sleeping is not supported in HRT mode (except soft tasks of the KERNEL_MIXED mode)
                 STK_ASSERT(false);
             }
         }
 
         void SwitchToNext() { m_platform->SwitchToNext(); }
 
+        __stk_attr_noinline bool Wait(uint32_t timeout_ms)
+        {
+            if (MODE_SRT_TASKS)
+            {
+                int64_t ticks = (timeout_ms != WAIT_INFINITE ? GetTicksFromMilliseconds(timeout_ms, GetTickResolution()) : INT32_MAX);
+                return m_kernel->OnTaskWait(m_platform->GetCallerSP(), (uint32_t)(ticks < INT32_MAX ? ticks : INT32_MAX));
+            }
+            else
+            {
+                // waiting is not supported in HRT mode (except soft tasks of the KERNEL_MIXED mode)
+                STK_ASSERT(false);
+                return false;
+            }
+        }
+
+        __stk_attr_noinline bool WaitUntil(int64_t ticks)
+        {
+            if (MODE_SRT_TASKS)
+            {
+                STK_ASSERT(ticks >= 0);
+
+                if (ticks == WAIT_DEADLINE_INFINITE)
+                    return m_kernel->OnTaskWait(m_platform->GetCallerSP(), INT32_MAX);
+
+                return m_kernel->OnTaskWait(m_platform->GetCallerSP(), 0, ticks);
+            }
+            else
+            {
+                // waiting is not supported in HRT mode (except soft tasks of the KERNEL_MIXED mode)
+                STK_ASSERT(false);
+                return false;
+            }
+        }
+
+        void Notify(ITask *user_task) { m_kernel->OnTaskNotify(user_task); }
+
+        void Handoff(ITask *user_task) { m_kernel->OnTaskHandoff(user_task); }
+
+        uint32_t StartGracePeriod() { return m_kernel->OnGracePeriodStart(m_platform->GetCallerSP()); }
+
+        bool IsGracePeriodCompleted(uint32_t gp) const { return m_kernel->IsGracePeriodCompleted(gp); }
+
+        void SetExitCode(int32_t exit_code)
+        {
+            KernelTask *task = m_kernel->FindTaskBySP(m_platform->GetCallerSP());
+            STK_ASSERT(task != NULL);
+
+            task->m_exit_code = exit_code;
+        }
+
+        void SetWaitRegistration(IWaitRegistration *reg)
+        {
+            KernelTask *task = m_kernel->FindTaskBySP(m_platform->GetCallerSP());
+            STK_ASSERT(task != NULL);
+
+            task->m_wait = reg;
+        }
+
+        ITask *GetCurrentTask()
+        {
+            if (!m_kernel->IsStarted())
+                return NULL;
+
+            KernelTask *task = m_kernel->FindTaskBySP(m_platform->GetCallerSP());
+            return (task != NULL ? task->GetUserTask() : NULL);
+        }
+
+        void EnterCriticalSection() { m_platform->EnterCriticalSection(); }
+
+        void ExitCriticalSection() { m_platform->ExitCriticalSection(); }
+
     private:
         /*! \brief     Default initializer.
         */
-        explicit KernelService() : m_platform(0), m_ticks(0) {}
+        explicit KernelService() : m_platform(0), m_kernel(0), m_ticks(0) {}
 
     #ifdef _STK_UNDER_TEST
         /*! \brief     Destructor.
@@ -332,10 +681,12 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
             \note      When call completes Singleton<IKernelService *> will start referencing this
                        instance (see g_KernelService).
             \param[in] platform: IPlatform instance.
+            \param[in] kernel: Kernel instance.
         */
-        void Initialize(IPlatform *platform)
+        void Initialize(IPlatform *platform, Kernel *kernel)
         {
             m_platform = static_cast<_TyPlatform *>(platform);
+            m_kernel   = kernel;
 
             // make instance accessible for the user
             if (Singleton<IKernelService *>::Get() == NULL)
@@ -347,6 +698,7 @@ class Kernel : public IKernel, private IPlatform::IEventHandler
         void IncrementTick() { ++m_ticks; }
 
         _TyPlatform       *m_platform; //!< platform
+        Kernel            *m_kernel;   //!< kernel
         volatile int64_t m_ticks;    //!< CPU ticks elapsed (volatile to reload value from the memory by the consumer)
     };
 
@@ -360,8 +712,9 @@ public:
 
     /*! \brief Default initializer.
     */
-    explicit Kernel() : m_platform(), m_strategy(), m_task_now(NULL), m_task_storage(), m_sleep_trap(),
-        m_exit_trap(), m_fsm_state(FSM_STATE_NONE), m_request(~0), m_access_mode(ACCESS_PRIVILEGED)
+    explicit Kernel() : m_platform(), m_strategy(), m_task_now(NULL), m_task_handoff(NULL), m_task_storage(),
+        m_sleep_trap(), m_exit_trap(), m_fsm_state(FSM_STATE_NONE), m_request(~0), m_access_mode(ACCESS_PRIVILEGED),
+        m_gp_started(0), m_gp_completed(0), m_gp_requested(0), m_gp_waiting(0)
     {
     #ifdef _DEBUG
         // _TyPlatform must inherit IPlatform
@@ -372,21 +725,29 @@ public:
         ITaskSwitchStrategy *strategy = &m_strategy;
         (void)strategy;
     #endif
+
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+            m_task_storage[i].m_index = i;
     }
 
     __stk_attr_noinline void Initialize()
     {
         STK_ASSERT(!IsInitialized());
 
-        m_task_now    = NULL;
-        m_fsm_state   = FSM_STATE_NONE;
+        m_task_now     = NULL;
+        m_task_handoff = NULL;
+        m_fsm_state    = FSM_STATE_NONE;
         m_request     = REQUEST_NONE;
         m_access_mode = ACCESS_PRIVILEGED;
+        m_gp_started   = 0;
+        m_gp_completed = 0;
+        m_gp_requested = 0;
+        m_gp_waiting   = 0;
     }
 
     __stk_attr_noinline void AddTask(ITask *user_task)
     {
-        if ((_Mode & KERNEL_HRT) == 0)
+        if (MODE_SRT_TASKS)
         {
             STK_ASSERT(user_task != NULL);
             STK_ASSERT(IsInitialized());
@@ -415,36 +776,182 @@ public:
         }
     }
 
-    __stk_attr_noinline void AddTask(ITask *user_task, uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc)
+    __stk_attr_noinline void AddTask(ITask *user_task, uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc,
+        uint32_t wcet_tc = 0)
     {
-        if (_Mode & KERNEL_HRT)
+        if (!AddHrtTask(user_task, periodicity_tc, deadline_tc, start_delay_tc, wcet_tc))
+        {
+            // if hit here: task is rejected by admission control (see TryAddTask)
+            STK_ASSERT(false);
+        }
+    }
+
+    __stk_attr_noinline bool TryAddTask(ITask *user_task, uint32_t periodicity_tc, uint32_t deadline_tc,
+        uint32_t start_delay_tc, uint32_t wcet_tc)
+    {
+        STK_ASSERT(wcet_tc != 0);
+
+        return AddHrtTask(user_task, periodicity_tc, deadline_tc, start_delay_tc, wcet_tc);
+    }
+
+    __stk_attr_noinline void RemoveTask(ITask *user_task)
+    {
+        if (_Mode & KERNEL_DYNAMIC)
         {
-            STK_ASSERT(periodicity_tc != 0);
-            STK_ASSERT(deadline_tc != 0);
-            STK_ASSERT(periodicity_tc < INT32_MAX);
-            STK_ASSERT(deadline_tc < INT32_MAX);
             STK_ASSERT(user_task != NULL);
-            STK_ASSERT(IsInitialized());
             STK_ASSERT(!IsStarted());
 
-            AllocateAndAddNewTask(user_task)->HrtInit(periodicity_tc, deadline_tc, start_delay_tc);
+            KernelTask *task = FindTask(user_task);
+            if (task != NULL)
+                RemoveTask(task);
         }
         else
         {
+            // kernel operating mode must be KERNEL_DYNAMIC for tasks to be able to be removed
             STK_ASSERT(false);
         }
     }
 
-    __stk_attr_noinline void RemoveTask(ITask *user_task)
+    __stk_attr_noinline void SetTaskBudget(ITask *user_task, uint32_t budget_tc, uint32_t period_tc)
     {
-        if (_Mode & KERNEL_DYNAMIC)
+        if (MODE_SRT_TASKS)
         {
             STK_ASSERT(user_task != NULL);
+            STK_ASSERT(budget_tc <= period_tc);
+            STK_ASSERT(period_tc < INT32_MAX);
+            STK_ASSERT((budget_tc == 0) || (period_tc != 0));
             STK_ASSERT(!IsStarted());
 
             KernelTask *task = FindTask(user_task);
-            if (task != NULL)
+
+            // budget can be reserved for the soft tasks only
+            STK_ASSERT((task != NULL) && !task->IsHrt());
+
+            task->SrtSetBudget(budget_tc, period_tc);
+        }
+        else
+        {
+            // HRT tasks are limited by their deadline
+            STK_ASSERT(false);
+        }
+    }
+
+    __stk_attr_noinline void Suspend(ITask *user_task)
+    {
+        if (MODE_SRT_TASKS)
+        {
+            STK_ASSERT(user_task != NULL);
+            STK_ASSERT(IsStarted());
+
+            KernelTask *task = FindTask(user_task);
+
+            // HRT tasks are bound to their periodicity
+            STK_ASSERT((task != NULL) && !task->IsHrt());
+
+            KernelTask *caller = FindTaskBySP(m_platform.GetCallerSP());
+
+            m_platform.EnterCriticalSection();
+
+            if ((task->m_state & (KernelTask::STATE_SUSPENDED | KernelTask::STATE_REMOVE_PENDING)) == 0)
+            {
+                task->m_state |= KernelTask::STATE_SUSPENDED;
+
+                if (m_task_handoff == task)
+                    m_task_handoff = NULL;
+
+                // running task is iterated by the strategy, it is detached when switched out (see UpdateFsmState)
+                if (task != m_task_now)
+                    DetachTask(task);
+                else
+                    UpdateTaskReadiness(task);
+            }
+
+            m_platform.ExitCriticalSection();
+
+            // suspended task gives CPU up voluntarily
+            if (caller == task)
+            {
+                EnterQuiescentState(task);
+
+                while (task->m_state & KernelTask::STATE_SUSPENDED)
+                {
+                    __stk_relax_cpu();
+                }
+
+                task->m_quiescent = false;
+            }
+        }
+        else
+        {
+            // HRT tasks are bound to their periodicity
+            STK_ASSERT(false);
+        }
+    }
+
+    __stk_attr_noinline void Resume(ITask *user_task)
+    {
+        if (MODE_SRT_TASKS)
+        {
+            STK_ASSERT(user_task != NULL);
+
+            KernelTask *task = FindTask(user_task);
+            STK_ASSERT(task != NULL);
+
+            m_platform.EnterCriticalSection();
+
+            bool detached = ((task->m_state & KernelTask::STATE_DETACHED) != 0);
+
+            task->m_state &= ~(KernelTask::STATE_SUSPENDED | KernelTask::STATE_DETACHED);
+
+            if (detached)
+                AttachTask(task);
+            else
+                UpdateTaskReadiness(task);
+
+            m_platform.ExitCriticalSection();
+        }
+        else
+        {
+            // HRT tasks are bound to their periodicity
+            STK_ASSERT(false);
+        }
+    }
+
+    __stk_attr_noinline void Kill(ITask *user_task)
+    {
+        if (_Mode & KERNEL_DYNAMIC)
+        {
+            STK_ASSERT(user_task != NULL);
+            STK_ASSERT(IsStarted());
+
+            KernelTask *task = FindTask(user_task);
+            STK_ASSERT(task != NULL);
+
+            KernelTask *caller = FindTaskBySP(m_platform.GetCallerSP());
+
+            m_platform.EnterCriticalSection();
+
+            if (task != m_task_now)
+            {
                 RemoveTask(task);
+            }
+            else
+            {
+                // running task is iterated by the strategy, it is removed when switched out (see FetchNextEvent)
+                task->m_state &= ~KernelTask::STATE_SUSPENDED;
+                task->ScheduleRemoval();
+            }
+
+            m_platform.ExitCriticalSection();
+
+            // task which killed itself is switched out on the next tick and never returns
+            if (caller == task)
+            {
+                for (;;)
+                {
+                    __stk_relax_cpu();
+                }
+            }
         }
         else
         {
@@ -453,6 +960,127 @@ public:
         }
     }
 
+    __stk_attr_noinline bool Join(ITask *user_task, uint32_t timeout_ms = WAIT_INFINITE, int32_t *exit_code = NULL)
+    {
+        if (_Mode & KERNEL_DYNAMIC)
+        {
+            STK_ASSERT(user_task != NULL);
+            STK_ASSERT(IsStarted());
+
+            KernelTask *caller = FindTaskBySP(m_platform.GetCallerSP());
+            STK_ASSERT(caller != NULL);
+
+            // if hit here: task can't join itself
+            STK_ASSERT(caller->GetUserTask() != user_task);
+
+            typename KernelTask::JoinRequest req = { .joiner = caller, .exit_code = exit_code, .done = false };
+
+            int64_t deadline = GetWaitDeadline(&m_service, timeout_ms);
+
+            m_platform.EnterCriticalSection();
+
+            // task which already exited is not found (its slot is released)
+            KernelTask *task = FindTask(user_task);
+            if (task == NULL)
+            {
+                m_platform.ExitCriticalSection();
+                return true;
+            }
+
+            // if hit here: task is joined by another task already
+            STK_ASSERT(task->m_join == NULL);
+            task->m_join = &req;
+
+            while (!req.done)
+            {
+                // stale notification must not extend the timeout
+                if (m_service.GetTicks() >= deadline)
+                    break;
+
+                m_platform.ExitCriticalSection();
+
+                bool notified = m_service.WaitUntil(deadline);
+
+                m_platform.EnterCriticalSection();
+
+                if (!notified)
+                    break;
+            }
+
+            // slot is still bound to the task if it did not exit
+            if (!req.done)
+                task->m_join = NULL;
+
+            m_platform.ExitCriticalSection();
+
+            return req.done;
+        }
+        else
+        {
+            // kernel operating mode must be KERNEL_DYNAMIC for tasks to be able to exit
+            STK_ASSERT(false);
+            return false;
+        }
+    }
+
+    __stk_attr_noinline bool Restart(ITask *user_task)
+    {
+        if (MODE_SRT_TASKS)
+        {
+            STK_ASSERT(user_task != NULL);
+            STK_ASSERT(IsStarted());
+
+            m_platform.EnterCriticalSection();
+
+            // task which exited is not found (its slot is released)
+            KernelTask *task = FindTask(user_task);
+            if (task == NULL)
+            {
+                m_platform.ExitCriticalSection();
+                return false;
+            }
+
+            // HRT tasks are restarted by the deadline miss policy (see ITask::GetDeadlineMissPolicy)
+            STK_ASSERT(!task->IsHrt());
+
+            // if hit here: running task can't be restarted, return from its Run function or restart it from another task
+            STK_ASSERT(task != m_task_now);
+
+            // registration is located on the stack which is going to be rebuilt
+            CancelWait(task);
+
+            task->Restart(&m_platform);
+
+            // restarted task does not wait in Join anymore
+            CancelJoin(task);
+
+            // suspended task was taken off the strategy
+            if (task->m_state & KernelTask::STATE_DETACHED)
+            {
+                task->m_state &= ~KernelTask::STATE_DETACHED;
+                AttachTask(task);
+            }
+            else
+            {
+                UpdateTaskReadiness(task);
+            }
+
+            // restarted task does not hold the grace period
+            if (task->m_gp_pending)
+                OnQuiescentState(task);
+
+            m_platform.ExitCriticalSection();
+
+            return true;
+        }
+        else
+        {
+            // HRT tasks are bound to their periodicity
+            STK_ASSERT(false);
+            return false;
+        }
+    }
+
     __stk_attr_noinline void Start(uint32_t resolution_us = PERIODICITY_DEFAULT)
     {
         STK_ASSERT(resolution_us != 0);
@@ -464,7 +1092,7 @@ public:
         // stacks of the traps must be re-initilized on every subsequent Start
         InitTraps();
 
-        m_service.Initialize(&m_platform);
+        m_service.Initialize(&m_platform, this);
 
         m_platform.Start(this, resolution_us, (_Mode & KERNEL_DYNAMIC ? &m_exit_trap[0].stack : NULL));
     }
@@ -473,6 +1101,11 @@ public:
 
     IPlatform *GetPlatform() { return &m_platform; }
 
+    /*! \brief     Get task switching strategy instance, e.g. to configure it or to read its statistics.
+        \return    Reference to the _TyStrategy instance.
+    */
+    _TyStrategy &GetStrategy() { return m_strategy; }
+
 protected:
     /*! \enum  EFsmState
         \brief Finite-state machine (FSM) state.
@@ -549,108 +1182,350 @@ protected:
         // if NULL - exceeded max supported kernel task count, application design failure
         STK_ASSERT(new_task != NULL);
 
-        new_task->Bind(&m_platform, user_task);
+        new_task->Bind(&m_platform, user_task);
+
+        return new_task;
+    }
+
+    /*! \brief     Allocate new instance of KernelTask and add it into the scheduling process.
+        \param[in] user_task: User task for which kernel task object is allocated.
+        \return    Kernel task.
+    */
+    KernelTask *AllocateAndAddNewTask(ITask *user_task)
+    {
+        KernelTask *task = AllocateNewTask(user_task);
+        STK_ASSERT(task != NULL);
+
+        AttachTask(task);
+        return task;
+    }
+
+    /*! \brief     Request to add new task.
+        \note      Must be called by the task process only!
+        \param[in] user_task: User task to add.
+    */
+    __stk_attr_noinline void RequestAddTask(ITask *user_task)
+    {
+        KernelTask *caller = FindTaskBySP(m_platform.GetCallerSP());
+        STK_ASSERT(caller != NULL);
+
+        typename KernelTask::AddTaskRequest req = { .user_task = user_task };
+        caller->m_srt[0].add_task_req = &req;
+
+        // notify kernel
+        ScheduleAddTask();
+
+        // switch out and wait for completion (due to context switch request could be processed here)
+        __stk_full_memfence();
+        if (caller->m_srt[0].add_task_req != NULL)
+            m_platform.SwitchToNext();
+
+        STK_ASSERT(caller->m_srt[0].add_task_req == NULL);
+    }
+
+    /*! \brief     Find kernel task for the bound ITask instance.
+        \param[in] user_task: User task.
+        \return    Kernel task.
+    */
+    __stk_attr_noinline KernelTask *FindTask(const ITask *user_task)
+    {
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            KernelTask *task = &m_task_storage[i];
+            if (task->GetUserTask() == user_task)
+                return task;
+        }
+
+        return NULL;
+    }
+
+    /*! \brief     Find kernel task for the bound Stack instance.
+        \param[in] stack: Stack.
+        \return    Kernel task.
+    */
+    KernelTask *FindTask(const Stack *stack)
+    {
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            KernelTask *task = &m_task_storage[i];
+            if (task->GetUserStack() == stack)
+                return task;
+        }
+
+        return NULL;
+    }
+
+    /*! \brief     Find kernel task for a Stack Pointer (SP).
+        \param[in] SP: Stack pointer.
+        \return    Kernel task.
+    */
+    __stk_attr_noinline KernelTask *FindTaskBySP(size_t SP)
+    {
+        if (m_task_now->IsMemoryOfSP(SP))
+            return m_task_now;
+
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            KernelTask *task = &m_task_storage[i];
+            if (task->IsMemoryOfSP(SP))
+                return task;
+        }
+
+        return NULL;
+    }
+
+    /*! \brief     Add HRT task if it passes admission control.
+        \param[in] user_task: User task.
+        \param[in] periodicity_tc: Periodicity (ticks).
+        \param[in] deadline_tc: Deadline (ticks).
+        \param[in] start_delay_tc: Start delay (ticks).
+        \param[in] wcet_tc: Worst-case execution time hint (ticks), 0 if task is not accounted by admission control.
+        \return    True if task is added, false if it is rejected by admission control.
+    */
+    bool AddHrtTask(ITask *user_task, uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc,
+        uint32_t wcet_tc)
+    {
+        if (_Mode & KERNEL_HRT)
+        {
+            STK_ASSERT(periodicity_tc != 0);
+            STK_ASSERT(deadline_tc != 0);
+            STK_ASSERT(periodicity_tc < INT32_MAX);
+            STK_ASSERT(deadline_tc < INT32_MAX);
+            STK_ASSERT(user_task != NULL);
+            STK_ASSERT(IsInitialized());
+            STK_ASSERT(!IsStarted());
+
+            if (wcet_tc != 0)
+            {
+                STK_ASSERT(wcet_tc <= deadline_tc);
+                STK_ASSERT(deadline_tc <= periodicity_tc);
+
+                // admission control: reject task which makes HRT tasks unschedulable
+                if (!IsSchedulableWith(periodicity_tc, deadline_tc, wcet_tc))
+                    return false;
+            }
+
+            KernelTask *task = AllocateNewTask(user_task);
+            task->HrtInit(periodicity_tc, deadline_tc, start_delay_tc, wcet_tc);
+
+            // add when timing parameters are set, strategy may use them (e.g. to assign priority)
+            AttachTask(task);
+            return true;
+        }
+        else
+        {
+            STK_ASSERT(false);
+            return false;
+        }
+    }
+
+    /*! \brief     Check if HRT tasks with the WCET hint stay schedulable with a new task added.
+        \note      Analysis is selected by the scheduling policy of the task switching strategy (see SchedAnalysis).
+        \param[in] periodicity_tc: Periodicity of the new task (ticks).
+        \param[in] deadline_tc: Deadline of the new task (ticks).
+        \param[in] wcet_tc: Worst-case execution time of the new task (ticks).
+        \return    True if schedulable, otherwise false.
+    */
+    __stk_attr_noinline bool IsSchedulableWith(uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t wcet_tc)
+    {
+        SchedTaskInfo tasks[TASKS_MAX + 1];
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            const KernelTask *task = &m_task_storage[i];
+
+            if (task->IsBusy() && task->IsHrt() && (task->m_hrt[0].wcet != 0))
+            {
+                tasks[count].periodicity = task->m_hrt[0].periodicity;
+                tasks[count].wcet        = task->m_hrt[0].wcet;
+                tasks[count].deadline    = task->m_hrt[0].deadline;
+                ++count;
+            }
+        }
+
+        tasks[count].periodicity = periodicity_tc;
+        tasks[count].wcet        = wcet_tc;
+        tasks[count].deadline    = deadline_tc;
+        ++count;
+
+        return SchedAnalysis::IsSchedulable((ESchedPolicy)_TyStrategy::SCHED_POLICY, tasks, count);
+    }
+
+    /*! \brief     Remove kernel task.
+        \note      Removal of the kernel task means releasing it from the user task details.
+        \param[in] task: Kernel task.
+    */
+    void RemoveTask(KernelTask *task)
+    {
+        STK_ASSERT(task != NULL);
+
+        if (m_task_handoff == task)
+            m_task_handoff = NULL;
+
+        // removed task does not hold the grace period
+        if (task->m_gp_pending)
+            OnQuiescentState(task);
+
+        // suspended task could be taken off the strategy already
+        if ((task->m_state & KernelTask::STATE_DETACHED) == 0)
+            m_strategy.RemoveTask(task);
+
+        // removed task could be killed while waiting in Join or on the object
+        CancelJoin(task);
+        CancelWait(task);
+
+        typename KernelTask::JoinRequest *join = task->m_join;
+        int32_t exit_code = task->m_exit_code;
+
+        task->Unbind();
+
+        // release the joining task when slot is free
+        if (join != NULL)
+        {
+            if (join->exit_code != NULL)
+                (*join->exit_code) = exit_code;
 
-        return new_task;
+            join->done = true;
+            NotifyTask(join->joiner);
+        }
     }
 
-    /*! \brief     Allocate new instance of KernelTask and add it into the scheduling process.
-        \param[in] user_task: User task for which kernel task object is allocated.
-        \return    Kernel task.
+    /*! \brief     Cancel join requests of the task (see Join): request is located on the stack of the joining task,
+                   therefore it must not be referenced after the joining task is removed or restarted.
+        \param[in] joiner: Kernel task which could be waiting in Join.
     */
-    KernelTask *AllocateAndAddNewTask(ITask *user_task)
+    void CancelJoin(KernelTask *joiner)
     {
-        KernelTask *task = AllocateNewTask(user_task);
-        STK_ASSERT(task != NULL);
-
-        m_strategy.AddTask(task);
-        return task;
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            KernelTask *task = &m_task_storage[i];
+            if ((task->m_join != NULL) && (task->m_join->joiner == joiner))
+                task->m_join = NULL;
+        }
     }
 
-    /*! \brief     Request to add new task.
-        \note      Must be called by the task process only!
-        \param[in] user_task: User task to add.
+    /*! \brief     Cancel active wait registration of the task (see IWaitRegistration): registration is located on
+                   the stack of the task, therefore it must not be referenced after the task is removed or restarted.
+        \param[in] task: Kernel task which could be waiting on the object.
     */
-    __stk_attr_noinline void RequestAddTask(ITask *user_task)
+    void CancelWait(KernelTask *task)
     {
-        KernelTask *caller = FindTaskBySP(m_platform.GetCallerSP());
-        STK_ASSERT(caller != NULL);
-
-        typename KernelTask::AddTaskRequest req = { .user_task = user_task };
-        caller->m_srt[0].add_task_req = &req;
+        if (task->m_wait != NULL)
+        {
+            task->m_wait->CancelWait();
+            task->m_wait = NULL;
+        }
+    }
 
-        // notify kernel
-        ScheduleAddTask();
+    /*! \brief     Take suspended task off the task switching strategy, it is not iterated on the ticks anymore.
+        \note      Task must not be the current task of the strategy iteration (m_task_now).
+        \param[in] task: Kernel task.
+    */
+    void DetachTask(KernelTask *task)
+    {
+        STK_ASSERT(task != m_task_now);
 
-        // switch out and wait for completion (due to context switch request could be processed here)
-        __stk_full_memfence();
-        if (caller->m_srt[0].add_task_req != NULL)
-            m_platform.SwitchToNext();
+        m_strategy.RemoveTask(task);
+        task->m_state |= KernelTask::STATE_DETACHED;
+    }
 
-        STK_ASSERT(caller->m_srt[0].add_task_req == NULL);
+    /*! \brief     Add task to the strategy with its current sleep state (see UpdateTaskReadiness).
+        \param[in] task: Kernel task.
+    */
+    void AttachTask(KernelTask *task)
+    {
+        task->m_asleep = task->IsSleeping();
+        m_strategy.AddTask(task);
     }
 
-    /*! \brief     Find kernel task for the bound ITask instance.
-        \param[in] user_task: User task.
-        \return    Kernel task.
+    /*! \brief     Notify strategy if task went to sleep or woke up since the last notification (see
+                   ITaskSwitchStrategy::OnTaskSleep).
+        \note      Called within a critical section or from the system tick.
+        \param[in] task: Kernel task.
     */
-    __stk_attr_noinline KernelTask *FindTask(const ITask *user_task)
+    void UpdateTaskReadiness(KernelTask *task)
     {
-        for (uint32_t i = 0; i < TASKS_MAX; ++i)
-        {
-            KernelTask *task = &m_task_storage[i];
-            if (task->GetUserTask() == user_task)
-                return task;
-        }
+        // suspended task is taken off the strategy
+        if (task->m_state & KernelTask::STATE_DETACHED)
+            return;
 
-        return NULL;
+        bool asleep = task->IsSleeping();
+        if (asleep == task->m_asleep)
+            return;
+
+        task->m_asleep = asleep;
+
+        if (asleep)
+            m_strategy.OnTaskSleep(task);
+        else
+            m_strategy.OnTaskWake(task);
     }
 
-    /*! \brief     Find kernel task for the bound Stack instance.
-        \param[in] stack: Stack.
-        \return    Kernel task.
+    /*! \brief     Begin grace period: every task which runs or is preempted must pass a quiescent state (see
+                   EnterQuiescentState), tasks which sleep or wait are in a quiescent state already.
+        \note      Called within a critical section.
+        \param[in] caller: Task which is in a quiescent state (writer), or NULL.
     */
-    KernelTask *FindTask(const Stack *stack)
+    void BeginGracePeriod(KernelTask *caller)
     {
+        m_gp_started = m_gp_requested;
+        m_gp_waiting = 0;
+
         for (uint32_t i = 0; i < TASKS_MAX; ++i)
         {
             KernelTask *task = &m_task_storage[i];
-            if (task->GetUserStack() == stack)
-                return task;
+
+            if (task->IsBusy() && (task != caller) && !task->m_quiescent)
+            {
+                task->m_gp_pending = true;
+                ++m_gp_waiting;
+            }
         }
 
-        return NULL;
+        // no reader can hold the old data
+        if (m_gp_waiting == 0)
+            m_gp_completed = m_gp_started;
     }
 
-    /*! \brief     Find kernel task for a Stack Pointer (SP).
-        \param[in] SP: Stack pointer.
-        \return    Kernel task.
+    /*! \brief     Report quiescent state of the task and complete grace period if it was the last task.
+        \note      Called within a critical section.
+        \param[in] task: Kernel task.
     */
-    __stk_attr_noinline KernelTask *FindTaskBySP(size_t SP)
+    void OnQuiescentState(KernelTask *task)
     {
-        if (m_task_now->IsMemoryOfSP(SP))
-            return m_task_now;
+        task->m_gp_pending = false;
 
-        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        if (--m_gp_waiting == 0)
         {
-            KernelTask *task = &m_task_storage[i];
-            if (task->IsMemoryOfSP(SP))
-                return task;
-        }
+            m_gp_completed = m_gp_started;
 
-        return NULL;
+            // update was published while grace period was running
+            if (m_gp_requested != m_gp_completed)
+                BeginGracePeriod(task);
+        }
     }
 
-    /*! \brief     Remove kernel task.
-        \note      Removal of the kernel task means releasing it from the user task details.
+    /*! \brief     Mark task as being in a quiescent state when it gives CPU up voluntarily (sleeps, waits or
+                   switches to the next task).
+        \note      Preemption on tick is not a quiescent state because task can be preempted while reading data
+                   protected by RCU (see RcuPointer).
         \param[in] task: Kernel task.
     */
-    void RemoveTask(KernelTask *task)
+    void EnterQuiescentState(KernelTask *task)
     {
-        STK_ASSERT(task != NULL);
+        task->m_quiescent = true;
+        __stk_full_memfence();
 
-        m_strategy.RemoveTask(task);
-        task->Unbind();
+        if (task->m_gp_pending)
+        {
+            m_platform.EnterCriticalSection();
+
+            if (task->m_gp_pending)
+                OnQuiescentState(task);
+
+            m_platform.ExitCriticalSection();
+        }
     }
 
     /*! \brief     Update access mode of the Thread process.
@@ -688,15 +1563,19 @@ protected:
 
             // expecting only SLEEPING or SWITCHING states
             STK_ASSERT((m_fsm_state == FSM_STATE_SLEEPING) || (m_fsm_state == FSM_STATE_SWITCHING));
+
+            // first task may have a delayed start or be a soft task, therefore start with the selected one
+            if ((m_fsm_state == FSM_STATE_SWITCHING) && ((m_task_now->m_time_sleep < 0) || !m_task_now->IsHrt()))
+                m_task_now = next;
         }
 
         if (m_fsm_state == FSM_STATE_SWITCHING)
         {
             (*active) = m_task_now->GetUserStack();
 
-            if (_Mode & KERNEL_HRT)
+            if (m_task_now->IsHrt())
             {
-                m_task_now->HrtOnSwitchedIn(m_service.GetTicks());
+                m_task_now->HrtOnSwitchedIn(&m_platform, m_service.GetTicks());
             }
 
             SetAccessMode(m_task_now->m_access_mode);
@@ -713,7 +1592,21 @@ protected:
     bool OnTick(Stack **idle, Stack **active)
     {
         m_service.IncrementTick();
+        m_strategy.OnTick(m_service.GetTicks());
+
+        // charge elapsed tick to the budget of the running soft task before budgets are replenished
+        if (MODE_SRT_TASKS && IsTaskRunning() && !m_task_now->IsHrt() && m_task_now->SrtHasBudget())
+            m_task_now->SrtOnTick();
+
         UpdateTasks();
+
+        // detect deadline miss of the running HRT job without waiting for it to be switched out (exited task
+        // has no job running)
+        if ((_Mode & KERNEL_HRT) && IsTaskRunning() && m_task_now->IsHrt() && !m_task_now->IsPendingRemoval())
+        {
+            m_task_now->HrtOnTick(&m_platform, m_service.GetTicks());
+        }
+
         return UpdateFsmState(idle, active);
     }
 
@@ -727,19 +1620,204 @@ protected:
         KernelTask *task = FindTaskBySP(caller_SP);
         STK_ASSERT(task != NULL);
 
-        if (_Mode & KERNEL_HRT)
+        if (task->IsHrt())
         {
             task->HrtOnWorkCompleted();
         }
 
+        EnterQuiescentState(task);
+
+        m_platform.EnterCriticalSection();
+
         task->m_time_sleep -= sleep_ticks;
+        UpdateTaskReadiness(task);
+
+        m_platform.ExitCriticalSection();
+
+        while (task->m_time_sleep < 0)
+        {
+            __stk_relax_cpu();
+        }
+
+        task->m_quiescent = false;
+    }
+
+    /*! \brief     Put calling task into a sleep state until the absolute tick.
+        \param[in] caller_SP: Stack Pointer (SP) of the calling task.
+        \param[in] wake_ticks: Tick to wake up at (see IKernelService::GetTicks).
+    */
+    void OnTaskSleepUntil(size_t caller_SP, int64_t wake_ticks)
+    {
+        KernelTask *task = FindTaskBySP(caller_SP);
+        STK_ASSERT(task != NULL);
+        STK_ASSERT(!task->IsHrt());
+
+        EnterQuiescentState(task);
+
+        m_platform.EnterCriticalSection();
+
+        // tick can't elapse between reading the tick counter and setting the wake tick, therefore task wakes up
+        // exactly at wake_ticks regardless of when it was called, wake tick is compared with the tick counter
+        // (see UpdateTaskSleep) and is not limited by the range of the relative sleep time
+        if (wake_ticks > m_service.GetTicks())
+        {
+            task->m_wake_ticks = wake_ticks;
+            task->m_time_sleep = -1;
+            UpdateTaskReadiness(task);
+        }
+
+        m_platform.ExitCriticalSection();
 
         while (task->m_time_sleep < 0)
         {
             __stk_relax_cpu();
         }
+
+        task->m_wake_ticks = -1;
+        task->m_quiescent  = false;
+    }
+
+    /*! \brief     Put calling task into a waiting state until it is notified or timeout expires.
+        \note      Pending notification is consumed without waiting.
+        \param[in] caller_SP: Stack Pointer (SP) of the calling task.
+        \param[in] timeout_ticks: Timeout (ticks), ignored if wake_ticks is set.
+        \param[in] wake_ticks: Absolute tick at which timeout expires (see OnTaskSleepUntil), -1 if timeout is relative.
+        \return    True if notified, false if timeout expired.
+    */
+    bool OnTaskWait(size_t caller_SP, uint32_t timeout_ticks, int64_t wake_ticks = -1)
+    {
+        KernelTask *task = FindTaskBySP(caller_SP);
+        STK_ASSERT(task != NULL);
+        STK_ASSERT(!task->IsHrt());
+
+        EnterQuiescentState(task);
+
+        m_platform.EnterCriticalSection();
+
+        // deadline is compared with the tick counter within the critical section, therefore it can't be missed
+        if (((task->m_state & KernelTask::STATE_NOTIFIED) == 0) &&
+            ((wake_ticks < 0) || (wake_ticks > m_service.GetTicks())))
+        {
+            task->m_state |= KernelTask::STATE_WAITING;
+
+            if (wake_ticks < 0)
+            {
+                task->m_time_sleep = -(int32_t)timeout_ticks;
+            }
+            else
+            {
+                task->m_wake_ticks = wake_ticks;
+                task->m_time_sleep = -1;
+            }
+
+            UpdateTaskReadiness(task);
+
+            // directed switch to the ready task is made right away instead of the next tick (see OnTaskHandoff)
+            if ((m_task_handoff != NULL) && (task == m_task_now) && !m_task_handoff->IsSleeping())
+                m_platform.Reschedule();
+
+            m_platform.ExitCriticalSection();
+
+            // task is not scheduled until notified (see OnTaskNotify) or timeout expires
+            while (task->m_time_sleep < 0)
+            {
+                __stk_relax_cpu();
+            }
+
+            m_platform.EnterCriticalSection();
+
+            task->m_state      &= ~KernelTask::STATE_WAITING;
+            task->m_wake_ticks  = -1;
+        }
+
+        bool notified = ((task->m_state & KernelTask::STATE_NOTIFIED) != 0);
+        task->m_state &= ~KernelTask::STATE_NOTIFIED;
+
+        m_platform.ExitCriticalSection();
+
+        task->m_quiescent = false;
+
+        return notified;
+    }
+
+    /*! \brief     Notify task, wake it up if it is waiting (see OnTaskWait).
+        \note      Can be called from an ISR.
+        \param[in] user_task: User task.
+    */
+    void OnTaskNotify(ITask *user_task)
+    {
+        KernelTask *task = FindTask(user_task);
+        STK_ASSERT(task != NULL);
+
+        NotifyTask(task);
+    }
+
+    /*! \brief     Notify kernel task, wake it up if it is waiting (see OnTaskWait).
+        \param[in] task: Kernel task.
+    */
+    void NotifyTask(KernelTask *task)
+    {
+        m_platform.EnterCriticalSection();
+
+        task->m_state |= KernelTask::STATE_NOTIFIED;
+
+        if (task->m_state & KernelTask::STATE_WAITING)
+        {
+            task->m_time_sleep = 0;
+            UpdateTaskReadiness(task);
+        }
+
+        m_platform.ExitCriticalSection();
+    }
+
+    /*! \brief     Switch to task directly on the next scheduling point (see FetchNextEvent), the scheduling point
+                   is made right away if the calling task waits next (see OnTaskWait).
+        \note      Can be called from an ISR.
+        \param[in] user_task: User task.
+    */
+    void OnTaskHandoff(ITask *user_task)
+    {
+        KernelTask *task = FindTask(user_task);
+        STK_ASSERT(task != NULL);
+
+        m_platform.EnterCriticalSection();
+
+        // directed switch breaks the time partitioning of the HRT tasks
+        if (!(_Mode & KERNEL_HRT))
+            m_task_handoff = task;
+
+        m_platform.ExitCriticalSection();
+    }
+
+    /*! \brief     Start grace period (see IKernelService::StartGracePeriod).
+        \param[in] caller_SP: Stack Pointer (SP) of the calling task.
+        \return    Sequence number of the grace period.
+    */
+    uint32_t OnGracePeriodStart(size_t caller_SP)
+    {
+        // caller (writer) is in a quiescent state, NULL if called from an ISR
+        KernelTask *caller = FindTaskBySP(caller_SP);
+
+        m_platform.EnterCriticalSection();
+
+        // running grace period could start before the caller published its update, therefore the next one is
+        // requested and begins when the running one completes (see OnQuiescentState)
+        uint32_t gp = m_gp_started + 1;
+        m_gp_requested = gp;
+
+        if (m_gp_started == m_gp_completed)
+            BeginGracePeriod(caller);
+
+        m_platform.ExitCriticalSection();
+
+        return gp;
     }
 
+    /*! \brief     Check if grace period is completed.
+        \param[in] gp: Sequence number of the grace period (see OnGracePeriodStart).
+    */
+    bool IsGracePeriodCompleted(uint32_t gp) const { return ((int32_t)(m_gp_completed - gp) >= 0); }
+
     void OnTaskExit(Stack *stack)
     {
         if (_Mode & KERNEL_DYNAMIC)
@@ -756,6 +1834,35 @@ protected:
         }
     }
 
+    bool OnReschedule(Stack **idle, Stack **active)
+    {
+        // HRT tasks are switched on the ticks only
+        if (_Mode & KERNEL_HRT)
+            return false;
+
+        // exit from scheduling is made by the ISR of the tick (see StateExit)
+        if (!HasRunnableTask(m_task_now))
+            return false;
+
+        return UpdateFsmState(idle, active);
+    }
+
+    /*! \brief     Check if there is a task, other than the specified one, which is not pending removal.
+        \param[in] exclude: Kernel task to skip.
+    */
+    bool HasRunnableTask(const KernelTask *exclude) const
+    {
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            const KernelTask *task = &m_task_storage[i];
+
+            if ((task != exclude) && task->IsBusy() && !task->IsPendingRemoval())
+                return true;
+        }
+
+        return false;
+    }
+
     /*! \brief     Update tasks (sleep, requests).
     */
     void UpdateTasks()
@@ -773,7 +1880,21 @@ protected:
             KernelTask *task = &m_task_storage[i];
 
             if (task->m_time_sleep < 0)
-                ++task->m_time_sleep;
+            {
+                if (task->m_wake_ticks < 0)
+                    ++task->m_time_sleep;
+                else
+                if (m_service.GetTicks() >= task->m_wake_ticks)
+                    task->m_time_sleep = 0;
+            }
+
+            if (MODE_SRT_TASKS && task->SrtHasBudget())
+                task->SrtUpdateBudget();
+
+            // report tasks which woke up on this tick, and the ones which went to sleep without a notification
+            // (e.g. HRT job switched out, exhausted budget)
+            if (task->IsBusy())
+                UpdateTaskReadiness(task);
         }
     }
 
@@ -790,7 +1911,7 @@ protected:
 
             // process serialized AddTask request made from another active task, requesting process
             // is currently waiting due to SwitchToNext()
-            if (((_Mode & KERNEL_HRT) == 0) && ((_Mode & KERNEL_DYNAMIC) != 0))
+            if (MODE_SRT_TASKS && ((_Mode & KERNEL_DYNAMIC) != 0))
             {
                 if (task->m_srt[0].add_task_req != NULL)
                 {
@@ -810,7 +1931,21 @@ protected:
     EFsmEvent FetchNextEvent(KernelTask **next)
     {
         EFsmEvent type = FSM_EVENT_SWITCH;
-        KernelTask *itr = m_task_now, *prev = m_task_now, *sleep_end = NULL, *pending_end = NULL;
+
+        // directed switch (see OnTaskHandoff) bypasses the strategy if the target is ready to run
+        if (m_task_handoff != NULL)
+        {
+            KernelTask *target = m_task_handoff;
+            m_task_handoff = NULL;
+
+            if (!target->IsSleeping() && !target->IsPendingRemoval())
+            {
+                (*next) = target;
+                return (m_fsm_state == FSM_STATE_SLEEPING ? FSM_EVENT_WAKE : FSM_EVENT_SWITCH);
+            }
+        }
+
+        KernelTask *itr = m_task_now, *prev = m_task_now, *sleep_end = NULL, *pending_end = NULL, *soft = NULL;
 
         for (;;)
         {
@@ -821,7 +1956,7 @@ protected:
                     itr = static_cast<KernelTask *>(m_strategy.GetNext(prev));
 
                     // process pending task removal
-                    if (itr->IsPendingRemoval())
+                    if ((itr != NULL) && itr->IsPendingRemoval())
                     {
                         // we can't remove current task because task switching driver context is branchless
                         // therefore make any other task as current, switch to it and then remove pending
@@ -831,7 +1966,7 @@ protected:
                             if (pending_end == NULL)
                                 pending_end = itr;
 
-                            if (_Mode & KERNEL_HRT)
+                            if (itr->IsHrt())
                             {
                                 // current task will not be switched out in StateSwitch because it is the last one
                                 // therefore make sure deadline is checked for this task
@@ -868,14 +2003,48 @@ protected:
                 itr = static_cast<KernelTask *>(m_strategy.GetNext(prev));
             }
 
+            // strategy has no task to schedule (e.g. idle slot of the static schedule)
+            if ((itr == NULL) && (type != FSM_EVENT_EXIT))
+            {
+                if (soft == NULL)
+                {
+                    type = FSM_EVENT_SLEEP;
+                    break;
+                }
+
+                itr = soft;
+            }
+
+            // in KERNEL_MIXED mode (or if HRT task is demoted) soft task is deferred until none of the HRT tasks
+            // is ready to run
+            bool deferred = false;
+            if ((_Mode & KERNEL_HRT) && (itr != NULL) && !itr->IsSleeping() && !itr->IsHrt())
+            {
+                if (soft == NULL)
+                    soft = itr;
+
+                deferred = true;
+            }
+
             // check if task is sleeping
-            if ((itr != NULL) && (itr->m_time_sleep < 0))
+            if ((itr != NULL) && (itr->IsSleeping() || deferred))
             {
                 // if iterated back to self then all tasks are sleeping and kernel should enter a sleep mode
                 if (itr == sleep_end)
                 {
-                    itr  = NULL;
-                    type = FSM_EVENT_SLEEP;
+                    // HRT tasks are sleeping, give slack time to the soft task
+                    if (soft != NULL)
+                    {
+                        itr = soft;
+
+                        if (m_fsm_state == FSM_STATE_SLEEPING)
+                            type = FSM_EVENT_WAKE;
+                    }
+                    else
+                    {
+                        itr  = NULL;
+                        type = FSM_EVENT_SLEEP;
+                    }
                     break;
                 }
 
@@ -942,6 +2111,14 @@ protected:
         }
 
         m_fsm_state = new_state;
+
+        // running task which was suspended is switched out and can be taken off the strategy now
+        if ((now != NULL) && (now != m_task_now) &&
+            ((now->m_state & (KernelTask::STATE_SUSPENDED | KernelTask::STATE_DETACHED)) == KernelTask::STATE_SUSPENDED))
+        {
+            DetachTask(now);
+        }
+
         return switch_context;
     }
 
@@ -974,8 +2151,11 @@ protected:
         {
             int64_t ticks = m_service.GetTicks();
 
-            now->HrtOnSwitchedOut(&m_platform, ticks);
-            next->HrtOnSwitchedIn(ticks);
+            if (now->IsHrt())
+                now->HrtOnSwitchedOut(&m_platform, ticks);
+
+            if (next->IsHrt())
+                next->HrtOnSwitchedIn(&m_platform, ticks);
         }
 
         UpdateAccessMode(next);
@@ -1004,9 +2184,9 @@ protected:
 
         m_task_now = next;
 
-        if (_Mode & KERNEL_HRT)
+        if (next->IsHrt())
         {
-            next->HrtOnSwitchedIn(m_service.GetTicks());
+            next->HrtOnSwitchedIn(&m_platform, m_service.GetTicks());
         }
 
         UpdateAccessMode(next);
@@ -1032,7 +2212,7 @@ protected:
 
         m_task_now = static_cast<KernelTask *>(m_strategy.GetFirst());
 
-        if (_Mode & KERNEL_HRT)
+        if (now->IsHrt())
         {
             now->HrtOnSwitchedOut(&m_platform, m_service.GetTicks());
         }
@@ -1083,6 +2263,11 @@ protected:
     ITaskSwitchStrategy *GetSwitchStrategy() { return &m_strategy; }
 #endif
 
+    /*! \brief     Check if user task is running (Kernel is not in a sleeping state).
+        \return    True if running, otherwise false.
+    */
+    bool IsTaskRunning() const { return (m_fsm_state == FSM_STATE_SWITCHING) || (m_fsm_state == FSM_STATE_WAKING); }
+
     /*! \brief     Check if kernel was initialized with IKernel::Initialize().
         \return    True if initialized, otherwise false.
     */
@@ -1106,6 +2291,9 @@ protected:
     STK_STATIC_ASSERT_N(KENREL_MODE_HRT_ALONE, ((_Mode & KERNEL_HRT) == 0) ||
         ((_Mode & KERNEL_HRT) && ((_Mode & KERNEL_STATIC) || (_Mode & KERNEL_DYNAMIC))));
 
+    // If hit here: KERNEL_MIXED must accompany KERNEL_HRT.
+    STK_STATIC_ASSERT_N(KENREL_MODE_MIXED_NO_HRT, ((_Mode & KERNEL_MIXED) == 0) || ((_Mode & KERNEL_HRT) != 0));
+
     /*! \typedef TaskStorageType
         \brief   KernelTask array type used as a storage for the KernelTask instances.
     */
@@ -1132,12 +2320,17 @@ protected:
     _TyPlatform     m_platform;        //!< platform driver
     _TyStrategy     m_strategy;        //!< task switching strategy
     KernelTask     *m_task_now;        //!< current task task
+    KernelTask     *m_task_handoff;    //!< task to switch to on the next scheduling point (see OnTaskHandoff), NULL if none
     TaskStorageType m_task_storage;    //!< task storage
     TrapStack       m_sleep_trap[1];   //!< sleep trap
     TrapStack       m_exit_trap[_Mode & KERNEL_DYNAMIC ? 1 : 0]; //!< exit trap (does not occupy memory if kernel operation mode is not KERNEL_DYNAMIC)
     EFsmState       m_fsm_state;       //!< FSM state
     uint32_t        m_request;         //!< pending requests from the tasks
     EAccessMode     m_access_mode;     //!< current access mode
+    uint32_t        m_gp_started;      //!< sequence number of the last started grace period
+    volatile uint32_t m_gp_completed;  //!< sequence number of the last completed grace period
+    uint32_t        m_gp_requested;    //!< sequence number of the last requested grace period
+    uint32_t        m_gp_waiting;      //!< number of tasks which must pass a quiescent state to complete grace period
 
     const EFsmState m_fsm[FSM_STATE_MAX][FSM_EVENT_MAX] = {
     //    FSM_EVENT_SWITCH     FSM_EVENT_SLEEP     FSM_EVENT_WAKE    FSM_EVENT_EXIT
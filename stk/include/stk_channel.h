@@ -0,0 +1,229 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_CHANNEL_H_
+#define STK_CHANNEL_H_
+
+#include "stk_sync.h"
+
+/*! \file  stk_channel.h
+    \brief Contains zero-copy channel which passes ownership of the buffers between tasks.
+*/
+
+namespace stk {
+
+/*! \class LoanChannel
+    \brief Zero-copy channel: producer takes a buffer from the fixed pool of _Count buffers of _BufferSize bytes
+           (see Acquire), fills it and sends it to the consumer (see Send), consumer receives it (see Receive) and
+           returns it to the pool when done (see Release).
+
+    Only ownership of the buffer (pointer and length) is passed, payload is never copied. Producer blocks while
+    all buffers are in flight (pool is exhausted), consumer blocks while no buffer is sent. Buffers are received
+    in the order of sending.
+
+    Buffers are aligned to the size of the pointer.
+
+    \note  Release can be called from an ISR (e.g. on completion of DMA transfer from the buffer). Acquire, Send
+           and Receive with a 0 timeout can be called from an ISR too.
+
+    Usage example:
+    \code
+    static stk::LoanChannel<1024, 4> g_Frames;
+
+    // producer task
+    uint8_t *frame = g_Frames.Acquire();
+    uint32_t length = CaptureFrame(frame, g_Frames.GetBufferSize());
+    g_Frames.Send(frame, length);
+
+    // consumer task
+    uint32_t length;
+    uint8_t *frame = g_Frames.Receive(length);
+    ProcessFrame(frame, length);
+    g_Frames.Release(frame);
+    \endcode
+*/
+template <uint32_t _BufferSize, uint32_t _Count>
+class LoanChannel
+{
+public:
+    enum EConsts
+    {
+        BUFFER_SIZE  = _BufferSize, //!< size of the buffer (bytes)
+        BUFFER_COUNT = _Count,      //!< number of buffers in the pool
+        BUFFER_WORDS = (_BufferSize + sizeof(size_t) - 1) / sizeof(size_t) //!< aligned size of the buffer (words)
+    };
+
+    explicit LoanChannel() : m_free_sem(_Count, _Count), m_sent_sem(0, _Count), m_free_count(_Count), m_sent_head(0),
+        m_sent_count(0), m_in_flight_max(0), m_sent_total(0)
+    {
+        for (uint32_t i = 0; i < _Count; ++i)
+            m_free[i] = i;
+    }
+
+    /*! \brief     Take buffer from the pool (producer side).
+        \param[in] timeout_ms: Timeout (milliseconds) to wait for a released buffer if pool is exhausted,
+                   WAIT_INFINITE to wait without a timeout, 0 to not wait.
+        \return    Buffer of GetBufferSize bytes, or NULL if timeout expired.
+    */
+    uint8_t *Acquire(uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        if (!m_free_sem.Wait(timeout_ms))
+            return NULL;
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        // semaphore count guarantees a free buffer
+        STK_ASSERT(m_free_count != 0);
+        uint32_t index = m_free[--m_free_count];
+
+        uint32_t in_flight = _Count - m_free_count;
+        if (in_flight > m_in_flight_max)
+            m_in_flight_max = in_flight;
+
+        service->ExitCriticalSection();
+
+        return GetBuffer(index);
+    }
+
+    /*! \brief     Send buffer to the consumer (producer side), ownership of the buffer passes to the consumer.
+        \param[in] buffer: Buffer taken with Acquire.
+        \param[in] length: Length of the payload (bytes), must not exceed GetBufferSize.
+    */
+    void Send(uint8_t *buffer, uint32_t length)
+    {
+        STK_ASSERT(length <= _BufferSize);
+
+        uint32_t index = GetIndex(buffer);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        // number of buffers is limited by the pool, queue of sent buffers can't overflow
+        STK_ASSERT(m_sent_count < _Count);
+
+        Sent &sent = m_sent[(m_sent_head + m_sent_count) % _Count];
+        sent.index  = index;
+        sent.length = length;
+
+        ++m_sent_count;
+        ++m_sent_total;
+
+        service->ExitCriticalSection();
+
+        m_sent_sem.Signal();
+    }
+
+    /*! \brief     Receive buffer (consumer side), ownership of the buffer passes to the consumer which must return
+                   it to the pool with Release.
+        \param[out] length: Length of the payload (bytes).
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout, 0 to not wait.
+        \return    Buffer, or NULL if timeout expired.
+    */
+    uint8_t *Receive(uint32_t &length, uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        if (!m_sent_sem.Wait(timeout_ms))
+            return NULL;
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        STK_ASSERT(m_sent_count != 0);
+        Sent sent = m_sent[m_sent_head];
+
+        m_sent_head = (m_sent_head + 1) % _Count;
+        --m_sent_count;
+
+        service->ExitCriticalSection();
+
+        length = sent.length;
+        return GetBuffer(sent.index);
+    }
+
+    /*! \brief     Return buffer to the pool and wake up the producer waiting for a buffer.
+        \param[in] buffer: Buffer taken with Acquire or Receive.
+    */
+    void Release(uint8_t *buffer)
+    {
+        uint32_t index = GetIndex(buffer);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        // if hit here: buffer is released twice
+        STK_ASSERT(m_free_count < _Count);
+        m_free[m_free_count++] = index;
+
+        service->ExitCriticalSection();
+
+        m_free_sem.Signal();
+    }
+
+    /*! \brief     Get size of the buffer (bytes).
+    */
+    uint32_t GetBufferSize() const { return _BufferSize; }
+
+    /*! \brief     Get number of buffers in flight (taken from the pool and not released yet).
+    */
+    uint32_t GetInFlight() const { return _Count - m_free_count; }
+
+    /*! \brief     Get maximum number of buffers which were in flight at once (pool sizing hint).
+    */
+    uint32_t GetInFlightMax() const { return m_in_flight_max; }
+
+    /*! \brief     Get number of buffers which are sent and not received yet.
+    */
+    uint32_t GetPending() const { return m_sent_count; }
+
+    /*! \brief     Get total number of sent buffers.
+    */
+    uint32_t GetSentTotal() const { return m_sent_total; }
+
+private:
+    /*! \class Sent
+        \brief Sent buffer.
+    */
+    struct Sent
+    {
+        uint32_t index;  //!< index of the buffer
+        uint32_t length; //!< length of the payload
+    };
+
+    __stk_forceinline uint8_t *GetBuffer(uint32_t index) { return (uint8_t *)m_memory[index]; }
+
+    uint32_t GetIndex(const uint8_t *buffer) const
+    {
+        // if hit here: buffer does not belong to this channel
+        STK_ASSERT(buffer >= (const uint8_t *)m_memory);
+
+        size_t offset = (size_t)(buffer - (const uint8_t *)m_memory);
+        STK_ASSERT((offset % sizeof(m_memory[0])) == 0);
+        STK_ASSERT((offset / sizeof(m_memory[0])) < _Count);
+
+        return (uint32_t)(offset / sizeof(m_memory[0]));
+    }
+
+    size_t            m_memory[_Count][BUFFER_WORDS]; //!< memory of the buffers
+    Semaphore         m_free_sem;                     //!< count of the free buffers (producer waits on it)
+    Semaphore         m_sent_sem;                     //!< count of the sent buffers (consumer waits on it)
+    uint32_t          m_free[_Count];                 //!< indexes of the free buffers (stack)
+    volatile uint32_t m_free_count;                   //!< number of the free buffers
+    Sent              m_sent[_Count];                 //!< ring buffer of the sent buffers
+    uint32_t          m_sent_head;                    //!< index of the oldest sent buffer
+    volatile uint32_t m_sent_count;                   //!< number of the sent buffers
+    uint32_t          m_in_flight_max;                //!< maximum number of buffers in flight
+    uint32_t          m_sent_total;                   //!< total number of sent buffers
+
+    // If hit here: buffer size and number of buffers must not be 0.
+    STK_STATIC_ASSERT_N(LOAN_CHANNEL_CONFIG, (_BufferSize != 0) && (_Count != 0));
+};
+
+} // namespace stk
+
+#endif /* STK_CHANNEL_H_ */
@@ -41,6 +41,7 @@ enum EKernelMode
     KERNEL_STATIC  = (1 << 0), //!< All tasks are static and can not exit.
     KERNEL_DYNAMIC = (1 << 1), //!< Tasks can be added or removed and therefore exit when done.
     KERNEL_HRT     = (1 << 2), //!< Hard Real-Time (HRT) behavior (tasks are scheduled periodically and have an execution deadline, whole system is failed when task's deadline is failed).
+    KERNEL_MIXED   = (1 << 3), //!< Mixed-criticality behavior, accompanies stk::KERNEL_HRT (soft tasks added with IKernel::AddTask(ITask *) run in the slack time between the jobs of the HRT tasks).
 };
 
 /*! \enum  EStackType
@@ -49,9 +50,33 @@ enum EKernelMode
 */
 enum EStackType
 {
-    STACK_USER_TASK = 0, //!< Stack of the user task.
-    STACK_SLEEP_TRAP,    //!< Stack of the Sleep trap.
-    STACK_EXIT_TRAP      //!< Stack of the Exit trap.
+    STACK_USER_TASK = 0,    //!< Stack of the user task.
+    STACK_SLEEP_TRAP,       //!< Stack of the Sleep trap.
+    STACK_EXIT_TRAP,        //!< Stack of the Exit trap.
+    STACK_USER_TASK_RESTART //!< Stack of the user task restarted in the same stack memory: only initial frame is rebuilt.
+};
+
+/*! \enum  EDeadlineMissPolicy
+    \brief Reaction of the kernel to the missed deadline of the HRT task's job.
+    \see   ITask::GetDeadlineMissPolicy
+*/
+enum EDeadlineMissPolicy
+{
+    DEADLINE_MISS_HARD_FAULT = 0, //!< Whole system is failed (IPlatform::ProcessHardFault is called).
+    DEADLINE_MISS_SKIP_NEXT,      //!< Late job continues until completed, next job of the task is skipped.
+    DEADLINE_MISS_RESTART,        //!< Late job is aborted, task is restarted from its entry function at its next period.
+    DEADLINE_MISS_DEMOTE          //!< Task loses its HRT guarantee and continues as a soft task in the slack time of the HRT tasks.
+};
+
+/*! \enum  ESchedPolicy
+    \brief Scheduling policy of the task switching strategy, selects schedulability analysis of the HRT tasks.
+    \see   SchedAnalysis
+*/
+enum ESchedPolicy
+{
+    SCHED_POLICY_NONE = 0,       //!< Policy is unknown to the analysis (only total utilization of the task set is checked).
+    SCHED_POLICY_ROUND_ROBIN,    //!< Ready tasks share CPU in turns with a time slice of 1 tick.
+    SCHED_POLICY_RATE_MONOTONIC  //!< Preemptive fixed priority, task with a shorter periodicity has a higher priority.
 };
 
 /*! \enum  EConsts
@@ -64,6 +89,14 @@ enum EConsts
     STACK_SIZE_MIN       = STK_STACK_SIZE_MIN //!< Stack memory size of the Exit trap (see: StackMemoryDef, StackMemoryWrapper).
 };
 
+/*! \brief Infinite timeout of the wait (see IKernelService::Wait).
+*/
+const uint32_t WAIT_INFINITE = 0xFFFFFFFF;
+
+/*! \brief Infinite deadline of the wait (see IKernelService::WaitUntil).
+*/
+const int64_t WAIT_DEADLINE_INFINITE = INT64_MAX;
+
 /*! \class StackMemoryDef
     \brief Stack memory type definition.
     \note  This descriptor provides an encapsulated type only on basis of which you can declare
@@ -201,10 +234,26 @@ public:
     virtual EAccessMode GetAccessMode() const = 0;
 
     /*! \brief     Called by the scheduler if deadline of the task is missed when Kernel is operating in Hard Real-Time mode (see stk::KERNEL_HRT).
-        \param[in] duration: Actual duration value which will always be larger than a deadline value which was missed.
+        \param[in] duration: Actual duration value which will always be larger than a deadline value which was missed,
+                   or duration of the time window if job overran it (see ITaskSwitchStrategy::WINDOWED).
         \note      Optional handler. Use it for logging of the faulty task.
+        \note      Called from the system tick handler as soon as deadline is exceeded by the running job, or when job
+                   is switched out if it completed later than deadline or did not complete within its time window.
     */
     virtual void OnDeadlineMissed(uint32_t duration) = 0;
+
+    /*! \brief     Get reaction of the kernel to the missed deadline of the task's job (see stk::EDeadlineMissPolicy).
+        \note      Queried after ITask::OnDeadlineMissed, therefore policy can be escalated depending on the
+                   number of misses.
+        \note      Optional, missed deadline is a hard fault by default (see stk::DEADLINE_MISS_HARD_FAULT).
+    */
+    virtual EDeadlineMissPolicy GetDeadlineMissPolicy() const { return DEADLINE_MISS_HARD_FAULT; }
+
+    /*! \brief     Get weight (number of tickets) of the task for the proportional-share scheduling.
+        \note      Used by the proportional-share strategies only (see SwitchStrategyStride), must not be 0.
+        \note      Optional, all tasks have equal weight by default.
+    */
+    virtual uint32_t GetWeight() const { return 1; }
 };
 
 /*! \class IKernelTask
@@ -232,6 +281,25 @@ public:
     /*! \brief     Get pointer to the user task's stack.
     */
     virtual Stack *GetUserStack() = 0;
+
+    /*! \brief     Check if task is sleeping (not ready to be scheduled).
+    */
+    virtual bool IsSleeping() const = 0;
+
+    /*! \brief     Get periodicity of the HRT task (ticks), or 0 if task is not HRT.
+    */
+    virtual uint32_t GetHrtPeriodicity() const = 0;
+
+    /*! \brief     Get worst-case execution time hint of the HRT task (ticks), or 0 if not provided (see IKernel::AddTask).
+    */
+    virtual uint32_t GetHrtWcet() const = 0;
+
+    /*! \brief     Get index of the task's slot in the kernel task storage.
+        \note      Index is stable while task is added to the kernel and is lower than the number of tasks in the
+                   kernel at the moment of addition (free slot with the lowest index is used), therefore strategies
+                   can keep per-task data in tables indexed by it instead of searching for the task.
+    */
+    virtual uint32_t GetIndex() const = 0;
 };
 
 /*! \class IPlatform
@@ -284,6 +352,16 @@ public:
             \param[out] stack: Stack of the exited task.
         */
         virtual void OnTaskExit(Stack *stack) = 0;
+
+        /*! \brief      Called from the Thread process within a critical section to switch to a next task without
+                        waiting for the next system tick (e.g. after OnTaskExit), time does not advance.
+            \note       Switch is not made if it requires exit from scheduling or in stk::KERNEL_HRT mode, such
+                        switch is made on the next system tick.
+            \param[out] idle: Stack of the task which must enter Idle state.
+            \param[out] active: Stack of the task which must enter Active state (to which context will switch).
+            \return     True if context must be switched.
+        */
+        virtual bool OnReschedule(Stack **idle, Stack **active) = 0;
     };
 
     /*! \class IEventOverrider
@@ -347,6 +425,13 @@ public:
     */
     virtual void SleepTicks(uint32_t ticks) = 0;
 
+    /*! \brief     Switch to a next task from the Thread process without waiting for the next system tick if it is
+                   allowed by the event handler (see IEventHandler::OnReschedule), otherwise switch is made on the
+                   next system tick.
+        \note      Called by the Kernel within a critical section (e.g. directed switch, see IKernelService::Handoff).
+    */
+    virtual void Reschedule() = 0;
+
     /*! \brief     Process one tick.
         \note      Normally system tick is processed by the platform driver implementation.
                    In case system tick handler is used by the application and should not be implemented
@@ -374,6 +459,16 @@ public:
         \return    Current value of the Stack Pointer (SP) of the calling process.
     */
     virtual size_t GetCallerSP() = 0;
+
+    /*! \brief     Enter critical section: disable interrupts which can access the shared data.
+        \note      Can be nested, interrupts are restored to the initial state when the outermost critical section exits.
+        \note      Can be called from a task and from an ISR.
+    */
+    virtual void EnterCriticalSection() = 0;
+
+    /*! \brief     Exit critical section entered with EnterCriticalSection.
+    */
+    virtual void ExitCriticalSection() = 0;
 };
 
 /*! \class ITaskSwitchStrategy
@@ -381,12 +476,24 @@ public:
     \note  Strategy and Iterator design patterns.
 
     Inherit this interface by your concrete implementation of the task switching strategy.
+
+    \note  Concrete implementation can redeclare SCHED_POLICY to let Kernel apply schedulability analysis
+           matching its scheduling policy when HRT task is added with a WCET hint (see IKernel::AddTask).
 */
 class ITaskSwitchStrategy
 {
 public:
+    enum EConfig
+    {
+        SCHED_POLICY = SCHED_POLICY_NONE, //!< scheduling policy (see stk::ESchedPolicy)
+        PREEMPTIVE   = 0,                 //!< 1 if preempted HRT job is resumed later, 0 if switching out completes the job
+        WINDOWED     = 0                  //!< 1 if HRT job owns fixed time window, then job switched out before it
+                                          //!< completed is reported as missed deadline (window overrun)
+    };
+
     /*! \brief     Add task.
         \note      Kernel tasks are added by the concrete implementation of IKernel.
+        \note      Task can be added sleeping (see IKernelTask::IsSleeping), e.g. HRT task with a start delay.
         \param[in] task: Pointer to the task to add.
     */
     virtual void AddTask(IKernelTask *task) = 0;
@@ -404,13 +511,35 @@ public:
     /*! \brief     Get next linked task.
         \param[in] current: Pointer to the current task.
         \return    Pointer to the next task.
-        \note      Some implementations may return NULL that denotes the end of the iteration.
+        \note      Some implementations may return NULL that denotes the end of the iteration, Kernel
+                   then treats it as the absence of the task to schedule (all tasks are sleeping).
     */
     virtual IKernelTask *GetNext(IKernelTask *current) = 0;
 
     /*! \brief     Get number of tasks.
     */
     virtual size_t GetSize() const = 0;
+
+    /*! \brief     Called by the kernel on every system tick before the next task is fetched.
+        \note      Time-driven implementations can use it to track time without querying IKernelService.
+        \param[in] ticks: Number of ticks elapsed since the start of the kernel.
+    */
+    virtual void OnTick(int64_t ticks) = 0;
+
+    /*! \brief     Called by the kernel when task went to sleep (sleeps, waits, is suspended or its HRT job is
+                   completed), task stays in the strategy.
+        \note      Implementations which track ready tasks (e.g. with a bitmap) use it together with OnTaskWake
+                   instead of checking every task for IKernelTask::IsSleeping when next task is fetched.
+        \note      Called within a critical section or from the system tick, notification is sent once per state
+                   change but may be delayed until the next tick (e.g. when HRT job is switched out).
+        \param[in] task: Pointer to the task.
+    */
+    virtual void OnTaskSleep(IKernelTask *task) = 0;
+
+    /*! \brief     Called by the kernel when sleeping task woke up (see OnTaskSleep).
+        \param[in] task: Pointer to the task.
+    */
+    virtual void OnTaskWake(IKernelTask *task) = 0;
 };
 
 /*! \class IKernel
@@ -425,7 +554,8 @@ public:
     virtual void Initialize() = 0;
 
     /*! \brief     Add user task.
-        \note      This function is for Soft Real-time modes only, e.g. stk::KERNEL_HRT is not used as parameter.
+        \note      This function is for Soft Real-time modes only, e.g. stk::KERNEL_HRT is not used as parameter,
+                   or for the soft tasks if stk::KERNEL_MIXED accompanies stk::KERNEL_HRT.
         \param[in] user_task: Pointer to the user task to add.
     */
     virtual void AddTask(ITask *user_task) = 0;
@@ -436,14 +566,97 @@ public:
         \param[in] periodicity_tc: Periodicity time at which task is scheduled (ticks).
         \param[in] deadline_tc: Deadline time within which a task must complete its work (ticks).
         \param[in] start_delay_tc: Initial start delay for the task (ticks).
+        \param[in] wcet_tc: Worst-case execution time of the task's job (ticks), optional hint. If provided, task
+                            is admitted only if HRT tasks with the WCET hint stay schedulable under the scheduling
+                            policy of the task switching strategy (see SchedAnalysis), otherwise it is rejected.
+                            Deadline must not exceed periodicity if hint is provided.
+        \note      Rejected task is not added and assertion is raised, use TryAddTask if rejection is expected
+                   (e.g. in release builds where assertions are inactive).
     */
-    virtual void AddTask(ITask *user_task, uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc) = 0;
+    virtual void AddTask(ITask *user_task, uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc,
+        uint32_t wcet_tc = 0) = 0;
+
+    /*! \brief     Add user task if it passes admission control (see AddTask).
+        \note      This function is for Hard Real-time mode only, e.g. stk::KERNEL_HRT is used as parameter.
+        \param[in] user_task: Pointer to the user task to add.
+        \param[in] periodicity_tc: Periodicity time at which task is scheduled (ticks).
+        \param[in] deadline_tc: Deadline time within which a task must complete its work (ticks).
+        \param[in] start_delay_tc: Initial start delay for the task (ticks).
+        \param[in] wcet_tc: Worst-case execution time of the task's job (ticks), must not be 0.
+        \return    True if task is added, false if it is rejected because HRT tasks would become unschedulable.
+    */
+    virtual bool TryAddTask(ITask *user_task, uint32_t periodicity_tc, uint32_t deadline_tc, uint32_t start_delay_tc,
+        uint32_t wcet_tc) = 0;
 
     /*! \brief     Remove user task.
         \param[in] user_task: Pointer to the user task to remove.
     */
     virtual void RemoveTask(ITask *user_task) = 0;
 
+    /*! \brief     Reserve CPU budget for the soft task (Constant Bandwidth Server).
+        \note      Task can run for budget_tc ticks within every period_tc ticks, it is throttled when budget is
+                   exhausted until budget is replenished at the next period. Interference of the task with other
+                   tasks is therefore bounded by budget_tc / period_tc of CPU time regardless of its workload.
+        \note      This function is for the soft tasks only, e.g. stk::KERNEL_HRT is not used as parameter, or for
+                   the soft tasks if stk::KERNEL_MIXED accompanies stk::KERNEL_HRT. Must be called before IKernel::Start.
+        \param[in] user_task: Pointer to the added user task.
+        \param[in] budget_tc: CPU budget within the period (ticks), 0 to remove reservation.
+        \param[in] period_tc: Replenishment period (ticks).
+    */
+    virtual void SetTaskBudget(ITask *user_task, uint32_t budget_tc, uint32_t period_tc) = 0;
+
+    /*! \brief     Suspend user task: task is taken off the scheduling (task switching strategy) and is not scheduled
+                   until resumed with Resume.
+        \note      Can be called from a task (including the task itself) and from an ISR while kernel is running.
+                   Running task is taken off the scheduling when it is switched out, the task which suspends itself
+                   does not return from the call until resumed.
+        \note      This function is for the soft tasks only.
+        \param[in] user_task: Pointer to the added user task.
+    */
+    virtual void Suspend(ITask *user_task) = 0;
+
+    /*! \brief     Resume user task suspended with Suspend.
+        \note      Can be called from a task and from an ISR while kernel is running.
+        \param[in] user_task: Pointer to the suspended user task.
+    */
+    virtual void Resume(ITask *user_task) = 0;
+
+    /*! \brief     Remove user task while kernel is running: task is taken off the scheduling and its slot is released.
+        \note      Can be called from a task (including the task itself) and from an ISR, running task is removed
+                   when it is switched out, the task which kills itself does not return from the call.
+        \note      Killed task does not unwind its stack, therefore it must not own resources. Its wait on Semaphore,
+                   Event (WaitAny), in IpcEndpoint::Call and in Join is cancelled by the Kernel (see
+                   IWaitRegistration), it must not wait on the objects which reference it otherwise (e.g. Future).
+        \note      This function is for stk::KERNEL_DYNAMIC mode only.
+        \param[in] user_task: Pointer to the added user task.
+    */
+    virtual void Kill(ITask *user_task) = 0;
+
+    /*! \brief     Wait until user task exits (its Run function returns or it is killed) and Kernel releases its slot.
+        \note      Caller task is not scheduled while waiting (see IKernelService::Wait), one task can join the task.
+        \note      This function is for stk::KERNEL_DYNAMIC mode only.
+        \param[in] user_task: Pointer to the added user task, if task already exited the call returns immediately.
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout.
+        \param[out] exit_code: Exit code of the task (see IKernelService::SetExitCode), unchanged if task already
+                    exited, can be NULL.
+        \return    True if task exited, false if timeout expired.
+    */
+    virtual bool Join(ITask *user_task, uint32_t timeout_ms = WAIT_INFINITE, int32_t *exit_code = NULL) = 0;
+
+    /*! \brief     Restart user task from its entry function in the same slot and stack memory: only initial frame of
+                   the stack is rebuilt and task is ready to be scheduled immediately (sleep, wait, suspension and
+                   pending exit of the task are cancelled).
+        \note      Can be called from a task and from an ISR while kernel is running, running task can't be
+                   restarted (task which must start anew can return from its Run function instead).
+        \note      Restarted task does not unwind its stack, therefore it must not own resources, its wait is
+                   cancelled as for the killed task (see Kill).
+        \note      This function is for the soft tasks only.
+        \param[in] user_task: Pointer to the added user task.
+        \return    True if task is restarted, false if task exited and its slot is released already (task must be
+                   added again with AddTask).
+    */
+    virtual bool Restart(ITask *user_task) = 0;
+
     /*! \brief     Start kernel.
         \param[in] resolution_us: Resolution of the system tick (SysTick) timer in microseconds, (see IPlatform::GetSysTickResolution).
         \note      If running on STM32 device with HAL driver or on QEMU do not change the default resolution (PERIODICITY_DEFAULT).
@@ -477,6 +690,21 @@ public:
 #endif
 };
 
+/*! \class IWaitRegistration
+    \brief Registration of the waiting task which is located on the stack of the task and is referenced by the
+           object the task waits on (e.g. WaitLink of Semaphore, call of IpcEndpoint).
+    \note  Kernel cancels active registration of the task which is killed or restarted (see IKernel::Kill,
+           IKernel::Restart), therefore object never references stack memory of the removed task.
+*/
+class IWaitRegistration
+{
+public:
+    /*! \brief     Unlink registration from the object.
+        \note      Called by Kernel within a critical section, the waiting task is not running.
+    */
+    virtual void CancelWait() = 0;
+};
+
 /*! \class IKernelService
     \brief Interface for the kernel services exposed to the user processes during
            run-time when Kernel started scheduling the processes.
@@ -504,13 +732,98 @@ public:
     /*! \brief     Put calling process into a sleep state.
         \note      Unlike Delay this function does not waste CPU cycles and allows kernel to put CPU into a low-power state.
         \note      Unsupported in HRT mode (see stk::KERNEL_HRT), instead task will sleep automatically according its periodicity and workload.
+                   The soft tasks of the stk::KERNEL_MIXED mode are an exception and can sleep.
         \param[in] sleep_ms: Sleep time (milliseconds).
     */
     virtual void Sleep(uint32_t sleep_ms) = 0;
 
+    /*! \brief     Put calling process into a sleep state until the absolute tick (see GetTicks).
+        \note      Unlike Sleep the wake-up time does not depend on the time of the call, therefore periodic loop which
+                   advances the wake-up tick by its period does not drift by its execution time (see PeriodicTimer).
+        \note      Unsupported for HRT tasks (see stk::KERNEL_HRT), soft tasks of the stk::KERNEL_MIXED mode can sleep.
+        \param[in] ticks: Tick to wake up at, call returns immediately if this tick is reached already.
+    */
+    virtual void SleepUntil(int64_t ticks) = 0;
+
     /*! \brief     Notify scheduler that it can switch to a next task.
     */
     virtual void SwitchToNext() = 0;
+
+    /*! \brief     Put calling task into a waiting state until it is notified with Notify or timeout expires.
+        \note      Waiting task is not scheduled. If notification is already pending, it is consumed and call
+                   returns immediately, therefore notification sent before the wait is not lost.
+        \note      Unsupported for HRT tasks (see stk::KERNEL_HRT), soft tasks of the stk::KERNEL_MIXED mode can wait.
+        \param[in] timeout_ms: Timeout (milliseconds), or WAIT_INFINITE.
+        \return    True if notified, false if timeout expired.
+    */
+    virtual bool Wait(uint32_t timeout_ms) = 0;
+
+    /*! \brief     Put calling task into a waiting state until it is notified with Notify or the absolute tick (see
+                   GetTicks) is reached.
+        \note      Unlike Wait the deadline does not depend on the time of the call, therefore the loop which waits
+                   again after a stale notification keeps its timeout exactly, without conversion to milliseconds.
+        \note      Unsupported for HRT tasks (see stk::KERNEL_HRT), soft tasks of the stk::KERNEL_MIXED mode can wait.
+        \param[in] ticks: Tick to stop waiting at, or WAIT_DEADLINE_INFINITE. If this tick is reached already, pending
+                   notification is consumed without waiting.
+        \return    True if notified, false if deadline is reached.
+    */
+    virtual bool WaitUntil(int64_t ticks) = 0;
+
+    /*! \brief     Notify task: wake it up if it is waiting in Wait, otherwise keep notification pending.
+        \note      Can be called from a task and from an ISR.
+        \param[in] user_task: User task to notify.
+    */
+    virtual void Notify(ITask *user_task) = 0;
+
+    /*! \brief     Hand CPU over to the task: on the next scheduling point Kernel switches to this task directly,
+                   bypassing the selection of the task switching strategy (directed switch). If the caller waits
+                   (see Wait) next scheduling point is made right away, without waiting for the next tick, on the
+                   platforms which support it (see IPlatform::Reschedule).
+        \note      Hint is ignored if task is not ready to run at the scheduling point, and in stk::KERNEL_HRT mode.
+        \note      Normally used together with Notify and Wait to pass the rest of the time slice to the task which
+                   serves the caller (see IpcEndpoint).
+        \param[in] user_task: User task to switch to.
+    */
+    virtual void Handoff(ITask *user_task) = 0;
+
+    /*! \brief     Start grace period: it completes when every task, except the caller, has given CPU up voluntarily
+                   (Sleep, Wait, SwitchToNext) at least once or was sleeping/waiting when it started (see RcuPointer).
+        \note      Preemption of the task is not a quiescent state, therefore task which never gives CPU up holds
+                   the grace period.
+        \return    Sequence number of the grace period (see IsGracePeriodCompleted).
+    */
+    virtual uint32_t StartGracePeriod() = 0;
+
+    /*! \brief     Check if grace period is completed.
+        \param[in] gp: Sequence number of the grace period returned by StartGracePeriod.
+    */
+    virtual bool IsGracePeriodCompleted(uint32_t gp) const = 0;
+
+    /*! \brief     Set exit code of the calling task which is passed to the task joining it (see IKernel::Join).
+        \param[in] exit_code: Exit code, 0 by default.
+    */
+    virtual void SetExitCode(int32_t exit_code) = 0;
+
+    /*! \brief     Set active wait registration of the calling task (see IWaitRegistration).
+        \note      Must be called within the critical section in which registration is linked to the object, and
+                   with NULL after it is unlinked (or is not referenced by the object anymore).
+        \param[in] reg: Registration, or NULL if task is not registered anymore.
+    */
+    virtual void SetWaitRegistration(IWaitRegistration *reg) = 0;
+
+    /*! \brief     Get user task of the calling process.
+        \return    User task, or NULL if called not from a task.
+    */
+    virtual ITask *GetCurrentTask() = 0;
+
+    /*! \brief     Enter critical section (see IPlatform::EnterCriticalSection).
+        \note      Can be called from a task and from an ISR, can be nested.
+    */
+    virtual void EnterCriticalSection() = 0;
+
+    /*! \brief     Exit critical section (see IPlatform::ExitCriticalSection).
+    */
+    virtual void ExitCriticalSection() = 0;
 };
 
 } // namespace stk
@@ -0,0 +1,180 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_DEFERRED_H_
+#define STK_DEFERRED_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_deferred.h
+    \brief Contains deferred call queue (bottom-half processing of the interrupts).
+*/
+
+namespace stk {
+
+/*! \typedef DeferredFuncType
+    \brief   Deferred call prototype (see DeferredQueue::Post).
+*/
+typedef void (*DeferredFuncType) (void *arg);
+
+/*! \class DeferredQueue
+    \brief Deferred call queue: ISR posts a function with an argument and the worker task calls it later
+           (bottom-half processing), therefore ISR does the minimal work and returns.
+
+    Calls are kept in a ring buffer of _Capacity entries and are executed in the order of posting. Post is O(1) and
+    masks interrupts only for a few instructions (see IKernelService::EnterCriticalSection) to reserve the entry,
+    it does not allocate memory and never blocks, it fails if queue is full.
+
+    DeferredQueue is a worker task which must be added to the Kernel (soft real-time mode), it waits for a
+    notification (see IKernelService::Wait) while queue is empty and is not scheduled until a call is posted.
+    Use a strategy which prioritizes the worker to shorten the latency of the deferred calls.
+
+    Usage example:
+    \code
+    static stk::DeferredQueue<16> g_Deferred;
+
+    static void OnUartRx(void *arg) { // process received data here ... }
+
+    extern "C" void USART1_IRQHandler()
+    {
+        g_Deferred.Post(&OnUartRx, (void *)USART1->DR);
+    }
+
+    kernel.AddTask(&g_Deferred);
+    \endcode
+*/
+template <uint32_t _Capacity = 16, uint32_t _StackSize = 256>
+class DeferredQueue : public Task<_StackSize, ACCESS_PRIVILEGED>
+{
+public:
+    enum EConsts
+    {
+        CAPACITY = _Capacity //!< maximum number of pending calls
+    };
+
+    explicit DeferredQueue() : m_head(0), m_size(0), m_dropped(0), m_waiting(false) {}
+
+    RunFuncType GetFunc() { return &Run; }
+    void *GetFuncUserData() { return this; }
+
+    /*! \brief     Post deferred call.
+        \note      Can be called from an ISR and from a task.
+        \param[in] func: Function to call.
+        \param[in] arg: Argument of the function.
+        \return    True if posted, false if queue is full (see GetDroppedCount).
+    */
+    bool Post(DeferredFuncType func, void *arg)
+    {
+        STK_ASSERT(func != NULL);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        if (m_size == CAPACITY)
+        {
+            ++m_dropped;
+            service->ExitCriticalSection();
+            return false;
+        }
+
+        Call &call = m_calls[(m_head + m_size) % CAPACITY];
+        call.func = func;
+        call.arg  = arg;
+
+        // wake the worker up on a transition from empty, otherwise it is still draining the queue
+        bool wake = (m_size++ == 0) && m_waiting;
+
+        service->ExitCriticalSection();
+
+        if (wake)
+            service->Notify(this);
+
+        return true;
+    }
+
+    /*! \brief     Execute all pending calls.
+        \note      Called by the worker task, can be called by the user if DeferredQueue is not added to the Kernel.
+        \return    Number of executed calls.
+    */
+    uint32_t Process()
+    {
+        IKernelService *service = GetKernelService();
+        uint32_t count = 0;
+
+        for (;;)
+        {
+            service->EnterCriticalSection();
+
+            if (m_size == 0)
+            {
+                service->ExitCriticalSection();
+                break;
+            }
+
+            Call call = m_calls[m_head];
+            m_head = (m_head + 1) % CAPACITY;
+            --m_size;
+
+            service->ExitCriticalSection();
+
+            call.func(call.arg);
+            ++count;
+        }
+
+        return count;
+    }
+
+    /*! \brief     Get number of pending calls.
+    */
+    uint32_t GetSize() const { return m_size; }
+
+    /*! \brief     Get number of calls which were not posted because queue was full.
+    */
+    uint32_t GetDroppedCount() const { return m_dropped; }
+
+private:
+    /*! \class Call
+        \brief Deferred call.
+    */
+    struct Call
+    {
+        DeferredFuncType func; //!< function
+        void            *arg;  //!< argument
+    };
+
+    static void Run(void *user_data)
+    {
+        DeferredQueue *queue = static_cast<DeferredQueue *>(user_data);
+        IKernelService *service = GetKernelService();
+
+        // calls posted from now on notify the worker
+        queue->m_waiting = true;
+
+        for (;;)
+        {
+            queue->Process();
+
+            // call posted after Process found the queue empty leaves a pending notification
+            service->Wait(WAIT_INFINITE);
+        }
+    }
+
+    Call              m_calls[CAPACITY]; //!< ring buffer of the pending calls
+    uint32_t          m_head;            //!< index of the oldest pending call
+    volatile uint32_t m_size;            //!< number of pending calls
+    uint32_t          m_dropped;         //!< number of calls dropped due to the overflow
+    volatile bool     m_waiting;         //!< true if worker task is running and can be notified
+
+    // If hit here: capacity must not be 0.
+    STK_STATIC_ASSERT_N(DEFERRED_CAPACITY, _Capacity != 0);
+};
+
+} // namespace stk
+
+#endif /* STK_DEFERRED_H_ */
@@ -193,6 +193,26 @@ static __stk_forceinline _To forced_cast(const _From &from)
     return cast.to;
 }
 
+/*! \fn    GetLowestBit
+    \brief Get index of the lowest set bit (count trailing zeros), bitmap of the priorities is resolved with a single
+           instruction on the CPUs which support it.
+    \note  Bits must not be 0.
+*/
+static __stk_forceinline uint32_t GetLowestBit(uint32_t bits)
+{
+#ifdef __GNUC__
+    return (uint32_t)__builtin_ctz(bits);
+#else
+    uint32_t index = 0;
+    while ((bits & 1) == 0)
+    {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
 } // namespace stk
 
 #endif /* STK_DEFS_H_ */
@@ -0,0 +1,291 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_FUTURE_H_
+#define STK_FUTURE_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_future.h
+    \brief Contains Promise/Future pair for the asynchronous completions (e.g. by the drivers from an ISR).
+*/
+
+namespace stk {
+
+template <typename _Ty> class Promise;
+
+/*! \class Continuation
+    \brief Continuation which is called when value of the Promise is set (see Future::Then).
+
+    Inherit this class and implement OnReady. Continuation is called in the context of the completer (e.g. ISR)
+    and must be short, it can complete another Promise to chain the asynchronous operations or post a call to the
+    DeferredQueue.
+
+    \note  Continuation is owned by the caller and must stay valid until it is called.
+*/
+template <typename _Ty>
+class Continuation
+{
+    friend class Promise<_Ty>;
+
+public:
+    explicit Continuation() : m_next(NULL) {}
+
+    /*! \brief     Called when value is set.
+        \param[in] value: Value of the Promise.
+    */
+    virtual void OnReady(const _Ty &value) = 0;
+
+protected:
+    /*! \brief     Destructor.
+        \note      Non-virtual to avoid dependency on stdc++, continuation is not deleted through the base class.
+    */
+    ~Continuation() {}
+
+private:
+    Continuation *m_next; //!< next continuation of the same Promise
+};
+
+/*! \class Future
+    \brief Read side of the Promise: waits for the value (see Get) or attaches continuations (see Then).
+
+    Future is a lightweight handle which can be copied, the value is stored in the Promise.
+*/
+template <typename _Ty>
+class Future
+{
+    friend class Promise<_Ty>;
+
+public:
+    explicit Future() : m_promise(NULL) {}
+
+    /*! \brief     Wait for the value.
+        \note      Caller task is not scheduled while waiting (see IKernelService::Wait).
+        \param[out] value: Value of the Promise.
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout.
+        \return    True if value is set, false if timeout expired.
+    */
+    bool Get(_Ty &value, uint32_t timeout_ms = WAIT_INFINITE) const
+    {
+        STK_ASSERT(m_promise != NULL);
+        return m_promise->Get(value, timeout_ms);
+    }
+
+    /*! \brief     Check if value is set.
+    */
+    bool IsReady() const
+    {
+        STK_ASSERT(m_promise != NULL);
+        return m_promise->IsReady();
+    }
+
+    /*! \brief     Attach continuation which is called when value is set, continuation is called immediately
+                   from the context of the caller if value is set already.
+        \param[in] cont: Continuation.
+    */
+    void Then(Continuation<_Ty> *cont) const
+    {
+        STK_ASSERT(m_promise != NULL);
+        m_promise->Then(cont);
+    }
+
+    /*! \brief     Check if Future is attached to a Promise.
+    */
+    bool IsValid() const { return (m_promise != NULL); }
+
+private:
+    explicit Future(Promise<_Ty> *promise) : m_promise(promise) {}
+
+    Promise<_Ty> *m_promise; //!< promise
+};
+
+/*! \class Promise
+    \brief Write side of the asynchronous result: completer (e.g. ISR of the driver) sets the value once (see Set),
+           tasks wait for it with the Future (see GetFuture) without polling a completion flag.
+
+    Promise is owned by the caller and holds the value, it does not allocate memory. One task can wait for the value
+    at a time, any number of continuations can be attached.
+
+    \note  Set is protected with a critical section (see IKernelService::EnterCriticalSection) and can be called
+           from an ISR.
+
+    Usage example:
+    \code
+    static stk::Promise<uint32_t> g_AdcResult;
+
+    extern "C" void ADC1_IRQHandler()
+    {
+        g_AdcResult.Set(ADC1->DR);
+    }
+
+    void Task()
+    {
+        stk::Future<uint32_t> result = g_AdcResult.GetFuture();
+        StartAdcConversion();
+
+        // do some other work here ...
+
+        uint32_t value;
+        if (result.Get(value, 10))
+            ...
+    }
+    \endcode
+*/
+template <typename _Ty>
+class Promise
+{
+    friend class Future<_Ty>;
+
+public:
+    explicit Promise() : m_value(), m_ready(false), m_waiter(NULL), m_cont_head(NULL), m_cont_tail(NULL) {}
+
+    /*! \brief     Get Future of this Promise.
+    */
+    Future<_Ty> GetFuture() { return Future<_Ty>(this); }
+
+    /*! \brief     Set value, wake the waiting task up and call attached continuations.
+        \param[in] value: Value.
+        \return    True if value is set, false if value was set already.
+    */
+    bool Set(const _Ty &value)
+    {
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        if (m_ready)
+        {
+            service->ExitCriticalSection();
+            return false;
+        }
+
+        m_value = value;
+        m_ready = true;
+
+        ITask *waiter = m_waiter;
+        m_waiter = NULL;
+
+        Continuation<_Ty> *cont = m_cont_head;
+        m_cont_head = m_cont_tail = NULL;
+
+        service->ExitCriticalSection();
+
+        if (waiter != NULL)
+            service->Notify(waiter);
+
+        // value is not modified anymore, continuations are called in the order of attachment
+        while (cont != NULL)
+        {
+            Continuation<_Ty> *next = cont->m_next;
+            cont->m_next = NULL;
+            cont->OnReady(m_value);
+            cont = next;
+        }
+
+        return true;
+    }
+
+    /*! \brief     Check if value is set.
+    */
+    bool IsReady() const { return m_ready; }
+
+    /*! \brief     Reset Promise for the next asynchronous operation.
+        \note      No task must be waiting and no continuation must be attached.
+    */
+    void Reset()
+    {
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        STK_ASSERT(m_waiter == NULL);
+        STK_ASSERT(m_cont_head == NULL);
+
+        m_ready = false;
+
+        service->ExitCriticalSection();
+    }
+
+private:
+    bool Get(_Ty &value, uint32_t timeout_ms)
+    {
+        IKernelService *service = GetKernelService();
+
+        ITask *caller = service->GetCurrentTask();
+        STK_ASSERT(caller != NULL);
+
+        int64_t deadline = GetWaitDeadline(service, timeout_ms);
+
+        service->EnterCriticalSection();
+
+        while (!m_ready)
+        {
+            // stale notification must not extend the timeout
+            if (service->GetTicks() >= deadline)
+                break;
+
+            // only one task can wait for the value
+            STK_ASSERT((m_waiter == NULL) || (m_waiter == caller));
+            m_waiter = caller;
+
+            service->ExitCriticalSection();
+
+            // value set before the wait leaves a pending notification
+            bool notified = service->WaitUntil(deadline);
+
+            service->EnterCriticalSection();
+
+            if (!notified)
+                break;
+        }
+
+        m_waiter = NULL;
+        bool ready = m_ready;
+
+        if (ready)
+            value = m_value;
+
+        service->ExitCriticalSection();
+        return ready;
+    }
+
+    void Then(Continuation<_Ty> *cont)
+    {
+        STK_ASSERT(cont != NULL);
+        STK_ASSERT(cont->m_next == NULL);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        if (!m_ready)
+        {
+            if (m_cont_tail != NULL)
+                m_cont_tail->m_next = cont;
+            else
+                m_cont_head = cont;
+
+            m_cont_tail = cont;
+
+            service->ExitCriticalSection();
+            return;
+        }
+
+        service->ExitCriticalSection();
+
+        cont->OnReady(m_value);
+    }
+
+    _Ty                m_value;     //!< value
+    volatile bool      m_ready;     //!< true if value is set
+    ITask *volatile    m_waiter;    //!< task waiting for the value, NULL if none
+    Continuation<_Ty> *m_cont_head; //!< first attached continuation
+    Continuation<_Ty> *m_cont_tail; //!< last attached continuation
+};
+
+} // namespace stk
+
+#endif /* STK_FUTURE_H_ */
@@ -112,6 +112,34 @@ __stk_forceinline int64_t GetTicksFromMilliseconds(int64_t ms, int32_t resolutio
     return ms * 1000 / resolution;
 }
 
+/*! \brief     Get deadline of the wait which expires after the timeout (see IKernelService::WaitUntil).
+    \note      Timeout is converted to ticks once, therefore waits repeated until the deadline do not accumulate
+               rounding errors.
+    \param[in] service: Kernel service.
+    \param[in] timeout_ms: Timeout (milliseconds), or WAIT_INFINITE.
+    \return    Absolute tick, or WAIT_DEADLINE_INFINITE if timeout is WAIT_INFINITE.
+*/
+__stk_forceinline int64_t GetWaitDeadline(IKernelService *service, uint32_t timeout_ms)
+{
+    return (timeout_ms != WAIT_INFINITE ?
+        service->GetTicks() + GetTicksFromMilliseconds(timeout_ms, service->GetTickResolution()) :
+        WAIT_DEADLINE_INFINITE);
+}
+
+/*! \brief     Get kernel service of the started Kernel (see IKernelService).
+    \note      Used by the services which are built on top of the Kernel (see TimerHost, Semaphore, WorkerPool, etc.).
+    \return    Kernel service.
+*/
+__stk_forceinline IKernelService *GetKernelService()
+{
+    IKernelService *service = Singleton<IKernelService *>::Get();
+
+    // if hit here: Kernel is not started
+    STK_ASSERT(service != NULL);
+
+    return service;
+}
+
 /*! \brief     Get current time in milliseconds.
     \return    Milliseconds.
 */
@@ -0,0 +1,268 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_IPC_H_
+#define STK_IPC_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_ipc.h
+    \brief Contains synchronous inter-task communication (call/reply IPC with a direct handoff).
+*/
+
+namespace stk {
+
+/*! \class IpcEndpoint
+    \brief Synchronous IPC endpoint of the server task: client sends a message and blocks until server replies
+           (see Call), server replies to the current client and waits for the next message (see ReplyWait).
+
+    Messages are not copied: client is blocked during the call, therefore server reads the message and writes the
+    reply directly from/into the memory of the client. Calls of multiple clients are served in FIFO order.
+
+    Client hands CPU over to the waiting server and server hands CPU back to the client when it replies (see
+    IKernelService::Handoff), therefore round-trip does not depend on the number of other tasks ready to run and
+    on the selection order of the task switching strategy.
+
+    \note  Must be used by the tasks only (soft real-time mode), one task serves the endpoint.
+    \note  Call of the client which is killed or restarted is cancelled (see IWaitRegistration): it is removed from
+           the FIFO, or its reply is dropped if the server is serving it already.
+
+    Usage example:
+    \code
+    static stk::IpcEndpoint<SensorRequest, SensorReply> g_SensorService;
+
+    // client task
+    SensorReply reply;
+    g_SensorService.Call(SensorRequest(SENSOR_TEMP), reply);
+
+    // server task
+    SensorReply reply;
+    const SensorRequest *request = &g_SensorService.Receive();
+    for (;;)
+    {
+        reply = ReadSensor(*request);
+        request = &g_SensorService.ReplyWait(reply);
+    }
+    \endcode
+*/
+template <typename _TyMsg, typename _TyReply = _TyMsg>
+class IpcEndpoint
+{
+public:
+    explicit IpcEndpoint() : m_head(NULL), m_tail(NULL), m_current(NULL), m_cancelled(false), m_server(NULL),
+        m_server_waiting(false), m_pending(0)
+    {}
+
+    /*! \brief     Send message to the server and wait for its reply.
+        \note      Caller task is not scheduled while waiting (see IKernelService::Wait).
+        \param[in] msg: Message.
+        \param[out] reply: Reply of the server.
+    */
+    void Call(const _TyMsg &msg, _TyReply &reply)
+    {
+        IKernelService *service = GetKernelService();
+
+        Request request;
+        request.endpoint = this;
+        request.msg      = &msg;
+        request.reply    = &reply;
+        request.client   = service->GetCurrentTask();
+        request.next     = NULL;
+        request.replied  = false;
+
+        STK_ASSERT(request.client != NULL);
+
+        service->EnterCriticalSection();
+
+        if (m_tail != NULL)
+            m_tail->next = &request;
+        else
+            m_head = &request;
+
+        m_tail = &request;
+        ++m_pending;
+
+        // call is unlinked if client is killed or restarted while waiting (see CancelRequest)
+        service->SetWaitRegistration(&request);
+
+        ITask *server = NULL;
+        if (m_server_waiting)
+        {
+            server = m_server;
+            m_server_waiting = false;
+        }
+
+        service->ExitCriticalSection();
+
+        // pass the rest of the time slice to the waiting server
+        if (server != NULL)
+        {
+            service->Notify(server);
+            service->Handoff(server);
+        }
+
+        while (!request.replied)
+            service->Wait(WAIT_INFINITE);
+
+        service->SetWaitRegistration(NULL);
+    }
+
+    /*! \brief     Wait for the first message (server side).
+        \return    Message of the client which must be replied with ReplyWait.
+    */
+    const _TyMsg &Receive()
+    {
+        // if hit here: reply to the current message with ReplyWait
+        STK_ASSERT(m_current == NULL);
+
+        return WaitMessage(GetKernelService());
+    }
+
+    /*! \brief     Reply to the current message and wait for the next one (server side).
+        \param[in] reply: Reply to the client.
+        \return    Next message which must be replied with ReplyWait.
+    */
+    const _TyMsg &ReplyWait(const _TyReply &reply)
+    {
+        // if hit here: receive message with Receive first
+        STK_ASSERT(m_current != NULL);
+
+        IKernelService *service = GetKernelService();
+
+        // request memory belongs to the client and becomes invalid when client is released, reply is written
+        // within the critical section because client could be killed or restarted meanwhile (see CancelRequest)
+        ITask *client = NULL;
+
+        service->EnterCriticalSection();
+
+        if (!m_cancelled)
+        {
+            (*m_current->reply) = reply;
+            m_current->replied  = true;
+            client = m_current->client;
+        }
+
+        m_current   = NULL;
+        m_cancelled = false;
+
+        bool idle = (m_head == NULL);
+
+        service->ExitCriticalSection();
+
+        if (client != NULL)
+        {
+            service->Notify(client);
+
+            // server is going to wait, pass the rest of the time slice back to the client
+            if (idle)
+                service->Handoff(client);
+        }
+
+        return WaitMessage(service);
+    }
+
+    /*! \brief     Get number of calls waiting for the server.
+    */
+    uint32_t GetPending() const { return m_pending; }
+
+private:
+    /*! \class Request
+        \brief Call of the client (allocated on the stack of the client).
+    */
+    struct Request : public IWaitRegistration
+    {
+        void CancelWait() { endpoint->CancelRequest(this); }
+
+        IpcEndpoint  *endpoint; //!< endpoint
+        const _TyMsg *msg;      //!< message
+        _TyReply     *reply;    //!< reply
+        ITask        *client;   //!< client task
+        Request      *next;     //!< next call in the FIFO
+        volatile bool replied;  //!< true if server replied
+    };
+
+    /*! \brief     Cancel call of the client which is killed or restarted (see IWaitRegistration).
+        \note      Call which is being served is not replied, call which waits for the server is removed from the FIFO.
+    */
+    void CancelRequest(Request *request)
+    {
+        if (request == m_current)
+        {
+            m_cancelled = true;
+            return;
+        }
+
+        for (Request *itr = m_head, *prev = NULL; itr != NULL; prev = itr, itr = itr->next)
+        {
+            if (itr == request)
+            {
+                if (prev != NULL)
+                    prev->next = itr->next;
+                else
+                    m_head = itr->next;
+
+                if (m_tail == itr)
+                    m_tail = prev;
+
+                --m_pending;
+                return;
+            }
+        }
+    }
+
+    const _TyMsg &WaitMessage(IKernelService *service)
+    {
+        ITask *server = service->GetCurrentTask();
+        STK_ASSERT(server != NULL);
+
+        service->EnterCriticalSection();
+
+        // if hit here: endpoint is served by another task
+        STK_ASSERT((m_server == NULL) || (m_server == server));
+        m_server = server;
+
+        while (m_head == NULL)
+        {
+            m_server_waiting = true;
+
+            service->ExitCriticalSection();
+
+            // message sent before the wait leaves a pending notification
+            service->Wait(WAIT_INFINITE);
+
+            service->EnterCriticalSection();
+        }
+
+        m_server_waiting = false;
+
+        m_current = m_head;
+        m_head    = m_head->next;
+
+        if (m_head == NULL)
+            m_tail = NULL;
+
+        --m_pending;
+
+        service->ExitCriticalSection();
+
+        return (*m_current->msg);
+    }
+
+    Request          *m_head;           //!< first call waiting for the server
+    Request          *m_tail;           //!< last call waiting for the server
+    Request          *m_current;        //!< call which is being served
+    bool              m_cancelled;      //!< true if client of the call which is being served is killed or restarted
+    ITask            *m_server;         //!< server task
+    volatile bool     m_server_waiting; //!< true if server waits for a call
+    volatile uint32_t m_pending;        //!< number of calls waiting for the server
+};
+
+} // namespace stk
+
+#endif /* STK_IPC_H_ */
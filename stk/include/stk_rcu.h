@@ -0,0 +1,220 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_RCU_H_
+#define STK_RCU_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_rcu.h
+    \brief Contains read-copy-update (RCU) facility for the read-mostly data (RcuPointer, Rcu, RcuRetireList).
+*/
+
+namespace stk {
+
+/*! \class Rcu
+    \brief Grace periods of RCU: grace period completes when every task has given CPU up voluntarily (Sleep, Wait,
+           SwitchToNext) at least once, therefore no task can still hold the pointer which was replaced before the
+           grace period started (see IKernelService::StartGracePeriod).
+*/
+class Rcu
+{
+public:
+    /*! \brief     Start grace period without waiting for its completion (see IsCompleted).
+        \return    Sequence number of the grace period.
+    */
+    static uint32_t StartGracePeriod() { return GetKernelService()->StartGracePeriod(); }
+
+    /*! \brief     Check if grace period is completed.
+        \param[in] gp: Sequence number of the grace period returned by StartGracePeriod.
+    */
+    static bool IsCompleted(uint32_t gp) { return GetKernelService()->IsGracePeriodCompleted(gp); }
+
+    /*! \brief     Wait until the grace period completes, old versions of the data replaced before the call can be
+                   reclaimed then.
+        \note      Caller gives CPU up to other tasks while waiting (see IKernelService::SwitchToNext).
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout.
+        \return    True if grace period completed, false if timeout expired.
+    */
+    static bool Synchronize(uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        IKernelService *service = GetKernelService();
+
+        uint32_t gp = service->StartGracePeriod();
+
+        int64_t deadline = service->GetTicks() + GetTicksFromMilliseconds(timeout_ms, service->GetTickResolution());
+
+        while (!service->IsGracePeriodCompleted(gp))
+        {
+            if ((timeout_ms != WAIT_INFINITE) && (service->GetTicks() >= deadline))
+                return false;
+
+            service->SwitchToNext();
+        }
+
+        return true;
+    }
+};
+
+/*! \class RcuPointer
+    \brief Pointer to the read-mostly data of _Ty (e.g. routing table, set of parameters) which is published by the
+           writer and read by any number of readers without locking.
+
+    Reader dereferences the pointer with a single load (see Read) and never blocks, therefore cost of the read does
+    not depend on the number of readers. Writer prepares a new version of the data, publishes it (see Publish) and
+    reclaims the old version after a grace period (see Update, Rcu::Synchronize, RcuRetireList).
+
+    \note  Reader must not Sleep, Wait or SwitchToNext while it uses the data obtained with Read: voluntary switch
+           ends the read-side section (quiescent state), preemption does not.
+    \note  Single writer, or writers serialized by the caller.
+
+    Usage example:
+    \code
+    static stk::RcuPointer<RouteTable> g_Routes(&g_RouteTables[0]);
+
+    // reader task
+    const RouteTable *routes = g_Routes.Read();
+    Forward(packet, routes->Find(packet.dst));
+
+    // writer task
+    RouteTable *next = (g_Routes.Read() == &g_RouteTables[0] ? &g_RouteTables[1] : &g_RouteTables[0]);
+    (*next) = (*g_Routes.Read());
+    next->Add(route);
+    g_Routes.Update(next); // old table is not used by the readers when Update returns
+    \endcode
+*/
+template <typename _Ty>
+class RcuPointer
+{
+public:
+    explicit RcuPointer(_Ty *ptr = NULL) : m_ptr(ptr) {}
+
+    /*! \brief     Get published version of the data (reader side).
+        \return    Pointer which stays valid until the reader gives CPU up voluntarily.
+    */
+    _Ty *Read() const { return m_ptr; }
+
+    /*! \brief     Publish new version of the data (writer side), readers see it on their next Read.
+        \param[in] ptr: New version.
+        \return    Old version which must not be reclaimed until a grace period completes (see Rcu::Synchronize).
+    */
+    _Ty *Publish(_Ty *ptr)
+    {
+        // content of the new version must be visible before the pointer
+        __stk_full_memfence();
+
+        _Ty *old = m_ptr;
+        m_ptr = ptr;
+
+        return old;
+    }
+
+    /*! \brief     Publish new version of the data and wait until the old one is not used by the readers.
+        \param[in] ptr: New version.
+        \return    Old version which can be reclaimed.
+    */
+    _Ty *Update(_Ty *ptr)
+    {
+        _Ty *old = Publish(ptr);
+
+        Rcu::Synchronize();
+
+        return old;
+    }
+
+private:
+    _Ty *volatile m_ptr; //!< published version
+};
+
+/*! \typedef RcuFreeFunc
+    \brief   Function which reclaims the old version of the data (see RcuRetireList).
+*/
+typedef void (*RcuFreeFunc)(void *ptr);
+
+/*! \class RcuRetireList
+    \brief Deferred reclamation of up to _Capacity old versions of the data: writer retires the old version and
+           continues without waiting for the grace period (see Retire), versions are reclaimed after their grace
+           periods complete (see Reclaim).
+    \note  Writer side only.
+*/
+template <uint32_t _Capacity = 4>
+class RcuRetireList
+{
+public:
+    explicit RcuRetireList() : m_head(0), m_count(0) {}
+
+    /*! \brief     Retire old version of the data, it is reclaimed when a grace period which is started by this call
+                   completes.
+        \param[in] ptr: Old version (see RcuPointer::Publish).
+        \param[in] free_func: Function which reclaims the old version.
+        \return    False if list is full (call Reclaim, or Rcu::Synchronize and Reclaim), true otherwise.
+    */
+    bool Retire(void *ptr, RcuFreeFunc free_func)
+    {
+        STK_ASSERT(free_func != NULL);
+
+        if (m_count == _Capacity)
+            return false;
+
+        Retired &retired = m_retired[(m_head + m_count) % _Capacity];
+        retired.ptr       = ptr;
+        retired.free_func = free_func;
+        retired.gp        = Rcu::StartGracePeriod();
+
+        ++m_count;
+        return true;
+    }
+
+    /*! \brief     Reclaim old versions which grace periods completed.
+        \return    Number of reclaimed versions.
+    */
+    uint32_t Reclaim()
+    {
+        uint32_t reclaimed = 0;
+
+        // grace periods complete in the order of retirement
+        while ((m_count != 0) && Rcu::IsCompleted(m_retired[m_head].gp))
+        {
+            Retired &retired = m_retired[m_head];
+            retired.free_func(retired.ptr);
+
+            m_head = (m_head + 1) % _Capacity;
+            --m_count;
+            ++reclaimed;
+        }
+
+        return reclaimed;
+    }
+
+    /*! \brief     Get number of retired versions waiting for reclamation.
+    */
+    uint32_t GetPending() const { return m_count; }
+
+private:
+    /*! \class Retired
+        \brief Retired version of the data.
+    */
+    struct Retired
+    {
+        void       *ptr;       //!< old version
+        RcuFreeFunc free_func; //!< reclamation function
+        uint32_t    gp;        //!< grace period which must complete before reclamation
+    };
+
+    Retired  m_retired[_Capacity]; //!< ring buffer of retired versions
+    uint32_t m_head;               //!< index of the oldest retired version
+    uint32_t m_count;              //!< number of retired versions
+
+    // If hit here: capacity must not be 0.
+    STK_STATIC_ASSERT_N(RCU_RETIRE_LIST_CAPACITY, _Capacity != 0);
+};
+
+} // namespace stk
+
+#endif /* STK_RCU_H_ */
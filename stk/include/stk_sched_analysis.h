@@ -0,0 +1,281 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_SCHED_ANALYSIS_H_
+#define STK_SCHED_ANALYSIS_H_
+
+#include "stk_common.h"
+
+/*! \file  stk_sched_analysis.h
+    \brief Contains schedulability analysis of the periodic HRT tasks (utilization bound and response-time analysis).
+*/
+
+namespace stk {
+
+/*! \class SchedTaskInfo
+    \brief Timing parameters of the periodic task used by the schedulability analysis.
+    \note  Deadline is constrained, e.g. it must not exceed periodicity.
+*/
+struct SchedTaskInfo
+{
+    uint32_t periodicity; //!< periodicity (ticks)
+    uint32_t wcet;        //!< worst-case execution time of the job (ticks)
+    uint32_t deadline;    //!< deadline relative to the release of the job (ticks)
+};
+
+/*! \class SchedAnalysis
+    \brief Schedulability analysis of the set of periodic tasks.
+
+    Analysis applies tests in the following order:
+    - total utilization must not exceed 100% (necessary for any policy);
+    - Liu & Layland utilization bound n(2^(1/n) - 1) (sufficient for stk::SCHED_POLICY_RATE_MONOTONIC);
+    - response-time analysis (RTA): worst-case response time of every task must fit its deadline.
+
+    Response time R of the task i is a fixed point of R = C(i) + I(R), where interference I(R) of other
+    tasks within the window R depends on the scheduling policy:
+    - stk::SCHED_POLICY_RATE_MONOTONIC: sum of ceil(R / T(j)) * C(j) of the tasks with a higher priority;
+    - stk::SCHED_POLICY_ROUND_ROBIN: sum of C(j) of all other tasks because HRT job is not preempted by the
+      rotation (switching it out completes the job, see ITaskSwitchStrategy::PREEMPTIVE), therefore job of the
+      task i waits for at most one whole job of every other task before its turn comes (deadline does not
+      exceed periodicity, hence every task has at most one pending job).
+
+    \note  Round-Robin model assumes that job is not cut by the rotation, e.g. time quantum of the strategy is not
+           shorter than WCET of the jobs (see SwitchStrategyRoundRobin::SetQuantum).
+    \note  Utilization is expressed in parts per million (see SchedAnalysis::UTILIZATION_FULL) and is
+           rounded up, bound is rounded down, therefore tests are never optimistic.
+    \note  Functions are iterative and intended for the run-time, use SchedTaskList for the compile-time analysis.
+*/
+class SchedAnalysis
+{
+public:
+    enum EConsts
+    {
+        UTILIZATION_FULL = 1000000 //!< 100% utilization
+    };
+
+    /*! \brief     Get utilization of the task.
+        \param[in] task: Task.
+        \return    Utilization in parts per million (rounded up).
+    */
+    static constexpr uint32_t GetUtilization(const SchedTaskInfo &task)
+    {
+        return (uint32_t)((((uint64_t)task.wcet * UTILIZATION_FULL) + task.periodicity - 1) / task.periodicity);
+    }
+
+    /*! \brief     Get total utilization of the task set.
+        \param[in] tasks: Tasks.
+        \param[in] count: Number of tasks.
+        \return    Utilization in parts per million (rounded up).
+    */
+    static constexpr uint32_t GetUtilization(const SchedTaskInfo *tasks, uint32_t count)
+    {
+        return (count == 0 ? 0 : GetUtilization(tasks[0]) + GetUtilization(tasks + 1, count - 1));
+    }
+
+    /*! \brief     Get Liu & Layland utilization bound of the Rate-Monotonic scheduling.
+        \param[in] count: Number of tasks.
+        \return    Bound in parts per million (rounded down), for more than 10 tasks its limit ln(2) is returned.
+    */
+    static constexpr uint32_t GetLiuLaylandBound(uint32_t count)
+    {
+        return (count <= 1  ? 1000000 :
+                count == 2  ? 828427 :
+                count == 3  ? 779763 :
+                count == 4  ? 756828 :
+                count == 5  ? 743491 :
+                count == 6  ? 734772 :
+                count == 7  ? 728626 :
+                count == 8  ? 724061 :
+                count == 9  ? 720537 :
+                count == 10 ? 717734 : 693147);
+    }
+
+    /*! \brief     Get worst-case interference of other tasks with the task within the time window.
+        \param[in] policy: Scheduling policy.
+        \param[in] tasks: Tasks.
+        \param[in] count: Number of tasks.
+        \param[in] index: Index of the task.
+        \param[in] window: Time window (ticks).
+        \param[in] other: Index of the first other task to account for.
+    */
+    static constexpr uint64_t GetInterference(ESchedPolicy policy, const SchedTaskInfo *tasks, uint32_t count,
+        uint32_t index, uint64_t window, uint32_t other = 0)
+    {
+        return (other >= count ? 0 : GetInterferenceOf(policy, tasks, index, other, window) +
+            GetInterference(policy, tasks, count, index, window, other + 1));
+    }
+
+    /*! \brief     Get worst-case response time of the task.
+        \param[in] policy: Scheduling policy.
+        \param[in] tasks: Tasks.
+        \param[in] count: Number of tasks.
+        \param[in] index: Index of the task.
+        \return    Response time (ticks), if it exceeds deadline of the task then iteration is stopped and
+                   the first value exceeding deadline is returned.
+    */
+    static uint32_t GetResponseTime(ESchedPolicy policy, const SchedTaskInfo *tasks, uint32_t count, uint32_t index)
+    {
+        STK_ASSERT(index < count);
+
+        const SchedTaskInfo &task = tasks[index];
+        uint64_t response = task.wcet;
+
+        for (;;)
+        {
+            uint64_t next = task.wcet + GetInterference(policy, tasks, count, index, response);
+
+            if ((next == response) || (next > task.deadline))
+                return (uint32_t)next;
+
+            response = next;
+        }
+    }
+
+    /*! \brief     Check if task set is schedulable under the scheduling policy.
+        \param[in] policy: Scheduling policy.
+        \param[in] tasks: Tasks.
+        \param[in] count: Number of tasks.
+        \return    True if schedulable, otherwise false.
+    */
+    static bool IsSchedulable(ESchedPolicy policy, const SchedTaskInfo *tasks, uint32_t count)
+    {
+        uint32_t utilization = GetUtilization(tasks, count);
+
+        if (utilization > UTILIZATION_FULL)
+            return false;
+
+        if (policy == SCHED_POLICY_NONE)
+            return true;
+
+        // sufficient test, no need to compute response times
+        if ((policy == SCHED_POLICY_RATE_MONOTONIC) && (utilization <= GetLiuLaylandBound(count)))
+            return true;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (GetResponseTime(policy, tasks, count, i) > tasks[i].deadline)
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    static constexpr uint64_t GetDemand(const SchedTaskInfo &task, uint64_t window)
+    {
+        return ((window + task.periodicity - 1) / task.periodicity) * task.wcet;
+    }
+
+    static constexpr bool IsHigherPriorityRm(const SchedTaskInfo *tasks, uint32_t index, uint32_t other)
+    {
+        // equal periodicity: the task added earlier has a higher priority
+        return (tasks[other].periodicity < tasks[index].periodicity) ||
+            ((tasks[other].periodicity == tasks[index].periodicity) && (other < index));
+    }
+
+    static constexpr uint64_t GetInterferenceOf(ESchedPolicy policy, const SchedTaskInfo *tasks, uint32_t index,
+        uint32_t other, uint64_t window)
+    {
+        return (other == index ? 0 :
+            policy == SCHED_POLICY_ROUND_ROBIN ? tasks[other].wcet :
+            policy == SCHED_POLICY_RATE_MONOTONIC ?
+                (IsHigherPriorityRm(tasks, index, other) ? GetDemand(tasks[other], window) : 0) : 0);
+    }
+};
+
+/*! \class SchedTask
+    \brief Compile-time descriptor of the periodic task for the schedulability analysis (see SchedTaskList).
+*/
+template <uint32_t _Periodicity, uint32_t _Wcet, uint32_t _Deadline = _Periodicity>
+struct SchedTask
+{
+    enum EConsts
+    {
+        PERIODICITY = _Periodicity, //!< periodicity (ticks)
+        WCET        = _Wcet,        //!< worst-case execution time of the job (ticks)
+        DEADLINE    = _Deadline     //!< deadline relative to the release of the job (ticks)
+    };
+
+    // If hit here: periodicity and WCET must not be 0, WCET must fit into the deadline and deadline into periodicity.
+    STK_STATIC_ASSERT_N(SCHED_TASK_INVALID, (_Periodicity != 0) && (_Wcet != 0) && (_Wcet <= _Deadline) &&
+        (_Deadline <= _Periodicity));
+};
+
+/*! \class SchedTaskList
+    \brief Compile-time schedulability analysis of the task set (see SchedAnalysis).
+    \note  Priority of the tasks with equal periodicity is defined by their order in the list.
+
+    Usage example:
+    \code
+    typedef SchedTaskList<SchedTask<4, 1>, SchedTask<6, 2>, SchedTask<12, 3> > TaskSet;
+
+    STK_STATIC_ASSERT_N(TASK_SET_SCHEDULABLE, TaskSet::IsSchedulable(SCHED_POLICY_RATE_MONOTONIC));
+    \endcode
+*/
+template <class... _Tasks>
+struct SchedTaskList
+{
+    enum EConsts
+    {
+        SIZE = sizeof...(_Tasks) //!< number of tasks
+    };
+
+    static constexpr SchedTaskInfo TASKS[SIZE] = { { _Tasks::PERIODICITY, _Tasks::WCET, _Tasks::DEADLINE }... }; //!< task set
+
+    /*! \brief     Get total utilization of the task set (parts per million, see SchedAnalysis::UTILIZATION_FULL).
+    */
+    static constexpr uint32_t GetUtilization() { return SchedAnalysis::GetUtilization(TASKS, SIZE); }
+
+    /*! \brief     Get worst-case response time of the task (see SchedAnalysis::GetResponseTime).
+        \param[in] policy: Scheduling policy.
+        \param[in] index: Index of the task.
+    */
+    static constexpr uint32_t GetResponseTime(ESchedPolicy policy, uint32_t index)
+    {
+        return (uint32_t)IterateResponseTime(policy, index, TASKS[index].wcet);
+    }
+
+    /*! \brief     Check if task set is schedulable under the scheduling policy (see SchedAnalysis::IsSchedulable).
+        \param[in] policy: Scheduling policy.
+    */
+    static constexpr bool IsSchedulable(ESchedPolicy policy)
+    {
+        return (GetUtilization() <= SchedAnalysis::UTILIZATION_FULL) && ((policy == SCHED_POLICY_NONE) ||
+            ((policy == SCHED_POLICY_RATE_MONOTONIC) && (GetUtilization() <= SchedAnalysis::GetLiuLaylandBound(SIZE))) ||
+            IsResponseTimeMet(policy, 0));
+    }
+
+    // If hit here: task set must not be empty.
+    STK_STATIC_ASSERT_N(SCHED_TASK_LIST_EMPTY, SIZE != 0);
+
+private:
+    static constexpr uint64_t IterateResponseTime(ESchedPolicy policy, uint32_t index, uint64_t response)
+    {
+        return NextResponseTime(policy, index, response,
+            TASKS[index].wcet + SchedAnalysis::GetInterference(policy, TASKS, SIZE, index, response));
+    }
+
+    static constexpr uint64_t NextResponseTime(ESchedPolicy policy, uint32_t index, uint64_t response, uint64_t next)
+    {
+        return ((next == response) || (next > TASKS[index].deadline) ? next :
+            IterateResponseTime(policy, index, next));
+    }
+
+    static constexpr bool IsResponseTimeMet(ESchedPolicy policy, uint32_t index)
+    {
+        return (index >= SIZE) || ((GetResponseTime(policy, index) <= TASKS[index].deadline) &&
+            IsResponseTimeMet(policy, index + 1));
+    }
+};
+
+template <class... _Tasks> constexpr SchedTaskInfo SchedTaskList<_Tasks...>::TASKS[SchedTaskList<_Tasks...>::SIZE];
+
+} // namespace stk
+
+#endif /* STK_SCHED_ANALYSIS_H_ */
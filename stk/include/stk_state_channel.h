@@ -0,0 +1,199 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_STATE_CHANNEL_H_
+#define STK_STATE_CHANNEL_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_state_channel.h
+    \brief Contains lock-free channels for the exchange of the state between tasks running at different rates
+           (SeqLockChannel, TripleBufferChannel).
+*/
+
+namespace stk {
+
+/*! \class SeqLockChannel
+    \brief Single-writer channel of the latest value of _Ty (e.g. state vector) protected with a sequence lock.
+
+    Writer never blocks, reader gets the latest consistent snapshot: it repeats the copy if the writer published
+    a new value meanwhile. Two copies of the value are kept (latch), therefore the reader which preempts the writer
+    in the middle of the update reads the other copy and does not wait for the writer to complete.
+
+    Neither side disables interrupts or calls the kernel, therefore it can be used by the HRT tasks and ISRs without
+    affecting their execution time beyond the copy of the value.
+
+    \note  _Ty must be copyable with the assignment (plain data), the reader can observe a torn copy which is discarded.
+*/
+template <typename _Ty>
+class SeqLockChannel
+{
+public:
+    explicit SeqLockChannel() : m_seq(0), m_value() {}
+
+    /*! \brief     Publish new value (writer side).
+        \param[in] value: Value.
+    */
+    void Write(const _Ty &value)
+    {
+        // odd sequence redirects readers to the second copy while the first is being updated
+        ++m_seq;
+        __stk_full_memfence();
+        m_value[0] = value;
+        __stk_full_memfence();
+
+        ++m_seq;
+        __stk_full_memfence();
+        m_value[1] = value;
+        __stk_full_memfence();
+    }
+
+    /*! \brief     Read latest value (reader side).
+        \param[out] value: Value.
+        \return    Sequence of the value, changes when a new value is published.
+    */
+    uint32_t Read(_Ty &value) const
+    {
+        uint32_t seq;
+
+        do
+        {
+            seq = m_seq;
+            __stk_full_memfence();
+            value = m_value[seq & 1];
+            __stk_full_memfence();
+        }
+        while (seq != m_seq);
+
+        return (seq >> 1);
+    }
+
+    /*! \brief     Get sequence of the latest value (see Read).
+    */
+    uint32_t GetSequence() const { return (m_seq >> 1); }
+
+private:
+    volatile uint32_t m_seq;      //!< sequence: incremented twice per write, odd while first copy is being updated
+    _Ty               m_value[2]; //!< copies of the value
+};
+
+/*! \class TripleBufferChannel
+    \brief Single-writer/single-reader channel of the latest value of _Ty with three buffers.
+
+    Writer fills the buffer which is neither the latest one nor the one which is being read (see BeginWrite,
+    EndWrite), reader accesses the latest buffer in place (see Read) without copying it. Writer never blocks and
+    never waits for the reader, reader retries only if writer published a new buffer while reader was selecting
+    the latest one.
+
+    Neither side disables interrupts or calls the kernel, only loads and stores of the buffer indexes are used
+    (no atomic read-modify-write instructions are required, e.g. on Cortex-M0).
+
+    Usage example:
+    \code
+    static stk::TripleBufferChannel<EstimatorState> g_State;
+
+    // writer task (estimator)
+    EstimatorState &state = g_State.BeginWrite();
+    Estimate(state);
+    g_State.EndWrite();
+
+    // reader task (controller)
+    const EstimatorState &state = g_State.Read();
+    Control(state);
+    \endcode
+*/
+template <typename _Ty>
+class TripleBufferChannel
+{
+public:
+    explicit TripleBufferChannel() : m_latest(0), m_reading(0), m_write(1), m_seq(0), m_buffer() {}
+
+    /*! \brief     Get buffer for the new value (writer side).
+        \return    Buffer which is not accessed by the reader.
+    */
+    _Ty &BeginWrite()
+    {
+        // reading index published by the reader must be observed after the latest index was published
+        __stk_full_memfence();
+
+        uint32_t latest = m_latest, reading = m_reading;
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            if ((i != latest) && (i != reading))
+            {
+                m_write = i;
+                break;
+            }
+        }
+
+        return m_buffer[m_write];
+    }
+
+    /*! \brief     Publish buffer returned by BeginWrite as the latest value (writer side).
+    */
+    void EndWrite()
+    {
+        // value must be visible before the index
+        __stk_full_memfence();
+
+        m_latest = m_write;
+        ++m_seq;
+    }
+
+    /*! \brief     Publish new value (writer side), copies value into the buffer.
+        \param[in] value: Value.
+    */
+    void Write(const _Ty &value)
+    {
+        BeginWrite() = value;
+        EndWrite();
+    }
+
+    /*! \brief     Get latest value (reader side).
+        \return    Latest value, valid until the next call to Read.
+    */
+    const _Ty &Read()
+    {
+        uint32_t latest;
+
+        for (;;)
+        {
+            latest = m_latest;
+
+            // claim buffer, then check that writer did not replace it before the claim became visible
+            m_reading = latest;
+            __stk_full_memfence();
+
+            if (m_latest == latest)
+                break;
+        }
+
+        return m_buffer[latest];
+    }
+
+    /*! \brief     Check if writer published a value which was not read yet (reader side).
+    */
+    bool HasNew() const { return (m_latest != m_reading); }
+
+    /*! \brief     Get number of published values.
+    */
+    uint32_t GetSequence() const { return m_seq; }
+
+private:
+    volatile uint32_t m_latest;    //!< index of the latest published buffer (written by the writer)
+    volatile uint32_t m_reading;   //!< index of the buffer which is being read (written by the reader)
+    uint32_t          m_write;     //!< index of the buffer which is being written
+    volatile uint32_t m_seq;       //!< number of published values
+    _Ty               m_buffer[3]; //!< buffers
+};
+
+} // namespace stk
+
+#endif /* STK_STATE_CHANNEL_H_ */
@@ -0,0 +1,306 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_STREAM_H_
+#define STK_STREAM_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_stream.h
+    \brief Contains byte stream buffer with access to the contiguous regions (e.g. for DMA).
+*/
+
+namespace stk {
+
+/*! \class StreamBuffer
+    \brief Single-writer/single-reader byte ring buffer of _Size bytes (power of 2).
+
+    Writer gets the largest contiguous free region (see GetWriteRegion), fills it (e.g. by DMA) and commits the
+    written bytes (see CommitWrite), reader gets the largest contiguous region of the written bytes (see
+    GetReadRegion) and commits the consumed bytes (see CommitRead), therefore data is not copied. Write and Read
+    copy the data for the convenience.
+
+    Data path is lock-free: writer modifies only the write position and reader modifies only the read position.
+    Reader can block until at least N bytes are available (see WaitReadable, SetTriggerLevel), writer can block
+    until at least N bytes are free (see WaitWritable). Critical section is entered only when the other side is
+    waiting.
+
+    \note  Writer or reader can be an ISR (without blocking).
+
+    Usage example:
+    \code
+    static stk::StreamBuffer<256> g_UartRx;
+
+    // ISR on DMA half/full transfer
+    g_UartRx.CommitWrite(received);
+
+    // reader task
+    g_UartRx.SetTriggerLevel(16);
+    for (;;)
+    {
+        g_UartRx.WaitReadable();
+
+        const uint8_t *data;
+        uint32_t length = g_UartRx.GetReadRegion(&data);
+        ParseBytes(data, length);
+        g_UartRx.CommitRead(length);
+    }
+    \endcode
+*/
+template <uint32_t _Size>
+class StreamBuffer
+{
+public:
+    enum EConsts
+    {
+        SIZE = _Size //!< capacity (bytes)
+    };
+
+    explicit StreamBuffer() : m_head(0), m_tail(0), m_trigger(1), m_reader(NULL), m_writer(NULL), m_read_need(0),
+        m_write_need(0)
+    {}
+
+    /*! \brief     Get largest contiguous free region (writer side).
+        \param[out] region: Start of the region.
+        \return    Size of the region (bytes), 0 if buffer is full.
+    */
+    uint32_t GetWriteRegion(uint8_t **region)
+    {
+        uint32_t head = m_head;
+        uint32_t start = head & MASK;
+        uint32_t free = _Size - (head - m_tail);
+
+        (*region) = GetData() + start;
+        return Min(free, _Size - start);
+    }
+
+    /*! \brief     Commit bytes written into the region returned by GetWriteRegion (writer side).
+        \param[in] length: Number of written bytes.
+    */
+    void CommitWrite(uint32_t length)
+    {
+        STK_ASSERT(length <= GetFree());
+
+        // data must be visible before the write position
+        __stk_full_memfence();
+        m_head += length;
+
+        if (m_read_need != 0)
+            WakeUp(m_reader, m_read_need, true);
+    }
+
+    /*! \brief     Get largest contiguous region of the written bytes (reader side).
+        \param[out] region: Start of the region.
+        \return    Size of the region (bytes), 0 if buffer is empty.
+    */
+    uint32_t GetReadRegion(const uint8_t **region)
+    {
+        uint32_t tail = m_tail;
+        uint32_t start = tail & MASK;
+        uint32_t used = m_head - tail;
+
+        (*region) = GetData() + start;
+        return Min(used, _Size - start);
+    }
+
+    /*! \brief     Commit bytes consumed from the region returned by GetReadRegion (reader side).
+        \param[in] length: Number of consumed bytes.
+    */
+    void CommitRead(uint32_t length)
+    {
+        STK_ASSERT(length <= GetAvailable());
+
+        // data must be consumed before the read position is released to the writer
+        __stk_full_memfence();
+        m_tail += length;
+
+        if (m_write_need != 0)
+            WakeUp(m_writer, m_write_need, false);
+    }
+
+    /*! \brief     Copy data into the buffer (writer side), does not block.
+        \param[in] data: Data.
+        \param[in] length: Length of the data (bytes).
+        \return    Number of written bytes (less than length if buffer is full).
+    */
+    uint32_t Write(const uint8_t *data, uint32_t length)
+    {
+        uint32_t written = 0;
+
+        while (written < length)
+        {
+            uint8_t *region;
+            uint32_t size = Min(GetWriteRegion(&region), length - written);
+            if (size == 0)
+                break;
+
+            for (uint32_t i = 0; i < size; ++i)
+                region[i] = data[written + i];
+
+            CommitWrite(size);
+            written += size;
+        }
+
+        return written;
+    }
+
+    /*! \brief     Copy data from the buffer (reader side), does not block.
+        \param[out] data: Destination.
+        \param[in] length: Size of the destination (bytes).
+        \return    Number of read bytes.
+    */
+    uint32_t Read(uint8_t *data, uint32_t length)
+    {
+        uint32_t read = 0;
+
+        while (read < length)
+        {
+            const uint8_t *region;
+            uint32_t size = Min(GetReadRegion(&region), length - read);
+            if (size == 0)
+                break;
+
+            for (uint32_t i = 0; i < size; ++i)
+                data[read + i] = region[i];
+
+            CommitRead(size);
+            read += size;
+        }
+
+        return read;
+    }
+
+    /*! \brief     Wait until at least min_bytes are available for reading (reader side).
+        \note      Caller task is not scheduled while waiting (see IKernelService::Wait).
+        \param[in] min_bytes: Number of bytes, 0 to use the trigger level (see SetTriggerLevel).
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout.
+        \return    True if bytes are available, false if timeout expired.
+    */
+    bool WaitReadable(uint32_t min_bytes = 0, uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        if (min_bytes == 0)
+            min_bytes = m_trigger;
+
+        STK_ASSERT(min_bytes <= _Size);
+
+        return WaitFor(m_reader, m_read_need, min_bytes, timeout_ms, true);
+    }
+
+    /*! \brief     Wait until at least min_bytes are free for writing (writer side).
+        \note      Caller task is not scheduled while waiting (see IKernelService::Wait).
+        \param[in] min_bytes: Number of bytes (1 - SIZE).
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout.
+        \return    True if bytes are free, false if timeout expired.
+    */
+    bool WaitWritable(uint32_t min_bytes, uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        STK_ASSERT((min_bytes != 0) && (min_bytes <= _Size));
+
+        return WaitFor(m_writer, m_write_need, min_bytes, timeout_ms, false);
+    }
+
+    /*! \brief     Set trigger level: number of bytes which wakes the reader up in WaitReadable (default is 1).
+        \param[in] trigger: Trigger level (1 - SIZE).
+    */
+    void SetTriggerLevel(uint32_t trigger)
+    {
+        STK_ASSERT((trigger != 0) && (trigger <= _Size));
+        m_trigger = trigger;
+    }
+
+    /*! \brief     Get number of bytes available for reading.
+    */
+    uint32_t GetAvailable() const { return m_head - m_tail; }
+
+    /*! \brief     Get number of bytes free for writing.
+    */
+    uint32_t GetFree() const { return _Size - (m_head - m_tail); }
+
+private:
+    enum { MASK = _Size - 1 };
+
+    static __stk_forceinline uint32_t Min(uint32_t a, uint32_t b) { return (a < b ? a : b); }
+
+    __stk_forceinline uint8_t *GetData() { return (uint8_t *)m_data; }
+
+    __stk_forceinline uint32_t GetLevel(bool readable) const { return (readable ? GetAvailable() : GetFree()); }
+
+    bool WaitFor(ITask *volatile &waiter, volatile uint32_t &need, uint32_t min_bytes, uint32_t timeout_ms,
+        bool readable)
+    {
+        IKernelService *service = GetKernelService();
+
+        ITask *caller = service->GetCurrentTask();
+        STK_ASSERT(caller != NULL);
+
+        int64_t deadline = GetWaitDeadline(service, timeout_ms);
+
+        service->EnterCriticalSection();
+
+        // other side can't commit while need is being registered, therefore wake-up is not lost
+        while (GetLevel(readable) < min_bytes)
+        {
+            // stale notification must not extend the timeout
+            if (service->GetTicks() >= deadline)
+                break;
+
+            waiter = caller;
+            need   = min_bytes;
+
+            service->ExitCriticalSection();
+
+            bool notified = service->WaitUntil(deadline);
+
+            service->EnterCriticalSection();
+
+            if (!notified)
+                break;
+        }
+
+        need = 0;
+        bool ready = (GetLevel(readable) >= min_bytes);
+
+        service->ExitCriticalSection();
+        return ready;
+    }
+
+    void WakeUp(ITask *volatile &waiter, volatile uint32_t &need, bool readable)
+    {
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        ITask *task = NULL;
+        if ((need != 0) && (GetLevel(readable) >= need))
+        {
+            task = waiter;
+            need = 0;
+        }
+
+        service->ExitCriticalSection();
+
+        if (task != NULL)
+            service->Notify(task);
+    }
+
+    size_t            m_data[(_Size + sizeof(size_t) - 1) / sizeof(size_t)]; //!< data (aligned for DMA)
+    volatile uint32_t m_head;       //!< write position (free-running)
+    volatile uint32_t m_tail;       //!< read position (free-running)
+    uint32_t          m_trigger;    //!< trigger level of the reader
+    ITask *volatile   m_reader;     //!< reader task waiting in WaitReadable
+    ITask *volatile   m_writer;     //!< writer task waiting in WaitWritable
+    volatile uint32_t m_read_need;  //!< number of bytes reader waits for, 0 if not waiting
+    volatile uint32_t m_write_need; //!< number of bytes writer waits for, 0 if not waiting
+
+    // If hit here: size must be a power of 2.
+    STK_STATIC_ASSERT_N(STREAM_BUFFER_SIZE, (_Size != 0) && ((_Size & (_Size - 1)) == 0));
+};
+
+} // namespace stk
+
+#endif /* STK_STREAM_H_ */
@@ -0,0 +1,309 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_SYNC_H_
+#define STK_SYNC_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_sync.h
+    \brief Contains wait-able synchronization objects (Semaphore, Event) and multiplexing wait on them (WaitAny).
+*/
+
+namespace stk {
+
+/*! \var   WAIT_ANY_MAX
+    \brief Maximum number of objects which can be waited at once (see WaitAny).
+*/
+const uint32_t WAIT_ANY_MAX = 8;
+
+/*! \var   WAIT_ANY_TIMEOUT
+    \brief Returned by WaitAny if timeout expired.
+*/
+const int32_t WAIT_ANY_TIMEOUT = -1;
+
+/*! \class WaitLink
+    \brief Registration of the waiting task on the wait-able object (see WaitObject::WaitAny).
+*/
+struct WaitLink : public util::DListEntry<WaitLink, false>
+{
+    ITask *task; //!< waiting task
+};
+
+/*! \class WaitObject
+    \brief Base class of the wait-able object: task can wait until object becomes ready, or until any of multiple
+           objects becomes ready (see WaitAny).
+
+    Inherit this class, implement TryTake and call WakeWaiters when object becomes ready.
+*/
+class WaitObject
+{
+public:
+    /*! \brief     Wait until any of the objects becomes ready and take it.
+        \note      Caller task is not scheduled while waiting (see IKernelService::Wait). Registration of the wait costs
+                   O(count), the object which becomes ready wakes up its waiters only.
+        \note      If several objects are ready, the one with the lowest index is taken.
+        \param[in] objects: Objects.
+        \param[in] count: Number of objects (1 - WAIT_ANY_MAX).
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout, 0 to not wait.
+        \return    Index of the taken object, or WAIT_ANY_TIMEOUT if timeout expired.
+    */
+    static int32_t WaitAny(WaitObject *const objects[], uint32_t count, uint32_t timeout_ms)
+    {
+        STK_ASSERT(objects != NULL);
+        STK_ASSERT((count != 0) && (count <= WAIT_ANY_MAX));
+
+        IKernelService *service = GetKernelService();
+
+        service->EnterCriticalSection();
+
+        int32_t taken = TryTakeAny(objects, count);
+        if ((taken != WAIT_ANY_TIMEOUT) || (timeout_ms == 0))
+        {
+            service->ExitCriticalSection();
+            return taken;
+        }
+
+        ITask *caller = service->GetCurrentTask();
+        STK_ASSERT(caller != NULL);
+
+        // registrations are unlinked by Kernel if caller is killed or restarted while waiting
+        WaitRegistration reg(objects, count);
+        reg.Link(caller);
+        service->SetWaitRegistration(&reg);
+
+        int64_t deadline = GetWaitDeadline(service, timeout_ms);
+
+        for (;;)
+        {
+            // notification of another object (or a stale one) must not extend the timeout
+            if (service->GetTicks() >= deadline)
+                break;
+
+            service->ExitCriticalSection();
+
+            // object which became ready before the wait leaves a pending notification
+            bool notified = service->WaitUntil(deadline);
+
+            service->EnterCriticalSection();
+
+            taken = TryTakeAny(objects, count);
+            if ((taken != WAIT_ANY_TIMEOUT) || !notified)
+                break;
+        }
+
+        reg.Unlink();
+        service->SetWaitRegistration(NULL);
+
+        service->ExitCriticalSection();
+        return taken;
+    }
+
+    /*! \brief     Check if any task is waiting for this object.
+    */
+    bool HasWaiters() const { return !m_waiters.IsEmpty(); }
+
+protected:
+    explicit WaitObject() : m_waiters() {}
+
+    /*! \brief     Destructor.
+        \note      Non-virtual to avoid dependency on stdc++, object is not deleted through the base class.
+    */
+    ~WaitObject() {}
+
+    /*! \brief     Take object if it is ready (e.g. decrement count of the semaphore).
+        \note      Called within a critical section.
+        \return    True if object was ready and is taken.
+    */
+    virtual bool TryTake() = 0;
+
+    /*! \brief     Wake up the tasks waiting for this object, they try to take it again.
+        \note      Must be called within a critical section (see IKernelService::EnterCriticalSection).
+    */
+    void WakeWaiters(IKernelService *service)
+    {
+        for (WaitLink::DLEntryType *itr = m_waiters.GetFirst(); itr != NULL; itr = itr->GetNext())
+            service->Notify(static_cast<WaitLink *>(itr)->task);
+    }
+
+private:
+    /*! \class WaitRegistration
+        \brief Registrations of the task waiting in WaitAny on all objects (allocated on the stack of the task).
+    */
+    struct WaitRegistration : public IWaitRegistration
+    {
+        WaitRegistration(WaitObject *const objects[], uint32_t count) : m_objects(objects), m_count(count) {}
+
+        void Link(ITask *task)
+        {
+            for (uint32_t i = 0; i < m_count; ++i)
+            {
+                m_links[i].task = task;
+                m_objects[i]->m_waiters.LinkBack(m_links[i]);
+            }
+        }
+
+        void Unlink()
+        {
+            for (uint32_t i = 0; i < m_count; ++i)
+                m_objects[i]->m_waiters.Unlink(&m_links[i]);
+        }
+
+        void CancelWait() { Unlink(); }
+
+        WaitObject *const *m_objects;             //!< objects
+        uint32_t           m_count;               //!< number of objects
+        WaitLink           m_links[WAIT_ANY_MAX]; //!< registrations on the objects
+    };
+
+    static int32_t TryTakeAny(WaitObject *const objects[], uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            STK_ASSERT(objects[i] != NULL);
+
+            if (objects[i]->TryTake())
+                return (int32_t)i;
+        }
+
+        return WAIT_ANY_TIMEOUT;
+    }
+
+    util::DListHead<WaitLink, false> m_waiters; //!< registrations of the waiting tasks
+};
+
+/*! \brief     Wait until any of the objects becomes ready and take it (see WaitObject::WaitAny).
+    \param[in] objects: Objects.
+    \param[in] count: Number of objects (1 - WAIT_ANY_MAX).
+    \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout, 0 to not wait.
+    \return    Index of the taken object, or WAIT_ANY_TIMEOUT if timeout expired.
+*/
+__stk_forceinline int32_t WaitAny(WaitObject *const objects[], uint32_t count, uint32_t timeout_ms = WAIT_INFINITE)
+{
+    return WaitObject::WaitAny(objects, count, timeout_ms);
+}
+
+/*! \class Semaphore
+    \brief Counting semaphore.
+
+    \note  Signal can be called from an ISR.
+*/
+class Semaphore : public WaitObject
+{
+public:
+    /*! \brief     Constructor.
+        \param[in] count: Initial count.
+        \param[in] count_max: Maximum count, signals exceeding it are ignored.
+    */
+    explicit Semaphore(uint32_t count = 0, uint32_t count_max = 0xFFFFFFFF) : m_count(count), m_count_max(count_max)
+    {
+        STK_ASSERT(count <= count_max);
+    }
+
+    /*! \brief     Increment count and wake up the waiting tasks.
+    */
+    void Signal()
+    {
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        if (m_count < m_count_max)
+        {
+            ++m_count;
+            WakeWaiters(service);
+        }
+
+        service->ExitCriticalSection();
+    }
+
+    /*! \brief     Wait until count is not 0 and decrement it.
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout, 0 to not wait.
+        \return    True if decremented, false if timeout expired.
+    */
+    bool Wait(uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        WaitObject *self = this;
+        return (WaitAny(&self, 1, timeout_ms) == 0);
+    }
+
+    /*! \brief     Get current count.
+    */
+    uint32_t GetCount() const { return m_count; }
+
+protected:
+    bool TryTake()
+    {
+        if (m_count == 0)
+            return false;
+
+        --m_count;
+        return true;
+    }
+
+    volatile uint32_t m_count;     //!< current count
+    uint32_t          m_count_max; //!< maximum count
+};
+
+/*! \class Event
+    \brief Auto-reset event (notification): set event wakes up the waiting tasks, the task which takes it resets it.
+
+    \note  Set can be called from an ISR.
+*/
+class Event : public WaitObject
+{
+public:
+    explicit Event(bool set = false) : m_set(set) {}
+
+    /*! \brief     Set event and wake up the waiting tasks.
+    */
+    void Set()
+    {
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        m_set = true;
+        WakeWaiters(service);
+
+        service->ExitCriticalSection();
+    }
+
+    /*! \brief     Reset event.
+    */
+    void Reset() { m_set = false; }
+
+    /*! \brief     Check if event is set.
+    */
+    bool IsSet() const { return m_set; }
+
+    /*! \brief     Wait until event is set and reset it.
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout, 0 to not wait.
+        \return    True if event was set, false if timeout expired.
+    */
+    bool Wait(uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        WaitObject *self = this;
+        return (WaitAny(&self, 1, timeout_ms) == 0);
+    }
+
+protected:
+    bool TryTake()
+    {
+        if (!m_set)
+            return false;
+
+        m_set = false;
+        return true;
+    }
+
+    volatile bool m_set; //!< true if event is set
+};
+
+} // namespace stk
+
+#endif /* STK_SYNC_H_ */
@@ -0,0 +1,477 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_TIMER_H_
+#define STK_TIMER_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_timer.h
+    \brief Contains software timer service (timer daemon task with a hierarchical timer wheel) and periodic release
+           timer of the soft periodic tasks (PeriodicTimer).
+*/
+
+namespace stk {
+
+/*! \class Timer
+    \brief Software timer which is started, stopped and reset by the TimerHost.
+
+    Inherit this class and implement OnExpired which is called from the context of the timer daemon task
+    (see TimerHost), therefore callback can use any services which are available for the task.
+
+    \note  Timer must stay valid while it is active (see IsActive).
+*/
+class Timer : public util::DListEntry<Timer, false>
+{
+    template <uint32_t _StackSize, uint32_t _SlotBits, uint32_t _Levels> friend class TimerHost;
+
+public:
+    explicit Timer() : m_expires(0), m_delay(0), m_period(0) {}
+
+    /*! \brief     Called by the timer daemon task when timer expires.
+    */
+    virtual void OnExpired() = 0;
+
+    /*! \brief     Check if timer is started and did not expire yet (periodic timer stays active until stopped).
+    */
+    bool IsActive() const { return IsLinked(); }
+
+    /*! \brief     Get periodicity of the timer (ticks), 0 if timer is one-shot.
+    */
+    uint32_t GetPeriod() const { return m_period; }
+
+    /*! \brief     Get tick at which timer expires next time.
+    */
+    int64_t GetExpiry() const { return m_expires; }
+
+protected:
+    /*! \brief     Destructor.
+        \note      Non-virtual to avoid dependency on stdc++, timer is not deleted through the base class.
+    */
+    ~Timer() {}
+
+private:
+    int64_t  m_expires; //!< tick of the expiry
+    uint32_t m_delay;   //!< delay of the first expiry (ticks), used by TimerHost::Reset
+    uint32_t m_period;  //!< periodicity (ticks), 0 if one-shot
+};
+
+/*! \class TimerHost
+    \brief Software timer service: a timer daemon task which runs callbacks of the expired timers (see Timer).
+
+    Timers are kept in a hashed hierarchical timer wheel of _Levels levels with 2^_SlotBits slots each. Level 0 slot
+    holds timers expiring at a specific tick, slot of the level N holds timers expiring within a window of
+    2^(_SlotBits * N) ticks which are cascaded to the lower levels when this window is reached. Start, stop and expiry
+    of a timer cost O(1) regardless of the number of timers, the cost of a cascade is amortized over the window.
+    Timers with a delay longer than the wheel range (2^(_SlotBits * _Levels) ticks) are re-cascaded.
+
+    TimerHost is a task which must be added to the Kernel (soft real-time mode), it processes elapsed ticks and waits
+    (see IKernelService::Wait) until the next expiry, or without a timeout if no timer is started. Start and Reset
+    notify the daemon task if timer expires earlier than it is going to wake up. One daemon task replaces multiple
+    single-purpose tasks with their own stacks.
+
+    \note  Start, Stop and Reset are protected with a critical section (see IKernelService::EnterCriticalSection)
+           and can be called from a task, from an ISR and from the timer callback.
+
+    Usage example:
+    \code
+    class MyTimer : public stk::Timer
+    {
+    public:
+        void OnExpired() { // do some work here ... }
+    };
+
+    static stk::TimerHost<> g_TimerHost;
+    static MyTimer g_Timer;
+
+    kernel.AddTask(&g_TimerHost);
+    g_TimerHost.Start(&g_Timer, 10, 100); // expire in 10 ticks, then every 100 ticks
+    \endcode
+*/
+template <uint32_t _StackSize = 256, uint32_t _SlotBits = 4, uint32_t _Levels = 4>
+class TimerHost : public Task<_StackSize, ACCESS_PRIVILEGED>
+{
+public:
+    enum EConsts
+    {
+        SLOTS  = (1 << _SlotBits), //!< number of slots of each level
+        LEVELS = _Levels           //!< number of levels
+    };
+
+    explicit TimerHost() : m_now(0), m_wake(INT64_MAX), m_daemon(NULL) {}
+
+    RunFuncType GetFunc() { return &Run; }
+    void *GetFuncUserData() { return this; }
+
+    /*! \brief     Start timer (restart if timer is active).
+        \param[in] timer: Timer.
+        \param[in] delay_tc: Delay until the first expiry (ticks), delay of 0 is treated as 1.
+        \param[in] period_tc: Periodicity of the subsequent expiries (ticks), 0 for a one-shot timer.
+    */
+    void Start(Timer *timer, uint32_t delay_tc, uint32_t period_tc = 0)
+    {
+        STK_ASSERT(timer != NULL);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        Unlink(timer);
+
+        timer->m_delay   = (delay_tc != 0 ? delay_tc : 1);
+        timer->m_period  = period_tc;
+        timer->m_expires = service->GetTicks() + timer->m_delay;
+
+        Link(timer);
+
+        ITask *wake = GetDaemonToWake(timer);
+
+        service->ExitCriticalSection();
+
+        if (wake != NULL)
+            service->Notify(wake);
+    }
+
+    /*! \brief     Stop timer.
+        \param[in] timer: Timer.
+        \return    True if timer was active.
+    */
+    bool Stop(Timer *timer)
+    {
+        STK_ASSERT(timer != NULL);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        bool active = timer->IsActive();
+        Unlink(timer);
+
+        service->ExitCriticalSection();
+        return active;
+    }
+
+    /*! \brief     Restart timer counting its delay from the current tick (timer is started if it is not active).
+        \param[in] timer: Timer which was started before with Start.
+    */
+    void Reset(Timer *timer)
+    {
+        STK_ASSERT(timer != NULL);
+        STK_ASSERT(timer->m_delay != 0);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        Unlink(timer);
+
+        timer->m_expires = service->GetTicks() + timer->m_delay;
+
+        Link(timer);
+
+        ITask *wake = GetDaemonToWake(timer);
+
+        service->ExitCriticalSection();
+
+        if (wake != NULL)
+            service->Notify(wake);
+    }
+
+    /*! \brief     Process ticks elapsed since the last call and run callbacks of the expired timers.
+        \note      Called by the timer daemon task, can be called by the user if TimerHost is not added to the Kernel.
+    */
+    void Process()
+    {
+        IKernelService *service = GetKernelService();
+
+        while (m_now < service->GetTicks())
+        {
+            service->EnterCriticalSection();
+
+            ++m_now;
+            Cascade();
+
+            service->ExitCriticalSection();
+
+            Expire(service);
+        }
+    }
+
+    /*! \brief     Get last processed tick.
+    */
+    int64_t GetTicks() const { return m_now; }
+
+private:
+    typedef util::DListHead<Timer, false> ListHeadType;
+
+    static void Run(void *user_data)
+    {
+        TimerHost *host = static_cast<TimerHost *>(user_data);
+        IKernelService *service = GetKernelService();
+
+        host->Attach(service);
+
+        for (;;)
+        {
+            host->Process();
+            service->WaitUntil(host->GetWakeTicks(service));
+        }
+    }
+
+    void Attach(IKernelService *service)
+    {
+        service->EnterCriticalSection();
+
+        // host could be added to the Kernel which runs for a while already, ticks before the start are not processed
+        // and timers which were started before are re-linked relative to the current tick
+        ListHeadType started;
+        for (uint32_t level = 0; level < LEVELS; ++level)
+        {
+            for (uint32_t slot = 0; slot < SLOTS; ++slot)
+                m_wheel[level][slot].RelinkTo(started);
+        }
+
+        m_now    = service->GetTicks();
+        m_daemon = service->GetCurrentTask();
+
+        while (!started.IsEmpty())
+        {
+            Timer *timer = (* started.PopFront());
+
+            // overdue timer expires on the next tick
+            if (timer->m_expires <= m_now)
+                timer->m_expires = m_now + 1;
+
+            Link(timer);
+        }
+
+        service->ExitCriticalSection();
+    }
+
+    int64_t GetWakeTicks(IKernelService *service)
+    {
+        service->EnterCriticalSection();
+
+        m_wake = GetNextEvent();
+        int64_t wake = m_wake;
+
+        service->ExitCriticalSection();
+
+        // missed tick is processed without waiting, INT64_MAX is WAIT_DEADLINE_INFINITE (no timer is started)
+        return wake;
+    }
+
+    int64_t GetNextEvent() const
+    {
+        int64_t next = INT64_MAX;
+
+        // level 0 holds timers expiring within the next SLOTS ticks
+        for (uint32_t i = 1; i <= SLOTS; ++i)
+        {
+            if (!m_wheel[0][GetSlot(m_now + i, 0)].IsEmpty())
+            {
+                next = m_now + i;
+                break;
+            }
+        }
+
+        // timers of the higher level are reached on its next cascade
+        for (uint32_t level = 1; level < LEVELS; ++level)
+        {
+            for (uint32_t slot = 0; slot < SLOTS; ++slot)
+            {
+                if (!m_wheel[level][slot].IsEmpty())
+                {
+                    const uint32_t shift = _SlotBits * level;
+                    int64_t cascade = ((m_now >> shift) + 1) << shift;
+
+                    if (cascade < next)
+                        next = cascade;
+                    break;
+                }
+            }
+        }
+
+        return next;
+    }
+
+    ITask *GetDaemonToWake(const Timer *timer) const
+    {
+        // daemon waits for a later event (or has not computed it yet), otherwise expiry is processed on time
+        return ((m_daemon != NULL) && (timer->m_expires < m_wake) ? m_daemon : NULL);
+    }
+
+    static __stk_forceinline uint32_t GetSlot(int64_t ticks, uint32_t level)
+    {
+        return (uint32_t)(ticks >> (_SlotBits * level)) & (SLOTS - 1);
+    }
+
+    void Link(Timer *timer)
+    {
+        // overdue timer (e.g. periodic timer which missed its periods) expires on the current tick
+        int64_t expires = (timer->m_expires > m_now ? timer->m_expires : m_now);
+        int64_t delta   = expires - m_now;
+        uint32_t level  = 0;
+
+        while ((level < (LEVELS - 1)) && (delta >= ((int64_t)1 << (_SlotBits * (level + 1)))))
+            ++level;
+
+        // delay exceeds the wheel range: place at the farthest slot and re-cascade when it is reached
+        if (delta >= ((int64_t)1 << (_SlotBits * LEVELS)))
+            expires = m_now + (((int64_t)1 << (_SlotBits * LEVELS)) - 1);
+
+        m_wheel[level][GetSlot(expires, level)].LinkBack(timer);
+    }
+
+    static void Unlink(Timer *timer)
+    {
+        if (timer->IsLinked())
+            timer->GetHead()->Unlink(timer);
+    }
+
+    void Cascade()
+    {
+        // when slot index of a lower level wraps around, window of the higher level is reached
+        for (uint32_t level = 1; (level < LEVELS) && (GetSlot(m_now, level - 1) == 0); ++level)
+        {
+            ListHeadType &slot = m_wheel[level][GetSlot(m_now, level)];
+
+            while (!slot.IsEmpty())
+                Link(*slot.PopFront());
+        }
+    }
+
+    void Expire(IKernelService *service)
+    {
+        ListHeadType &slot = m_wheel[0][GetSlot(m_now, 0)];
+
+        for (;;)
+        {
+            service->EnterCriticalSection();
+
+            if (slot.IsEmpty())
+            {
+                service->ExitCriticalSection();
+                break;
+            }
+
+            Timer *timer = (* slot.PopFront());
+
+            // periodic timer expires at the fixed rate without a drift
+            if (timer->m_period != 0)
+            {
+                timer->m_expires += timer->m_period;
+                Link(timer);
+            }
+
+            service->ExitCriticalSection();
+
+            timer->OnExpired();
+        }
+    }
+
+    ListHeadType m_wheel[LEVELS][SLOTS]; //!< timer wheel (slots of the levels)
+    int64_t      m_now;                  //!< last processed tick
+    int64_t      m_wake;                 //!< tick at which daemon task wakes up, INT64_MAX if no timer is started
+    ITask       *m_daemon;               //!< daemon task (NULL if TimerHost is not added to the Kernel or not started)
+
+    // If hit here: wheel range must fit into 32 bits.
+    STK_STATIC_ASSERT_N(TIMER_WHEEL_CONFIG, (_SlotBits != 0) && (_Levels != 0) && ((_SlotBits * _Levels) < 32));
+};
+
+/*! \class PeriodicTimer
+    \brief Release timer of the soft periodic task: task sleeps until its next release which is advanced by the period
+           from the previous release (see IKernelService::SleepUntil), therefore the loop does not drift by the
+           execution time of the task's work.
+
+    If work took longer than the period (overrun) task is released immediately, the releases which elapsed while
+    task was working are skipped to keep the phase of the subsequent releases.
+
+    \note  Unsupported for HRT tasks (see stk::KERNEL_HRT), they are released by the Kernel according their periodicity.
+
+    Usage example:
+    \code
+    stk::PeriodicTimer timer(10); // release every 10 ticks
+
+    timer.Start();
+    for (;;)
+    {
+        DoWork();
+
+        if (timer.Wait() != 0)
+            ReportOverrun();
+    }
+    \endcode
+*/
+class PeriodicTimer
+{
+public:
+    /*! \brief     Constructor.
+        \param[in] period_tc: Periodicity of the releases (ticks).
+    */
+    explicit PeriodicTimer(uint32_t period_tc) : m_period(period_tc), m_next(0), m_overruns(0)
+    {
+        STK_ASSERT(period_tc != 0);
+    }
+
+    /*! \brief     Start timer: the first release is one period after the call.
+    */
+    void Start() { Start(GetKernelService()->GetTicks() + m_period); }
+
+    /*! \brief     Start timer with the first release at the absolute tick (e.g. to align phases of the tasks).
+        \param[in] release: Tick of the first release (see IKernelService::GetTicks).
+    */
+    void Start(int64_t release)
+    {
+        m_next     = release;
+        m_overruns = 0;
+    }
+
+    /*! \brief     Sleep until the next release.
+        \return    0 if task is released on time, otherwise number of the missed releases which elapsed before the
+                   call (task is released immediately).
+    */
+    uint32_t Wait()
+    {
+        IKernelService *service = GetKernelService();
+
+        int64_t late = service->GetTicks() - m_next;
+        if (late <= 0)
+        {
+            service->SleepUntil(m_next);
+            m_next += m_period;
+            return 0;
+        }
+
+        uint32_t missed = (uint32_t)(late / m_period) + 1;
+
+        m_next     += (int64_t)missed * m_period;
+        m_overruns += missed;
+
+        return missed;
+    }
+
+    /*! \brief     Get tick of the next release.
+    */
+    int64_t GetNextRelease() const { return m_next; }
+
+    /*! \brief     Get periodicity of the releases (ticks).
+    */
+    uint32_t GetPeriod() const { return m_period; }
+
+    /*! \brief     Get total number of the missed releases since Start.
+    */
+    uint32_t GetOverruns() const { return m_overruns; }
+
+private:
+    uint32_t m_period;   //!< periodicity of the releases (ticks)
+    int64_t  m_next;     //!< tick of the next release
+    uint32_t m_overruns; //!< number of the missed releases since Start
+};
+
+} // namespace stk
+
+#endif /* STK_TIMER_H_ */
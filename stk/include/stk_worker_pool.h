@@ -0,0 +1,335 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_WORKER_POOL_H_
+#define STK_WORKER_POOL_H_
+
+#include "stk_helper.h"
+
+/*! \file  stk_worker_pool.h
+    \brief Contains worker pool with a fork-join job API.
+*/
+
+namespace stk {
+
+/*! \typedef JobFuncType
+    \brief   Job prototype (see WorkerPool::Submit).
+*/
+typedef void (*JobFuncType) (void *arg);
+
+/*! \class JobGroup
+    \brief Group of jobs submitted to the WorkerPool which can be joined by a task (see Join).
+
+    JobGroup is owned by the caller and is a handle of the submitted jobs, a single job is joined with a group
+    of one job. Group can be reused when all its jobs are completed.
+
+    \note  JobGroup must stay valid while it has pending jobs (see GetPending).
+*/
+class JobGroup
+{
+    template <uint32_t _Workers, uint32_t _Capacity, uint32_t _StackSize> friend class WorkerPool;
+
+public:
+    explicit JobGroup() : m_pending(0), m_waiter(NULL) {}
+
+    /*! \brief     Wait until all jobs of the group are completed.
+        \note      Caller task is not scheduled while waiting (see IKernelService::Wait).
+        \param[in] timeout_ms: Timeout (milliseconds), WAIT_INFINITE to wait without a timeout.
+        \return    True if all jobs are completed, false if timeout expired.
+    */
+    bool Join(uint32_t timeout_ms = WAIT_INFINITE)
+    {
+        IKernelService *service = GetKernelService();
+
+        ITask *caller = service->GetCurrentTask();
+        STK_ASSERT(caller != NULL);
+
+        int64_t deadline = GetWaitDeadline(service, timeout_ms);
+
+        service->EnterCriticalSection();
+
+        while (m_pending != 0)
+        {
+            // completion of a job which leaves other jobs pending (or a stale notification) must not extend the timeout
+            if (service->GetTicks() >= deadline)
+                break;
+
+            // only one task can join the group
+            STK_ASSERT((m_waiter == NULL) || (m_waiter == caller));
+            m_waiter = caller;
+
+            service->ExitCriticalSection();
+
+            // job completed before the wait leaves a pending notification
+            bool notified = service->WaitUntil(deadline);
+
+            service->EnterCriticalSection();
+
+            if (!notified)
+                break;
+        }
+
+        m_waiter = NULL;
+        bool done = (m_pending == 0);
+
+        service->ExitCriticalSection();
+        return done;
+    }
+
+    /*! \brief     Get number of jobs which are not completed yet.
+    */
+    uint32_t GetPending() const { return m_pending; }
+
+    /*! \brief     Check if all jobs of the group are completed.
+    */
+    bool IsDone() const { return (m_pending == 0); }
+
+private:
+    volatile uint32_t m_pending; //!< number of jobs which are not completed yet
+    ITask *volatile   m_waiter;  //!< task which joins the group, NULL if none
+};
+
+/*! \class WorkerPool
+    \brief Fixed pool of _Workers worker tasks executing short jobs submitted to a job queue.
+
+    Submitting a job to the pool costs O(1) and avoids creation of a new task (stack initialization and task slot
+    allocation of the KERNEL_DYNAMIC mode), job starts as soon as an idle worker is scheduled. Jobs are kept in a ring
+    buffer of _Capacity entries and are taken by the workers in the order of submission.
+
+    Workers must be added to the Kernel (soft real-time mode, see GetWorker), idle worker waits for a notification
+    (see IKernelService::Wait) and is not scheduled until a job is submitted.
+
+    \note  Submit is protected with a critical section (see IKernelService::EnterCriticalSection) and can be called
+           from an ISR and from a job.
+
+    Usage example:
+    \code
+    static stk::WorkerPool<2> g_Pool;
+
+    static void Compute(void *arg) { // do some work here ... }
+
+    for (uint32_t i = 0; i < g_Pool.GetWorkerCount(); ++i)
+        kernel.AddTask(g_Pool.GetWorker(i));
+
+    // fork
+    stk::JobGroup group;
+    g_Pool.Submit(&Compute, &part1, &group);
+    g_Pool.Submit(&Compute, &part2, &group);
+
+    // join
+    group.Join();
+    \endcode
+*/
+template <uint32_t _Workers = 2, uint32_t _Capacity = 16, uint32_t _StackSize = 256>
+class WorkerPool
+{
+public:
+    enum EConsts
+    {
+        WORKERS  = _Workers, //!< number of worker tasks
+        CAPACITY = _Capacity //!< maximum number of pending jobs
+    };
+
+    explicit WorkerPool() : m_head(0), m_size(0), m_idle_count(0)
+    {
+        for (uint32_t i = 0; i < WORKERS; ++i)
+            m_workers[i].m_pool = this;
+    }
+
+    /*! \brief     Get worker task.
+        \param[in] index: Index of the worker, must be less than GetWorkerCount.
+    */
+    ITask *GetWorker(uint32_t index)
+    {
+        STK_ASSERT(index < WORKERS);
+        return &m_workers[index];
+    }
+
+    /*! \brief     Get number of worker tasks.
+    */
+    uint32_t GetWorkerCount() const { return WORKERS; }
+
+    /*! \brief     Submit job.
+        \param[in] func: Function to call.
+        \param[in] arg: Argument of the function.
+        \param[in] group: Group of the job (see JobGroup::Join), NULL if job is not joined.
+        \return    True if submitted, false if job queue is full.
+    */
+    bool Submit(JobFuncType func, void *arg, JobGroup *group = NULL)
+    {
+        STK_ASSERT(func != NULL);
+
+        IKernelService *service = GetKernelService();
+        service->EnterCriticalSection();
+
+        if (m_size == CAPACITY)
+        {
+            service->ExitCriticalSection();
+            return false;
+        }
+
+        Job &job = m_jobs[(m_head + m_size) % CAPACITY];
+        job.func  = func;
+        job.arg   = arg;
+        job.group = group;
+
+        ++m_size;
+
+        if (group != NULL)
+            ++group->m_pending;
+
+        // wake one idle worker up, busy workers take the job when they complete the current one
+        Worker *worker = NULL;
+        if (m_idle_count != 0)
+        {
+            worker = m_idle[--m_idle_count];
+            worker->m_idle = false;
+        }
+
+        service->ExitCriticalSection();
+
+        if (worker != NULL)
+            service->Notify(worker);
+
+        return true;
+    }
+
+    /*! \brief     Execute all pending jobs in the context of the caller.
+        \note      Called by the workers, can be called by the user if workers are not added to the Kernel.
+        \return    Number of executed jobs.
+    */
+    uint32_t Process()
+    {
+        IKernelService *service = GetKernelService();
+        uint32_t count = 0;
+        Job job;
+
+        while (Pop(service, job, NULL))
+        {
+            Execute(service, job);
+            ++count;
+        }
+
+        return count;
+    }
+
+    /*! \brief     Get number of jobs which are not taken by the workers yet.
+    */
+    uint32_t GetSize() const { return m_size; }
+
+    /*! \brief     Get number of workers waiting for a job.
+    */
+    uint32_t GetIdleCount() const { return m_idle_count; }
+
+private:
+    /*! \class Job
+        \brief Submitted job.
+    */
+    struct Job
+    {
+        JobFuncType func;  //!< function
+        void       *arg;   //!< argument
+        JobGroup   *group; //!< group, NULL if none
+    };
+
+    /*! \class Worker
+        \brief Worker task.
+    */
+    class Worker : public Task<_StackSize, ACCESS_PRIVILEGED>
+    {
+        friend class WorkerPool;
+
+    public:
+        explicit Worker() : m_pool(NULL), m_idle(false) {}
+
+        RunFuncType GetFunc() { return &Run; }
+        void *GetFuncUserData() { return this; }
+
+    private:
+        static void Run(void *user_data)
+        {
+            Worker *worker = static_cast<Worker *>(user_data);
+            WorkerPool *pool = worker->m_pool;
+            IKernelService *service = GetKernelService();
+            Job job;
+
+            for (;;)
+            {
+                if (pool->Pop(service, job, worker))
+                    pool->Execute(service, job);
+                else
+                    service->Wait(WAIT_INFINITE);
+            }
+        }
+
+        WorkerPool *m_pool; //!< owner
+        bool        m_idle; //!< true if worker is in the list of the idle workers
+    };
+
+    bool Pop(IKernelService *service, Job &job, Worker *worker)
+    {
+        service->EnterCriticalSection();
+
+        if (m_size == 0)
+        {
+            // worker waits for the job, Submit notifies it
+            if ((worker != NULL) && !worker->m_idle)
+            {
+                worker->m_idle = true;
+                m_idle[m_idle_count++] = worker;
+            }
+
+            service->ExitCriticalSection();
+            return false;
+        }
+
+        job = m_jobs[m_head];
+        m_head = (m_head + 1) % CAPACITY;
+        --m_size;
+
+        service->ExitCriticalSection();
+        return true;
+    }
+
+    static void Execute(IKernelService *service, const Job &job)
+    {
+        job.func(job.arg);
+
+        if (job.group == NULL)
+            return;
+
+        service->EnterCriticalSection();
+
+        ITask *waiter = NULL;
+        if (--job.group->m_pending == 0)
+        {
+            waiter = job.group->m_waiter;
+            job.group->m_waiter = NULL;
+        }
+
+        service->ExitCriticalSection();
+
+        if (waiter != NULL)
+            service->Notify(waiter);
+    }
+
+    Worker            m_workers[WORKERS]; //!< worker tasks
+    Worker           *m_idle[WORKERS];    //!< workers waiting for a job
+    Job               m_jobs[CAPACITY];   //!< ring buffer of the pending jobs
+    uint32_t          m_head;             //!< index of the oldest pending job
+    volatile uint32_t m_size;             //!< number of pending jobs
+    uint32_t          m_idle_count;       //!< number of workers waiting for a job
+
+    // If hit here: number of workers and capacity must not be 0.
+    STK_STATIC_ASSERT_N(WORKER_POOL_CONFIG, (_Workers != 0) && (_Capacity != 0));
+};
+
+} // namespace stk
+
+#endif /* STK_WORKER_POOL_H_ */
@@ -0,0 +1,408 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_STRATEGY_CYCLIC_H_
+#define STK_STRATEGY_CYCLIC_H_
+
+#include "stk_common.h"
+
+/*! \file  stk_strategy_cyclic.h
+    \brief Contains compile-time generator of the static cyclic schedule and its switching strategy.
+*/
+
+namespace stk {
+namespace util {
+
+/*! \brief     Greatest common divisor (compile-time).
+*/
+static constexpr uint32_t Gcd(uint32_t a, uint32_t b) { return (b == 0 ? a : Gcd(b, a % b)); }
+
+/*! \brief     Least common multiple (compile-time).
+*/
+static constexpr uint32_t Lcm(uint32_t a, uint32_t b) { return (a / Gcd(a, b)) * b; }
+
+/*! \class IndexSeq
+    \brief Compile-time sequence of indexes.
+*/
+template <uint32_t... _Index> struct IndexSeq { typedef IndexSeq Type; };
+
+/*! \class IndexSeqConcat
+    \brief Concatenates two index sequences where the second one continues the first one.
+*/
+template <class _Seq1, class _Seq2> struct IndexSeqConcat;
+template <uint32_t... _Index1, uint32_t... _Index2> struct IndexSeqConcat<IndexSeq<_Index1...>, IndexSeq<_Index2...> >
+{
+    typedef IndexSeq<_Index1..., (sizeof...(_Index1) + _Index2)...> Type;
+};
+
+/*! \class MakeIndexSeq
+    \brief Makes index sequence 0, 1, ..., _Count - 1 (instantiation depth is logarithmic).
+*/
+template <uint32_t _Count> struct MakeIndexSeq :
+    IndexSeqConcat<typename MakeIndexSeq<_Count / 2>::Type, typename MakeIndexSeq<_Count - _Count / 2>::Type> {};
+template <> struct MakeIndexSeq<0> { typedef IndexSeq<> Type; };
+template <> struct MakeIndexSeq<1> { typedef IndexSeq<0> Type; };
+
+} // namespace util
+
+/*! \class CyclicTask
+    \brief Descriptor of the periodic task of the static cyclic schedule (see CyclicSchedule).
+    \note  Job of the task is released every _Periodicity ticks (first release is at _Offset) and
+           occupies time window of _Wcet ticks which must be placed within [release, release + _Deadline).
+*/
+template <uint32_t _Periodicity, uint32_t _Wcet, uint32_t _Deadline, uint32_t _Offset = 0>
+struct CyclicTask
+{
+    enum EConsts
+    {
+        PERIODICITY = _Periodicity, //!< periodicity (ticks)
+        WCET        = _Wcet,        //!< worst-case execution time budget (ticks)
+        DEADLINE    = _Deadline,    //!< deadline relative to the release of the job (ticks)
+        OFFSET      = _Offset       //!< offset of the first release (ticks)
+    };
+
+    // If hit here: periodicity and WCET must not be 0, WCET must fit into the deadline and deadline into periodicity.
+    STK_STATIC_ASSERT_N(CYCLIC_TASK_INVALID, (_Periodicity != 0) && (_Wcet != 0) && (_Wcet <= _Deadline) &&
+        (_Deadline <= _Periodicity));
+};
+
+/*! \class CyclicWindow
+    \brief Time window of the jobs of CyclicTask which starts _Shift ticks after the release of the job.
+*/
+template <class _Task, uint32_t _Shift>
+struct CyclicWindow
+{
+    enum EConsts
+    {
+        PERIODICITY = _Task::PERIODICITY,     //!< periodicity (ticks)
+        WCET        = _Task::WCET,            //!< length of the window (ticks)
+        SHIFT       = _Shift,                 //!< start of the window relative to the release of the job (ticks)
+        START       = _Task::OFFSET + _Shift  //!< start of the first window (ticks)
+    };
+
+    /*! \brief     Check if tick belongs to the window (compile-time).
+        \param[in] tick: Tick within hyperperiod.
+    */
+    static constexpr bool IsOwnerOf(uint32_t tick)
+    {
+        return ((tick + PERIODICITY - (START % PERIODICITY)) % PERIODICITY) < WCET;
+    }
+
+    /*! \brief     Check if windows never overlap with the windows of another task (compile-time).
+        \note      Difference between the start times of both windows takes all values congruent to
+                   (start2 - start1) modulo gcd(periodicity1, periodicity2), therefore windows are disjoint
+                   if this residue leaves room for both windows.
+        \param[in] periodicity: Periodicity of another task.
+        \param[in] start: Start of the first window of another task.
+        \param[in] wcet: Length of the window of another task.
+    */
+    static constexpr bool IsDisjointWith(uint32_t periodicity, uint32_t start, uint32_t wcet)
+    {
+        return IsDisjointStart(util::Gcd(PERIODICITY, periodicity), start, wcet);
+    }
+
+    // If hit here: window does not fit into the deadline of the job.
+    STK_STATIC_ASSERT_N(CYCLIC_WINDOW_INVALID, (_Shift + _Task::WCET) <= _Task::DEADLINE);
+
+private:
+    static constexpr bool IsDisjointStart(uint32_t gcd, uint32_t start, uint32_t wcet)
+    {
+        return IsDisjointResidue(gcd, ((start % gcd) + gcd - (START % gcd)) % gcd, wcet);
+    }
+
+    static constexpr bool IsDisjointResidue(uint32_t gcd, uint32_t residue, uint32_t wcet)
+    {
+        return (residue >= WCET) && ((residue + wcet) <= gcd);
+    }
+};
+
+/*! \class CyclicWindowList
+    \brief Compile-time recursion over the list of CyclicWindow.
+*/
+template <class... _Windows> struct CyclicWindowList
+{
+    enum EConsts { HYPERPERIOD = 1 };
+
+    static constexpr uint8_t GetOwner(uint32_t, uint8_t index) { return index; }
+    static constexpr bool IsDisjointWith(uint32_t, uint32_t, uint32_t) { return true; }
+    static constexpr bool IsFeasible() { return true; }
+    static constexpr uint32_t GetShift(uint32_t) { return 0; }
+};
+template <class _Window, class... _Rest> struct CyclicWindowList<_Window, _Rest...>
+{
+    typedef CyclicWindowList<_Rest...> Rest;
+
+    enum EConsts { HYPERPERIOD = util::Lcm(_Window::PERIODICITY, Rest::HYPERPERIOD) };
+
+    /*! \brief     Get index of the window owning the tick, index of the list end if tick is idle.
+    */
+    static constexpr uint8_t GetOwner(uint32_t tick, uint8_t index)
+    {
+        return (_Window::IsOwnerOf(tick) ? index : Rest::GetOwner(tick, index + 1));
+    }
+
+    /*! \brief     Check that all listed windows are disjoint with the windows of another task.
+    */
+    static constexpr bool IsDisjointWith(uint32_t periodicity, uint32_t start, uint32_t wcet)
+    {
+        return _Window::IsDisjointWith(periodicity, start, wcet) && Rest::IsDisjointWith(periodicity, start, wcet);
+    }
+
+    /*! \brief     Check that all listed windows are pairwise disjoint.
+    */
+    static constexpr bool IsFeasible()
+    {
+        return Rest::IsDisjointWith(_Window::PERIODICITY, _Window::START, _Window::WCET) && Rest::IsFeasible();
+    }
+
+    /*! \brief     Get shift of the window relative to the release of the job.
+    */
+    static constexpr uint32_t GetShift(uint32_t index)
+    {
+        return (index == 0 ? (uint32_t)_Window::SHIFT : Rest::GetShift(index - 1));
+    }
+};
+
+/*! \class CyclicShift
+    \brief Finds the earliest shift of the window of _Task within its deadline which is disjoint with all windows
+           of _Placed list, falls back to 0 if there is none (then CyclicWindowList::IsFeasible fails).
+    \note  Recursion depth is bounded by (deadline - WCET) of the task.
+*/
+template <class _Placed, class _Task> struct CyclicShift
+{
+    static constexpr uint32_t Find(uint32_t shift)
+    {
+        return ((shift + _Task::WCET) > _Task::DEADLINE ? 0 :
+            (_Placed::IsDisjointWith(_Task::PERIODICITY, _Task::OFFSET + shift, _Task::WCET) ? shift :
+                Find(shift + 1)));
+    }
+};
+
+/*! \class CyclicPlacement
+    \brief Places windows of the tasks one by one in the order of descriptors (first-fit), Type is the resulting
+           CyclicWindowList.
+    \note  All jobs of the task share the same shift, therefore the task keeps the strictly periodic release
+           pattern of the HRT task of the Kernel.
+*/
+template <class _Placed, class... _Tasks> struct CyclicPlacement { typedef _Placed Type; };
+template <class... _Windows, class _Task, class... _Rest>
+struct CyclicPlacement<CyclicWindowList<_Windows...>, _Task, _Rest...>
+{
+    typedef CyclicWindowList<_Windows...> Placed;
+    typedef CyclicWindow<_Task, CyclicShift<Placed, _Task>::Find(0)> Window;
+
+    typedef typename CyclicPlacement<CyclicWindowList<_Windows..., Window>, _Rest...>::Type Type;
+};
+
+/*! \class CyclicTaskList
+    \brief List of CyclicTask descriptors with windows of their jobs placed within the deadlines.
+*/
+template <class... _Tasks> struct CyclicTaskList
+{
+    /*! \typedef Windows
+        \brief   Placed windows of the tasks (see CyclicPlacement).
+    */
+    typedef typename CyclicPlacement<CyclicWindowList<>, _Tasks...>::Type Windows;
+
+    enum EConsts { HYPERPERIOD = Windows::HYPERPERIOD };
+
+    /*! \brief     Get index of the task owning the tick, index of the list end if tick is idle.
+    */
+    static constexpr uint8_t GetOwner(uint32_t tick, uint8_t index) { return Windows::GetOwner(tick, index); }
+
+    /*! \brief     Check that job windows of all listed tasks fit into their deadlines and are pairwise disjoint.
+    */
+    static constexpr bool IsFeasible() { return Windows::IsFeasible(); }
+
+    /*! \brief     Get shift of the job window of the task relative to the release of the job (ticks).
+        \param[in] index: Index of the task descriptor.
+    */
+    static constexpr uint32_t GetShift(uint32_t index) { return Windows::GetShift(index); }
+};
+
+/*! \class CyclicScheduleTable
+    \brief Static dispatch table of the cyclic schedule (one entry per tick of the hyperperiod).
+    \note  Table is generated at compile-time and placed into the read-only memory.
+*/
+template <class _TyTaskList, class _Seq> struct CyclicScheduleTable;
+template <class _TyTaskList, uint32_t... _Tick> struct CyclicScheduleTable<_TyTaskList, util::IndexSeq<_Tick...> >
+{
+    static const uint8_t SLOT[sizeof...(_Tick)]; //!< index of the task owning the tick
+};
+template <class _TyTaskList, uint32_t... _Tick>
+const uint8_t CyclicScheduleTable<_TyTaskList, util::IndexSeq<_Tick...> >::SLOT[sizeof...(_Tick)] = {
+    _TyTaskList::GetOwner(_Tick, 0)... };
+
+/*! \class CyclicSchedule
+    \brief Static cyclic schedule of the periodic HRT tasks generated at compile-time.
+    \note  Hyperperiod and dispatch table are computed by the compiler, window of the jobs of each task is placed
+           at the earliest shift from the release which fits into the deadline and does not overlap with the windows
+           of the preceding descriptors (see CyclicPlacement), task set which can not be placed fails compilation.
+    \note  Job which did not complete within its window is switched out at the end of the window and reported as
+           missed deadline (see ITask::OnDeadlineMissed, ITask::GetDeadlineMissPolicy).
+
+    Usage example:
+    \code
+    //                     periodicity  WCET  deadline  offset
+    typedef CyclicSchedule<CyclicTask<10,    2,    5,        0>,
+                           CyclicTask<20,    3,    10,       2>,
+                           CyclicTask<40,    4,    20,       5> > Schedule;
+
+    static Kernel<KERNEL_STATIC | KERNEL_HRT, Schedule::TASKS, SwitchStrategyCyclic<Schedule>, PlatformDefault> kernel;
+
+    kernel.Initialize();
+
+    // tasks must be added in the order of descriptors
+    Schedule::AddTask(&kernel, 0, &task1);
+    Schedule::AddTask(&kernel, 1, &task2);
+    Schedule::AddTask(&kernel, 2, &task3);
+
+    kernel.Start();
+    \endcode
+*/
+template <class... _Tasks>
+class CyclicSchedule
+{
+    typedef CyclicTaskList<_Tasks...> TaskList;
+
+public:
+    enum EConsts
+    {
+        TASKS       = sizeof...(_Tasks),      //!< number of tasks
+        HYPERPERIOD = TaskList::HYPERPERIOD,  //!< hyperperiod (ticks), also a number of entries in the dispatch table
+        SLOT_IDLE   = TASKS                   //!< value of the dispatch table entry which has no task
+    };
+
+    /*! \typedef Table
+        \brief   Dispatch table type.
+    */
+    typedef CyclicScheduleTable<TaskList, typename util::MakeIndexSeq<HYPERPERIOD>::Type> Table;
+
+    /*! \brief     Get index of the task owning the tick of the hyperperiod (or SLOT_IDLE).
+        \param[in] tick: Tick within hyperperiod.
+    */
+    static __stk_forceinline uint8_t GetSlot(uint32_t tick) { return Table::SLOT[tick]; }
+
+    /*! \brief     Get shift of the job window of the task relative to the release of the job (ticks).
+        \param[in] index: Index of the task descriptor.
+    */
+    static uint32_t GetShift(uint32_t index) { return TaskList::GetShift(index); }
+
+    /*! \brief     Add user task to the kernel with the parameters of the descriptor.
+        \note      Task is started at the beginning of its job window, deadline is shortened by the shift of the
+                   window, therefore deadline of the job stays the same relative to its release.
+        \param[in] kernel: Kernel (must be in stk::KERNEL_HRT mode).
+        \param[in] index: Index of the task descriptor.
+        \param[in] user_task: User task.
+    */
+    static void AddTask(IKernel *kernel, uint32_t index, ITask *user_task)
+    {
+        static const uint32_t desc[TASKS][4] = { { _Tasks::PERIODICITY, _Tasks::DEADLINE, _Tasks::OFFSET, _Tasks::WCET }... };
+
+        STK_ASSERT(index < TASKS);
+
+        uint32_t shift = GetShift(index);
+
+        kernel->AddTask(user_task, desc[index][0], desc[index][1] - shift, desc[index][2] + shift, desc[index][3]);
+    }
+
+    // If hit here: dispatch table supports up to 254 tasks.
+    STK_STATIC_ASSERT_N(CYCLIC_SCHEDULE_TASKS, (TASKS > 0) && (TASKS < 0xFF));
+
+    // If hit here: task set is infeasible, job window of some task can not be placed within its deadline.
+    STK_STATIC_ASSERT_N(CYCLIC_SCHEDULE_INFEASIBLE, TaskList::IsFeasible());
+};
+
+/*! \class SwitchStrategyCyclic
+    \brief Tasks switching strategy concrete implementation - static Cyclic Executive.
+
+    Cyclic Executive: tasks are dispatched according the static dispatch table of CyclicSchedule, the
+    next task is found with a single lookup into the table by the current tick of the hyperperiod.
+
+    \note  Tasks must be added in the order of the descriptors of CyclicSchedule (see CyclicSchedule::AddTask).
+    \note  Scheduling policy is stk::SCHED_POLICY_NONE because feasibility of the schedule is checked at compile-time.
+*/
+template <class _TySchedule>
+class SwitchStrategyCyclic : public ITaskSwitchStrategy
+{
+public:
+    enum EConfig
+    {
+        WINDOWED = 1 //!< HRT job owns fixed time window (see ITaskSwitchStrategy::EConfig)
+    };
+
+    explicit SwitchStrategyCyclic() : m_tasks(), m_tick(0)
+    {
+        for (uint32_t i = 0; i <= _TySchedule::TASKS; ++i)
+            m_slot[i] = NULL;
+    }
+
+    void AddTask(IKernelTask *task)
+    {
+        // bind to the first free descriptor
+        for (uint32_t i = 0; i < _TySchedule::TASKS; ++i)
+        {
+            if (m_slot[i] == NULL)
+            {
+                m_slot[i] = task;
+                m_tasks.LinkBack(task);
+                return;
+            }
+        }
+
+        // if hit here: more tasks than descriptors in the schedule
+        STK_ASSERT(false);
+    }
+
+    void RemoveTask(IKernelTask *task)
+    {
+        for (uint32_t i = 0; i < _TySchedule::TASKS; ++i)
+        {
+            if (m_slot[i] == task)
+                m_slot[i] = NULL;
+        }
+
+        m_tasks.Unlink(task);
+    }
+
+    IKernelTask *GetNext(IKernelTask *current)
+    {
+        (void)current;
+
+        // note: idle entry references NULL in m_slot[_TySchedule::TASKS]
+        return m_slot[_TySchedule::GetSlot(m_tick)];
+    }
+
+    IKernelTask *GetFirst()
+    {
+        STK_ASSERT(m_tasks.GetSize() != 0);
+        return (* m_tasks.GetFirst());
+    }
+
+    size_t GetSize() const { return m_tasks.GetSize(); }
+
+    void OnTick(int64_t ticks) { m_tick = (uint32_t)(ticks % _TySchedule::HYPERPERIOD); }
+
+    void OnTaskSleep(IKernelTask *task) { (void)task; }
+
+    void OnTaskWake(IKernelTask *task) { (void)task; }
+
+    /*! \brief     Get current tick within the hyperperiod.
+    */
+    uint32_t GetTick() const { return m_tick; }
+
+private:
+    IKernelTask::ListHeadType m_tasks;                         //!< tasks for scheduling
+    IKernelTask              *m_slot[_TySchedule::TASKS + 1]; //!< tasks bound to the descriptors (last one is idle and always NULL)
+    uint32_t                  m_tick;                          //!< current tick within hyperperiod
+};
+
+} // namespace stk
+
+#endif /* STK_STRATEGY_CYCLIC_H_ */
@@ -0,0 +1,299 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_STRATEGY_MLFQ_H_
+#define STK_STRATEGY_MLFQ_H_
+
+#include "stk_common.h"
+
+/*! \file  stk_strategy_mlfq.h
+    \brief Contains Multilevel Feedback Queue task switching strategy.
+*/
+
+namespace stk {
+
+/*! \class SwitchStrategyMlfq
+    \brief Tasks switching strategy concrete implementation - Multilevel Feedback Queue (MLFQ).
+
+    MLFQ: tasks are placed into _Levels priority levels (0 is the highest), time quantum of the level i is 2^i ticks.
+    New task starts at the highest level. Task which used its whole quantum is demoted to the lower level, task which
+    went to sleep before the quantum expired (e.g. waits for I/O) is promoted to the higher level, therefore
+    interactive tasks stay at the higher levels and preempt CPU-bound tasks as soon as they wake up without any manual
+    priority assignment. All tasks are boosted to the highest level every _BoostPeriod ticks to prevent starvation.
+    Tasks within the same level are scheduled with Round-Robin.
+
+    Sleeping tasks are moved to the separate lists of their levels when they go to sleep and back when they wake up
+    (see ITaskSwitchStrategy::OnTaskSleep), therefore bitmap of the levels which have ready tasks is always exact and
+    the next task is selected with a single count-trailing-zeros operation (see GetLowestBit).
+
+    Usage example:
+    \code
+    static Kernel<KERNEL_DYNAMIC, 4, SwitchStrategyMlfq<4, 100>, PlatformDefault> kernel;
+    \endcode
+*/
+template <uint32_t _Levels = 4, uint32_t _BoostPeriod = 100>
+class SwitchStrategyMlfq : public ITaskSwitchStrategy
+{
+public:
+    enum EConsts
+    {
+        LEVELS       = _Levels,     //!< number of priority levels
+        BOOST_PERIOD = _BoostPeriod //!< periodicity of the priority boost (ticks)
+    };
+
+    explicit SwitchStrategyMlfq() : m_size(0), m_ready(0), m_active(NULL), m_cursor(NULL), m_quantum_left(0),
+        m_boost_left(_BoostPeriod), m_fetched(false)
+    {}
+
+    void AddTask(IKernelTask *task)
+    {
+        Link(task, 0, task->IsSleeping());
+        ++m_size;
+    }
+
+    void RemoveTask(IKernelTask *task)
+    {
+        Unlink(task);
+        --m_size;
+
+        if (m_active == task)
+            m_active = NULL;
+
+        if (m_cursor == task)
+            m_cursor = NULL;
+    }
+
+    IKernelTask *GetNext(IKernelTask *current)
+    {
+        STK_ASSERT(m_size != 0);
+
+        // repeated call within the same tick means that Kernel did not accept returned task (e.g. it is pending
+        // removal), continue iteration over all tasks to let Kernel complete it
+        if (m_fetched && (current == m_cursor))
+            return Activate(GetFollowing(current));
+
+        if (!m_fetched)
+        {
+            m_fetched = true;
+
+            // account the running task
+            if (current == m_active)
+            {
+                uint32_t level = GetTaskLevel(current);
+
+                if (current->IsSleeping())
+                {
+                    // gave up CPU before quantum expired
+                    MoveTo(current, (level != 0 ? level - 1 : 0));
+                }
+                else
+                if (m_quantum_left == 0)
+                {
+                    // used whole quantum
+                    MoveTo(current, (level + 1 < LEVELS ? level + 1 : level));
+                }
+                else
+                {
+                    // continue with the quantum unless task of a higher level is ready
+                    IKernelTask *highest = GetHighestReady();
+                    if ((highest == NULL) || (GetTaskLevel(highest) >= level))
+                        return (m_cursor = current);
+                }
+            }
+        }
+
+        return Activate(GetHighestReady());
+    }
+
+    IKernelTask *GetFirst()
+    {
+        STK_ASSERT(m_size != 0);
+
+        IKernelTask *first = GetHighestNonEmpty();
+
+        // task which starts scheduling gets its quantum
+        if (m_active == NULL)
+        {
+            m_active       = first;
+            m_quantum_left = GetQuantum(GetTaskLevel(first));
+        }
+
+        return first;
+    }
+
+    size_t GetSize() const { return m_size; }
+
+    void OnTick(int64_t ticks)
+    {
+        (void)ticks;
+
+        if (m_quantum_left != 0)
+            --m_quantum_left;
+
+        if (--m_boost_left == 0)
+        {
+            for (uint32_t i = 1; i < LEVELS; ++i)
+            {
+                m_levels[i].RelinkTo(m_levels[0]);
+                m_levels[LEVELS + i].RelinkTo(m_levels[LEVELS]);
+            }
+
+            m_ready      = (m_levels[0].IsEmpty() ? 0 : 1);
+            m_boost_left = _BoostPeriod;
+        }
+
+        m_fetched = false;
+        m_cursor  = NULL;
+    }
+
+    void OnTaskSleep(IKernelTask *task)
+    {
+        if (!IsAsleep(task))
+        {
+            uint32_t level = GetTaskLevel(task);
+
+            Unlink(task);
+            Link(task, level, true);
+        }
+    }
+
+    void OnTaskWake(IKernelTask *task)
+    {
+        if (IsAsleep(task))
+        {
+            uint32_t level = GetTaskLevel(task);
+
+            Unlink(task);
+            Link(task, level, false);
+        }
+    }
+
+    /*! \brief     Get priority level of the task (0 is the highest).
+        \param[in] task: Task.
+    */
+    uint32_t GetTaskLevel(IKernelTask *task) const { return (GetListIndex(task) % LEVELS); }
+
+    /*! \brief     Get time quantum of the level (ticks).
+        \param[in] level: Priority level.
+    */
+    static uint32_t GetQuantum(uint32_t level) { return (1U << level); }
+
+private:
+    uint32_t GetListIndex(IKernelTask *task) const
+    {
+        STK_ASSERT(task != NULL);
+
+        uint32_t index = (uint32_t)(static_cast<const IKernelTask::ListHeadType *>(task->GetHead()) - m_levels);
+        STK_ASSERT(index < (LEVELS * 2));
+
+        return index;
+    }
+
+    bool IsAsleep(IKernelTask *task) const { return (GetListIndex(task) >= LEVELS); }
+
+    void Link(IKernelTask *task, uint32_t level, bool asleep)
+    {
+        if (asleep)
+        {
+            m_levels[LEVELS + level].LinkBack(task);
+        }
+        else
+        {
+            m_levels[level].LinkBack(task);
+            m_ready |= (1U << level);
+        }
+    }
+
+    void Unlink(IKernelTask *task)
+    {
+        uint32_t index = GetListIndex(task);
+
+        m_levels[index].Unlink(task);
+
+        if ((index < LEVELS) && m_levels[index].IsEmpty())
+            m_ready &= ~(1U << index);
+    }
+
+    IKernelTask *GetHighestNonEmpty() const
+    {
+        if (m_ready != 0)
+            return GetHighestReady();
+
+        // all tasks are sleeping
+        for (uint32_t i = LEVELS; i < (LEVELS * 2); ++i)
+        {
+            if (!m_levels[i].IsEmpty())
+                return (* m_levels[i].GetFirst());
+        }
+
+        return NULL;
+    }
+
+    __stk_forceinline IKernelTask *GetHighestReady() const
+    {
+        if (m_ready == 0)
+            return NULL;
+
+        return (* m_levels[GetLowestBit(m_ready)].GetFirst());
+    }
+
+    IKernelTask *GetFollowing(IKernelTask *task) const
+    {
+        uint32_t level = GetTaskLevel(task);
+
+        if (!IsAsleep(task) && (task != (*m_levels[level].GetLast())))
+            return (* task->GetNext());
+
+        // first ready task of the next level (wrapping around)
+        for (uint32_t i = 1; i <= LEVELS; ++i)
+        {
+            const IKernelTask::ListHeadType &tasks = m_levels[(level + i) % LEVELS];
+
+            if (!tasks.IsEmpty())
+                return (* tasks.GetFirst());
+        }
+
+        return task;
+    }
+
+    IKernelTask *Activate(IKernelTask *task)
+    {
+        if (task != NULL)
+            m_quantum_left = GetQuantum(GetTaskLevel(task));
+
+        m_active = task;
+        m_cursor = task;
+        return task;
+    }
+
+    void MoveTo(IKernelTask *task, uint32_t level)
+    {
+        // task is moved to the tail, therefore tasks of the same level are rotated
+        bool asleep = IsAsleep(task);
+
+        Unlink(task);
+        Link(task, level, asleep);
+    }
+
+    IKernelTask::ListHeadType m_levels[LEVELS * 2]; //!< ready tasks of the priority levels followed by sleeping tasks
+    size_t                    m_size;               //!< number of tasks
+    uint32_t                  m_ready;              //!< bitmap of the levels with ready tasks (bit index is level)
+    IKernelTask              *m_active;             //!< task owning the current quantum
+    IKernelTask              *m_cursor;             //!< task returned by the last GetNext call within the current tick
+    uint32_t                  m_quantum_left;       //!< time left until quantum of the active task expires (ticks)
+    uint32_t                  m_boost_left;         //!< time left until priority boost (ticks)
+    bool                      m_fetched;            //!< true if GetNext was called within the current tick
+
+    // If hit here: number of levels must be within [1, 16], boost period must not be 0.
+    STK_STATIC_ASSERT_N(MLFQ_CONFIG, (_Levels != 0) && (_Levels <= 16) && (_BoostPeriod != 0));
+};
+
+} // namespace stk
+
+#endif /* STK_STRATEGY_MLFQ_H_ */
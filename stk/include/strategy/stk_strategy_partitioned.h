@@ -0,0 +1,516 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_STRATEGY_PARTITIONED_H_
+#define STK_STRATEGY_PARTITIONED_H_
+
+#include "stk_common.h"
+
+/*! \file  stk_strategy_partitioned.h
+    \brief Contains time-partitioned (hierarchical) task switching strategy.
+*/
+
+namespace stk {
+
+/*! \enum  EPartitionConsts
+    \brief Constants of the time-partitioned scheduling.
+*/
+enum EPartitionConsts
+{
+    PARTITION_NONE = 0xFF //!< no partition (e.g. idle time of the window is not donated)
+};
+
+/*! \class Partition
+    \brief Descriptor of the partition: group of _Tasks tasks scheduled by the inner strategy _TyStrategy.
+*/
+template <class _TyStrategy, uint32_t _Tasks>
+struct Partition
+{
+    /*! \typedef StrategyType
+        \brief   Inner task switching strategy of the partition.
+    */
+    typedef _TyStrategy StrategyType;
+
+    enum EConsts
+    {
+        TASKS = _Tasks //!< maximum number of tasks in the partition
+    };
+
+    // If hit here: partition must host at least 1 task.
+    STK_STATIC_ASSERT_N(PARTITION_NO_TASKS, _Tasks != 0);
+};
+
+/*! \class PartitionWindow
+    \brief Descriptor of the time window of the major frame owned by the partition.
+    \note  If _Donee is not stk::PARTITION_NONE then idle time of the window (all tasks of the owning partition are
+           sleeping or partition has no tasks) is donated to the partition _Donee.
+*/
+template <uint32_t _Partition, uint32_t _Duration, uint32_t _Donee = PARTITION_NONE>
+struct PartitionWindow
+{
+    enum EConsts
+    {
+        PARTITION = _Partition, //!< index of the owning partition
+        DURATION  = _Duration,  //!< duration of the window (ticks)
+        DONEE     = _Donee      //!< index of the partition receiving idle time of the window
+    };
+
+    // If hit here: window must have duration and partition must not donate idle time to itself.
+    STK_STATIC_ASSERT_N(PARTITION_WINDOW_INVALID, (_Duration != 0) && (_Partition != _Donee) &&
+        (_Partition < PARTITION_NONE));
+};
+
+/*! \class PartitionFrameCheck
+    \brief Compile-time recursion over the windows of the major frame.
+*/
+template <class... _Windows> struct PartitionFrameCheck
+{
+    static constexpr bool IsValidFor(uint32_t) { return true; }
+};
+template <class _Window, class... _Rest> struct PartitionFrameCheck<_Window, _Rest...>
+{
+    static constexpr bool IsValidFor(uint32_t partitions)
+    {
+        return ((uint32_t)_Window::PARTITION < partitions) &&
+            (((uint32_t)_Window::DONEE < partitions) || ((uint32_t)_Window::DONEE == PARTITION_NONE)) &&
+            PartitionFrameCheck<_Rest...>::IsValidFor(partitions);
+    }
+};
+
+/*! \class PartitionFrame
+    \brief Major frame: cyclic sequence of the time windows (see PartitionWindow).
+*/
+template <class... _Windows>
+struct PartitionFrame
+{
+    enum EConsts
+    {
+        WINDOWS = sizeof...(_Windows) //!< number of windows
+    };
+
+    /*! \class Window
+        \brief Window entry of the frame table.
+    */
+    struct Window
+    {
+        uint8_t  partition; //!< index of the owning partition
+        uint8_t  donee;     //!< index of the partition receiving idle time, or stk::PARTITION_NONE
+        uint32_t duration;  //!< duration (ticks)
+    };
+
+    /*! \brief     Check if windows reference existing partitions only (compile-time).
+        \param[in] partitions: Number of partitions.
+    */
+    static constexpr bool IsValidFor(uint32_t partitions) { return PartitionFrameCheck<_Windows...>::IsValidFor(partitions); }
+
+    /*! \brief     Get window entry.
+        \param[in] index: Index of the window.
+    */
+    static __stk_forceinline const Window &GetWindow(uint32_t index)
+    {
+        static const Window table[WINDOWS] = { { _Windows::PARTITION, _Windows::DONEE, _Windows::DURATION }... };
+        return table[index];
+    }
+
+    // If hit here: frame must have at least 1 window.
+    STK_STATIC_ASSERT_N(PARTITION_FRAME_EMPTY, WINDOWS != 0);
+};
+
+/*! \class PartitionStorage
+    \brief Storage of the inner strategies of the partitions.
+*/
+template <class... _Partitions> struct PartitionStorage
+{
+    enum EConsts
+    {
+        TASKS = 0 //!< total capacity of the partitions
+    };
+
+    void Bind(ITaskSwitchStrategy **inner) { (void)inner; }
+};
+template <class _Partition, class... _Rest> struct PartitionStorage<_Partition, _Rest...>
+{
+    enum EConsts
+    {
+        TASKS = _Partition::TASKS + PartitionStorage<_Rest...>::TASKS //!< total capacity of the partitions
+    };
+
+    /*! \brief     Bind inner strategies to the array of interface pointers.
+    */
+    void Bind(ITaskSwitchStrategy **inner)
+    {
+        inner[0] = &strategy;
+        rest.Bind(inner + 1);
+    }
+
+    typename _Partition::StrategyType strategy; //!< inner strategy
+    PartitionStorage<_Rest...>        rest;     //!< inner strategies of the rest of the partitions
+};
+
+/*! \class SwitchStrategyPartitioned
+    \brief Tasks switching strategy concrete implementation - Time-Partitioned (ARINC-653 style).
+
+    Time-Partitioned: tasks are grouped into partitions, each partition schedules its tasks with its own inner
+    strategy. Time is divided into a major frame of fixed windows (see PartitionFrame), during a window only
+    tasks of the owning partition are scheduled, therefore partitions are temporally isolated and each of them
+    can be analyzed separately. Partition is switched with a single lookup into the frame table on a window
+    boundary.
+
+    \note  Task is bound to the partition explicitly with BindTask, otherwise it is bound to the first partition with
+           a free capacity when it is added for the first time. Binding is persistent: task returns to the same
+           partition whenever it is added again (e.g. resumed after Kernel::Suspend or restarted), call UnbindTask to
+           release the capacity of the task which is not going to be added again.
+    \note  Partition and readiness of the added task are kept in the table indexed by IKernelTask::GetIndex, and
+           number of ready tasks is counted per partition, therefore partition lookup and readiness check of the
+           partition are O(1) and any inner strategy can be used (e.g. Round-Robin in one partition and
+           Rate-Monotonic in another).
+
+    Usage example:
+    \code
+    typedef SwitchStrategyPartitioned<
+        PartitionFrame<PartitionWindow<0, 5>,      // partition 0 runs for 5 ticks
+                       PartitionWindow<1, 3, 0> >, // partition 1 runs for 3 ticks and donates its idle time to partition 0
+        Partition<SwitchStrategyRoundRobin, 2>,    // 2 tasks
+        Partition<SwitchStrategyRoundRobin, 1> >   // 1 task
+        Strategy;
+
+    static Kernel<KERNEL_STATIC, 3, Strategy, PlatformDefault> kernel;
+    \endcode
+*/
+template <class _TyFrame, class... _Partitions>
+class SwitchStrategyPartitioned : public ITaskSwitchStrategy
+{
+public:
+    enum EConsts
+    {
+        PARTITIONS = sizeof...(_Partitions),                 //!< number of partitions
+        TASKS      = PartitionStorage<_Partitions...>::TASKS //!< total capacity of the partitions
+    };
+
+    explicit SwitchStrategyPartitioned() : m_storage(), m_size(0), m_window(0), m_window_left(0)
+    {
+        m_storage.Bind(m_inner);
+
+        for (uint32_t i = 0; i < PARTITIONS; ++i)
+        {
+            m_bound[i] = 0;
+            m_ready[i] = 0;
+        }
+
+        for (uint32_t i = 0; i < TASKS; ++i)
+        {
+            m_binding[i].task      = NULL;
+            m_binding[i].partition = PARTITION_NONE;
+            m_slot[i].partition    = PARTITION_NONE;
+            m_slot[i].awake        = false;
+        }
+
+        SetWindow(0);
+    }
+
+    void AddTask(IKernelTask *task)
+    {
+        uint32_t index = task->GetIndex();
+
+        // if hit here: more tasks than total capacity of partitions
+        STK_ASSERT(index < TASKS);
+
+        uint32_t partition = GetTaskPartition(task->GetUserTask());
+
+        // bind to the first partition with a free capacity
+        if (partition == PARTITION_NONE)
+        {
+            for (uint32_t i = 0; i < PARTITIONS; ++i)
+            {
+                if (BindTask(task->GetUserTask(), i))
+                {
+                    partition = i;
+                    break;
+                }
+            }
+        }
+
+        // if hit here: more tasks than total capacity of partitions
+        STK_ASSERT(partition != PARTITION_NONE);
+
+        if ((index >= TASKS) || (partition == PARTITION_NONE))
+            return;
+
+        Slot &slot = m_slot[index];
+        slot.partition = (uint8_t)partition;
+        slot.awake     = !task->IsSleeping();
+
+        if (slot.awake)
+            ++m_ready[partition];
+
+        m_inner[partition]->AddTask(task);
+        ++m_size;
+    }
+
+    void RemoveTask(IKernelTask *task)
+    {
+        Slot &slot = GetSlot(task);
+
+        if (slot.awake)
+            --m_ready[slot.partition];
+
+        m_inner[slot.partition]->RemoveTask(task);
+        --m_size;
+
+        slot.partition = PARTITION_NONE;
+        slot.awake     = false;
+    }
+
+    IKernelTask *GetNext(IKernelTask *current)
+    {
+        ITaskSwitchStrategy *owner = m_inner[m_partition];
+        ITaskSwitchStrategy *donee = (m_donee != PARTITION_NONE ? m_inner[m_donee] : NULL);
+        uint32_t member = FindPartition(current);
+
+        // current task runs on donated time: return to the owner as soon as any of its tasks is ready
+        if ((donee != NULL) && (member == m_donee))
+        {
+            if (HasReadyTask(m_partition))
+                return owner->GetFirst();
+
+            IKernelTask *next = donee->GetNext(current);
+
+            // wrapped around, continue with the owner to let Kernel complete the iteration
+            if ((next == donee->GetFirst()) && (owner->GetSize() != 0))
+                return owner->GetFirst();
+
+            return next;
+        }
+
+        // partition was switched (current belongs to other partition)
+        if (member != m_partition)
+            return GetFirstOf(owner, donee);
+
+        IKernelTask *next = owner->GetNext(current);
+
+        // wrapped around and none of the tasks of the owner is ready: donate idle time
+        if ((donee != NULL) && (donee->GetSize() != 0) && (next == owner->GetFirst()) && !HasReadyTask(m_partition))
+            return donee->GetFirst();
+
+        return next;
+    }
+
+    IKernelTask *GetFirst()
+    {
+        STK_ASSERT(m_size != 0);
+
+        IKernelTask *first = GetFirstOf(m_inner[m_partition], NULL);
+        if (first != NULL)
+            return first;
+
+        // owner of the window has no tasks, Kernel will start from the owner's tasks on the next iteration
+        for (uint32_t i = 0; i < PARTITIONS; ++i)
+        {
+            if (m_inner[i]->GetSize() != 0)
+                return m_inner[i]->GetFirst();
+        }
+
+        return NULL;
+    }
+
+    size_t GetSize() const { return m_size; }
+
+    void OnTick(int64_t ticks)
+    {
+        // switch partition on the window boundary
+        if (--m_window_left == 0)
+            SetWindow((m_window + 1) % _TyFrame::WINDOWS);
+
+        for (uint32_t i = 0; i < PARTITIONS; ++i)
+            m_inner[i]->OnTick(ticks);
+    }
+
+    void OnTaskSleep(IKernelTask *task)
+    {
+        Slot &slot = GetSlot(task);
+
+        if (slot.awake)
+        {
+            slot.awake = false;
+            --m_ready[slot.partition];
+        }
+
+        m_inner[slot.partition]->OnTaskSleep(task);
+    }
+
+    void OnTaskWake(IKernelTask *task)
+    {
+        Slot &slot = GetSlot(task);
+
+        if (!slot.awake)
+        {
+            slot.awake = true;
+            ++m_ready[slot.partition];
+        }
+
+        m_inner[slot.partition]->OnTaskWake(task);
+    }
+
+    /*! \brief     Bind user task to the partition.
+        \note      Must be called before the task is added to the kernel, task is added to this partition whenever it
+                   is added to the strategy (see Kernel::AddTask, Kernel::Resume).
+        \param[in] task: User task.
+        \param[in] partition: Index of the partition.
+        \return    True if task is bound, false if task is already bound or partition has no free capacity.
+    */
+    bool BindTask(ITask *task, uint32_t partition)
+    {
+        STK_ASSERT(task != NULL);
+        STK_ASSERT(partition < PARTITIONS);
+
+        if ((GetTaskPartition(task) != PARTITION_NONE) || (m_bound[partition] >= GetCapacity(partition)))
+            return false;
+
+        for (uint32_t i = 0; i < TASKS; ++i)
+        {
+            if (m_binding[i].task == NULL)
+            {
+                m_binding[i].task      = task;
+                m_binding[i].partition = (uint8_t)partition;
+                ++m_bound[partition];
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*! \brief     Unbind user task from its partition and release the capacity it occupies.
+        \note      Must be called when task is not added to the kernel (e.g. after it exited or was killed).
+        \param[in] task: User task.
+    */
+    void UnbindTask(ITask *task)
+    {
+        for (uint32_t i = 0; i < TASKS; ++i)
+        {
+            if (m_binding[i].task == task)
+            {
+                --m_bound[m_binding[i].partition];
+                m_binding[i].task      = NULL;
+                m_binding[i].partition = PARTITION_NONE;
+                return;
+            }
+        }
+    }
+
+    /*! \brief     Get index of the partition the user task is bound to, or stk::PARTITION_NONE if it is not bound.
+        \param[in] task: User task.
+    */
+    uint32_t GetTaskPartition(const ITask *task) const
+    {
+        for (uint32_t i = 0; i < TASKS; ++i)
+        {
+            if (m_binding[i].task == task)
+                return m_binding[i].partition;
+        }
+
+        return PARTITION_NONE;
+    }
+
+    /*! \brief     Get index of the partition owning current window.
+    */
+    uint32_t GetPartition() const { return m_partition; }
+
+    /*! \brief     Get inner strategy of the partition.
+        \param[in] partition: Index of the partition.
+    */
+    ITaskSwitchStrategy *GetPartitionStrategy(uint32_t partition) { return m_inner[partition]; }
+
+private:
+    /*! \class Binding
+        \brief Persistent binding of the user task to the partition.
+    */
+    struct Binding
+    {
+        ITask  *task;      //!< bound user task, NULL if entry is free
+        uint8_t partition; //!< index of the partition
+    };
+
+    /*! \class Slot
+        \brief State of the added task (indexed by IKernelTask::GetIndex).
+    */
+    struct Slot
+    {
+        uint8_t partition; //!< partition of the task, stk::PARTITION_NONE if task is not added
+        bool    awake;     //!< task is accounted as ready in m_ready of its partition
+    };
+
+    static uint32_t GetCapacity(uint32_t partition)
+    {
+        static const uint32_t capacity[PARTITIONS] = { _Partitions::TASKS... };
+        return capacity[partition];
+    }
+
+    static IKernelTask *GetFirstOf(ITaskSwitchStrategy *owner, ITaskSwitchStrategy *donee)
+    {
+        if (owner->GetSize() != 0)
+            return owner->GetFirst();
+
+        if ((donee != NULL) && (donee->GetSize() != 0))
+            return donee->GetFirst();
+
+        return NULL;
+    }
+
+    __stk_forceinline Slot &GetSlot(IKernelTask *task)
+    {
+        uint32_t index = task->GetIndex();
+        STK_ASSERT((index < TASKS) && (m_slot[index].partition < PARTITIONS));
+
+        return m_slot[index];
+    }
+
+    __stk_forceinline bool HasReadyTask(uint32_t partition) const { return (m_ready[partition] != 0); }
+
+    __stk_forceinline uint32_t FindPartition(IKernelTask *task) const
+    {
+        if (task == NULL)
+            return PARTITION_NONE;
+
+        uint32_t index = task->GetIndex();
+        return (index < TASKS ? m_slot[index].partition : PARTITION_NONE);
+    }
+
+    void SetWindow(uint32_t window)
+    {
+        const typename _TyFrame::Window &entry = _TyFrame::GetWindow(window);
+
+        m_window      = window;
+        m_window_left = entry.duration;
+        m_partition   = entry.partition;
+        m_donee       = entry.donee;
+    }
+
+    PartitionStorage<_Partitions...> m_storage;            //!< inner strategies
+    ITaskSwitchStrategy            *m_inner[PARTITIONS];   //!< inner strategies of the partitions
+    Binding                         m_binding[TASKS];      //!< persistent bindings of the user tasks to partitions
+    Slot                            m_slot[TASKS];         //!< state of the added tasks (see IKernelTask::GetIndex)
+    uint32_t                        m_bound[PARTITIONS];   //!< number of tasks bound to the partitions
+    uint32_t                        m_ready[PARTITIONS];   //!< number of ready tasks of the partitions
+    size_t                          m_size;                //!< total number of tasks
+    uint32_t                        m_window;              //!< current window of the frame
+    uint32_t                        m_window_left;         //!< time left until the end of the current window (ticks)
+    uint8_t                         m_partition;           //!< partition owning the current window
+    uint8_t                         m_donee;               //!< partition receiving idle time of the current window
+
+    // If hit here: number of partitions must be within [1, stk::PARTITION_NONE).
+    STK_STATIC_ASSERT_N(PARTITIONS_COUNT, (PARTITIONS != 0) && ((uint32_t)PARTITIONS < (uint32_t)PARTITION_NONE));
+
+    // If hit here: window of the frame references non-existing partition.
+    STK_STATIC_ASSERT_N(PARTITIONS_FRAME_INVALID, _TyFrame::IsValidFor(PARTITIONS));
+};
+
+} // namespace stk
+
+#endif /* STK_STRATEGY_PARTITIONED_H_ */
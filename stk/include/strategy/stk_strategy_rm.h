@@ -0,0 +1,294 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_STRATEGY_RM_H_
+#define STK_STRATEGY_RM_H_
+
+#include "stk_common.h"
+#include "stk_sched_analysis.h"
+
+/*! \file  stk_strategy_rm.h
+    \brief Contains Rate-Monotonic task switching strategy.
+*/
+
+namespace stk {
+
+/*! \class SwitchStrategyRateMonotonic
+    \brief Tasks switching strategy concrete implementation - Rate-Monotonic (fixed-priority, preemptive).
+
+    Rate-Monotonic: HRT task with a shorter periodicity is given a higher priority, tasks with equal periodicity
+    are prioritized by the order of addition. Priorities are assigned when tasks are added (all HRT tasks are added
+    before Kernel is started), soft tasks of the stk::KERNEL_MIXED mode share the lowest priority level and are
+    rotated every tick (Round-Robin) to let all of them progress in slack time. The highest priority ready task is
+    always running and preempts a lower priority task, preempted HRT job is resumed later and is not considered
+    as completed.
+
+    Ready tasks are tracked with a bitmap (bit index is priority) which is updated when task goes to sleep or wakes
+    up (see ITaskSwitchStrategy::OnTaskSleep), the highest priority ready task is selected with a single
+    count-trailing-zeros operation (see GetLowestBit) regardless of the number of sleeping tasks. Priority of the
+    task is cached by the index of the task (see IKernelTask::GetIndex), therefore notifications are O(1).
+
+    \note  Up to SwitchStrategyRateMonotonic::TASKS_MAX tasks are supported, Kernel size must not exceed it.
+    \note  Use GetUtilization and GetUtilizationBound to check the achieved Liu & Layland utilization bound of the
+           HRT tasks added with a WCET hint (see IKernel::AddTask).
+*/
+class SwitchStrategyRateMonotonic : public ITaskSwitchStrategy
+{
+public:
+    enum EConfig
+    {
+        SCHED_POLICY = SCHED_POLICY_RATE_MONOTONIC, //!< scheduling policy (see stk::ESchedPolicy)
+        PREEMPTIVE   = 1                            //!< preempted HRT job is resumed (see ITaskSwitchStrategy::EConfig)
+    };
+
+    enum EConsts
+    {
+        TASKS_MAX = 32 //!< maximum number of tasks (bits of the priority bitmap)
+    };
+
+    explicit SwitchStrategyRateMonotonic() : m_size(0), m_soft(0), m_turn(0), m_ready(0), m_cursor(NULL),
+        m_soft_last(NULL)
+    {
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            m_tasks[i] = NULL;
+            m_prio[i]  = 0;
+        }
+    }
+
+    void AddTask(IKernelTask *task)
+    {
+        STK_ASSERT(m_size < TASKS_MAX);
+        STK_ASSERT(task->GetIndex() < TASKS_MAX);
+
+        // insert after the tasks with a shorter or equal periodicity
+        uint32_t key = GetPriorityKey(task), prio = m_size;
+        while ((prio != 0) && (GetPriorityKey(m_tasks[prio - 1]) > key))
+        {
+            SetPriority(m_tasks[prio - 1], prio);
+            --prio;
+        }
+
+        SetPriority(task, prio);
+        ++m_size;
+
+        if (key != UINT32_MAX)
+            ++m_soft;
+
+        // bits of the lower priority tasks are shifted together with the tasks
+        uint32_t higher = (1U << prio) - 1;
+        m_ready = (m_ready & higher) | ((m_ready & ~higher) << 1) | (task->IsSleeping() ? 0 : (1U << prio));
+
+        UpdateTurn();
+    }
+
+    void RemoveTask(IKernelTask *task)
+    {
+        int32_t prio = GetPriority(task);
+        STK_ASSERT(prio >= 0);
+
+        for (uint32_t i = prio; i < (m_size - 1); ++i)
+            SetPriority(m_tasks[i + 1], i);
+
+        m_tasks[--m_size] = NULL;
+
+        if ((uint32_t)prio < m_soft)
+            --m_soft;
+
+        uint32_t higher = (1U << prio) - 1;
+        m_ready = (m_ready & higher) | ((m_ready >> 1) & ~higher);
+
+        if (m_cursor == task)
+            m_cursor = NULL;
+
+        if (m_soft_last == task)
+            m_soft_last = NULL;
+
+        UpdateTurn();
+    }
+
+    IKernelTask *GetNext(IKernelTask *current)
+    {
+        STK_ASSERT(m_size != 0);
+
+        IKernelTask *next = GetHighestReady();
+
+        // Kernel rejected returned task (e.g. deferred soft task or pending removal) and continues iteration,
+        // give it the next ready task of a lower priority (wrapping around to let Kernel complete the iteration)
+        if ((next != NULL) && (next == current) && (m_cursor == current))
+        {
+            next = GetLowerReady(current);
+        }
+        else
+        if ((next != NULL) && (m_prio[next->GetIndex()] >= m_soft))
+        {
+            // soft task has its turn in this tick, the following one gets the turn on the next tick (see OnTick)
+            m_soft_last = next;
+        }
+
+        m_cursor = next;
+        return next;
+    }
+
+    IKernelTask *GetFirst()
+    {
+        STK_ASSERT(m_size != 0);
+
+        // soft task which starts scheduling has its turn
+        if ((m_soft == 0) && (m_soft_last == NULL))
+            m_soft_last = m_tasks[0];
+
+        m_cursor = NULL;
+        return m_tasks[0];
+    }
+
+    size_t GetSize() const { return m_size; }
+
+    void OnTick(int64_t ticks)
+    {
+        (void)ticks;
+
+        UpdateTurn();
+        m_cursor = NULL;
+    }
+
+    void OnTaskSleep(IKernelTask *task) { m_ready &= ~GetReadyBit(task); }
+
+    void OnTaskWake(IKernelTask *task) { m_ready |= GetReadyBit(task); }
+
+    /*! \brief     Get priority of the task.
+        \note      Soft tasks of the lowest priority level have distinct priorities by the order of addition but are
+                   rotated (see SwitchStrategyRateMonotonic).
+        \param[in] task: Task.
+        \return    Priority (0 is the highest), or -1 if task is not found.
+    */
+    int32_t GetPriority(IKernelTask *task) const
+    {
+        uint32_t index = task->GetIndex();
+        if (index >= TASKS_MAX)
+            return -1;
+
+        uint32_t prio = m_prio[index];
+        return ((prio < m_size) && (m_tasks[prio] == task) ? (int32_t)prio : -1);
+    }
+
+    /*! \brief     Get task by priority.
+        \param[in] priority: Priority (0 is the highest).
+    */
+    IKernelTask *GetTask(uint32_t priority)
+    {
+        STK_ASSERT(priority < m_size);
+        return m_tasks[priority];
+    }
+
+    /*! \brief     Get total utilization of the HRT tasks added with a WCET hint.
+        \return    Utilization in parts per million (see SchedAnalysis::UTILIZATION_FULL).
+    */
+    uint32_t GetUtilization() const
+    {
+        uint32_t utilization = 0;
+
+        for (uint32_t i = 0; i < m_size; ++i)
+        {
+            SchedTaskInfo info = { m_tasks[i]->GetHrtPeriodicity(), m_tasks[i]->GetHrtWcet(), 0 };
+
+            if ((info.periodicity != 0) && (info.wcet != 0))
+                utilization += SchedAnalysis::GetUtilization(info);
+        }
+
+        return utilization;
+    }
+
+    /*! \brief     Get Liu & Layland utilization bound for the number of HRT tasks added with a WCET hint.
+        \note      Task set is schedulable if GetUtilization does not exceed this bound.
+        \return    Bound in parts per million (see SchedAnalysis::UTILIZATION_FULL).
+    */
+    uint32_t GetUtilizationBound() const
+    {
+        uint32_t count = 0;
+
+        for (uint32_t i = 0; i < m_size; ++i)
+        {
+            if ((m_tasks[i]->GetHrtPeriodicity() != 0) && (m_tasks[i]->GetHrtWcet() != 0))
+                ++count;
+        }
+
+        return SchedAnalysis::GetLiuLaylandBound(count);
+    }
+
+private:
+    static __stk_forceinline uint32_t GetPriorityKey(IKernelTask *task)
+    {
+        // soft task (no periodicity) has the lowest priority
+        uint32_t periodicity = task->GetHrtPeriodicity();
+        return (periodicity != 0 ? periodicity : UINT32_MAX);
+    }
+
+    __stk_forceinline void SetPriority(IKernelTask *task, uint32_t prio)
+    {
+        m_tasks[prio] = task;
+        m_prio[task->GetIndex()] = (uint8_t)prio;
+    }
+
+    __stk_forceinline uint32_t GetReadyBit(IKernelTask *task) const
+    {
+        uint32_t prio = m_prio[task->GetIndex()];
+        STK_ASSERT(m_tasks[prio] == task);
+
+        return (1U << prio);
+    }
+
+    __stk_forceinline IKernelTask *GetHighestReady() const
+    {
+        if (m_ready == 0)
+            return NULL;
+
+        uint32_t prio = GetLowestBit(m_ready);
+
+        // only soft tasks are ready, start from the one which has the turn
+        if (prio >= m_soft)
+        {
+            uint32_t after = m_ready & ~((1U << m_turn) - 1);
+            if (after != 0)
+                prio = GetLowestBit(after);
+        }
+
+        return m_tasks[prio];
+    }
+
+    void UpdateTurn()
+    {
+        // turn passes to the soft task following the one which had the turn last (wrapping around)
+        uint32_t turn = (m_soft_last != NULL ? m_prio[m_soft_last->GetIndex()] + 1 : m_soft);
+
+        m_turn = ((turn >= m_soft) && (turn < m_size) ? turn : m_soft);
+    }
+
+    IKernelTask *GetLowerReady(IKernelTask *task) const
+    {
+        uint32_t prio  = GetPriority(task);
+        uint32_t lower = (prio + 1 >= TASKS_MAX ? 0 : (m_ready & ~((1U << (prio + 1)) - 1)));
+
+        // wrap around if there is no lower priority ready task
+        return (lower != 0 ? m_tasks[GetLowestBit(lower)] : task);
+    }
+
+    IKernelTask *m_tasks[TASKS_MAX]; //!< tasks sorted by priority (index is priority, 0 is the highest)
+    uint8_t      m_prio[TASKS_MAX];  //!< priority of the task (index is IKernelTask::GetIndex)
+    uint32_t     m_size;             //!< number of tasks
+    uint32_t     m_soft;             //!< priority of the first soft task (number of HRT tasks)
+    uint32_t     m_turn;             //!< priority of the soft task which has the turn in the current tick
+    uint32_t     m_ready;            //!< bitmap of ready tasks (bit index is priority)
+    IKernelTask *m_cursor;           //!< task returned by the last GetNext call within the current tick
+    IKernelTask *m_soft_last;        //!< soft task which had the turn last
+};
+
+} // namespace stk
+
+#endif /* STK_STRATEGY_RM_H_ */
@@ -18,10 +18,28 @@ namespace stk {
     \brief Tasks switching strategy concrete implementation - Round-Robin.
 
     Round-Robin: all tasks are given an equal amount of processing time.
+
+    Running task is rotated when its time quantum expires (1 tick by default, see SetQuantum), a larger quantum
+    reduces the number of context switches of CPU-bound tasks at the cost of a coarser fairness. Task which goes
+    to sleep is switched out immediately regardless of the quantum.
 */
 class SwitchStrategyRoundRobin : public ITaskSwitchStrategy
 {
 public:
+    enum EConfig
+    {
+        SCHED_POLICY = SCHED_POLICY_ROUND_ROBIN //!< scheduling policy (see stk::ESchedPolicy)
+    };
+
+    enum EConsts
+    {
+        QUANTUM_DEFAULT = 1 //!< default time quantum (ticks)
+    };
+
+    explicit SwitchStrategyRoundRobin() : m_tasks(), m_quantum(QUANTUM_DEFAULT), m_quantum_left(QUANTUM_DEFAULT),
+        m_fetched(false)
+    {}
+
     void AddTask(IKernelTask *task) { m_tasks.LinkBack(task); }
 
     void RemoveTask(IKernelTask *task) { m_tasks.Unlink(task); }
@@ -29,6 +47,18 @@ public:
     IKernelTask *GetNext(IKernelTask *current)
     {
         STK_ASSERT(m_tasks.GetSize() != 0);
+
+        // keep current task until its quantum expires, repeated call within the same tick means that Kernel did not
+        // accept returned task (e.g. it is pending removal) and iteration must continue
+        if ((m_quantum_left != 0) && !m_fetched && !current->IsSleeping())
+        {
+            m_fetched = true;
+            return current;
+        }
+
+        m_fetched      = true;
+        m_quantum_left = m_quantum;
+
         return (* current->GetNext());
     }
 
@@ -40,8 +70,41 @@ public:
 
     size_t GetSize() const { return m_tasks.GetSize(); }
 
+    void OnTick(int64_t ticks)
+    {
+        (void)ticks;
+
+        if (m_quantum_left != 0)
+            --m_quantum_left;
+
+        m_fetched = false;
+    }
+
+    void OnTaskSleep(IKernelTask *task) { (void)task; }
+
+    void OnTaskWake(IKernelTask *task) { (void)task; }
+
+    /*! \brief     Set time quantum of the task before it is rotated.
+        \param[in] quantum_tc: Time quantum (ticks), must be at least 1 tick.
+    */
+    void SetQuantum(uint32_t quantum_tc)
+    {
+        STK_ASSERT(quantum_tc != 0);
+
+        // first task is given its whole quantum when scheduling starts
+        m_quantum      = quantum_tc;
+        m_quantum_left = quantum_tc;
+    }
+
+    /*! \brief     Get time quantum of the task (ticks).
+    */
+    uint32_t GetQuantum() const { return m_quantum; }
+
 private:
-    IKernelTask::ListHeadType m_tasks; //!< tasks for scheduling
+    IKernelTask::ListHeadType m_tasks;        //!< tasks for scheduling
+    uint32_t                  m_quantum;      //!< time quantum (ticks)
+    uint32_t                  m_quantum_left; //!< time left until the quantum of the current task expires (ticks)
+    bool                      m_fetched;      //!< true if GetNext was called within the current tick
 };
 
 } // namespace stk
@@ -0,0 +1,314 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#ifndef STK_STRATEGY_STRIDE_H_
+#define STK_STRATEGY_STRIDE_H_
+
+#include "stk_common.h"
+
+/*! \file  stk_strategy_stride.h
+    \brief Contains Stride (proportional-share) task switching strategy.
+*/
+
+namespace stk {
+
+/*! \class SwitchStrategyStride
+    \brief Tasks switching strategy concrete implementation - Stride scheduling (deterministic proportional-share).
+
+    Stride: every task holds a number of tickets (see ITask::GetWeight) and receives CPU time in proportion to its
+    tickets. Task has a stride inversely proportional to its tickets and a pass value which is advanced by the stride
+    for every tick consumed by the task, task with the minimal pass is selected. Ready tasks are kept in a binary
+    min-heap on pass values (ties are resolved by the index of the task, see IKernelTask::GetIndex), therefore
+    selection is deterministic and takes O(log n).
+
+    Sleeping task leaves the heap when it goes to sleep (see ITaskSwitchStrategy::OnTaskSleep) and joins it again
+    with a pass not lower than the global pass when it wakes up, therefore sleeping does not accumulate a credit of
+    CPU time and heap holds ready tasks only.
+
+    \note  Up to _TasksMax tasks are supported, scheduling state of the task is kept in the slot of its index.
+
+    Usage example:
+    \code
+    // tasks return 6, 3 and 1 from ITask::GetWeight and receive 60%, 30% and 10% of CPU time
+    static Kernel<KERNEL_STATIC, 3, SwitchStrategyStride<3>, PlatformDefault> kernel;
+    \endcode
+*/
+template <uint32_t _TasksMax = 16>
+class SwitchStrategyStride : public ITaskSwitchStrategy
+{
+public:
+    enum EConsts
+    {
+        TASKS_MAX  = _TasksMax, //!< maximum number of tasks
+        STRIDE_ONE = (1 << 20)  //!< stride of the task with 1 ticket
+    };
+
+    explicit SwitchStrategyStride() : m_size(0), m_heap_size(0), m_pass(0), m_active(NULL), m_cursor(NULL),
+        m_fetched(false)
+    {
+        for (uint32_t i = 0; i < TASKS_MAX; ++i)
+        {
+            m_clients[i].task = NULL;
+            m_clients[i].heap = HEAP_NONE;
+            m_heap[i]         = 0;
+        }
+    }
+
+    void AddTask(IKernelTask *task)
+    {
+        // if hit here: more tasks than _TasksMax
+        STK_ASSERT(task->GetIndex() < TASKS_MAX);
+
+        Client *client = &m_clients[task->GetIndex()];
+        STK_ASSERT(client->task == NULL);
+
+        uint32_t tickets = task->GetUserTask()->GetWeight();
+        STK_ASSERT((tickets != 0) && (tickets <= STRIDE_ONE));
+
+        client->task   = task;
+        client->stride = STRIDE_ONE / tickets;
+        client->pass   = m_pass + client->stride;
+        client->heap   = HEAP_NONE;
+
+        if (!task->IsSleeping())
+            Push(client);
+
+        ++m_size;
+    }
+
+    void RemoveTask(IKernelTask *task)
+    {
+        Client *client = GetClient(task);
+
+        if (client->heap != HEAP_NONE)
+            Erase(client->heap);
+
+        client->task = NULL;
+        --m_size;
+
+        if (m_active == client)
+            m_active = NULL;
+
+        if (m_cursor == task)
+            m_cursor = NULL;
+    }
+
+    IKernelTask *GetNext(IKernelTask *current)
+    {
+        STK_ASSERT(m_size != 0);
+
+        // repeated call within the same tick means that Kernel did not accept returned task (e.g. it is pending
+        // removal), continue iteration over all tasks to let Kernel complete it
+        if (m_fetched && (current == m_cursor))
+            return Select(GetFollowing(current != NULL ? GetClient(current) : NULL));
+
+        if (!m_fetched)
+        {
+            m_fetched = true;
+
+            // charge the running task for the consumed tick
+            if ((m_active != NULL) && (m_active->task == current))
+            {
+                m_active->pass += m_active->stride;
+
+                if (m_active->heap != HEAP_NONE)
+                    SiftDown(m_active->heap);
+            }
+        }
+
+        if (m_heap_size == 0)
+            return Select(NULL);
+
+        Client *next = &m_clients[m_heap[0]];
+        m_pass = next->pass;
+
+        return Select(next);
+    }
+
+    IKernelTask *GetFirst()
+    {
+        STK_ASSERT(m_size != 0);
+
+        Client *first = (m_heap_size != 0 ? &m_clients[m_heap[0]] : GetFollowing(NULL));
+
+        // task which starts scheduling is charged for its ticks
+        if (m_active == NULL)
+            m_active = first;
+
+        return first->task;
+    }
+
+    size_t GetSize() const { return m_size; }
+
+    void OnTick(int64_t ticks)
+    {
+        (void)ticks;
+
+        m_fetched = false;
+        m_cursor  = NULL;
+    }
+
+    void OnTaskSleep(IKernelTask *task)
+    {
+        Client *client = GetClient(task);
+
+        if (client->heap != HEAP_NONE)
+            Erase(client->heap);
+    }
+
+    void OnTaskWake(IKernelTask *task)
+    {
+        Client *client = GetClient(task);
+
+        if (client->heap == HEAP_NONE)
+        {
+            // no credit for the time spent sleeping
+            if (client->pass < m_pass)
+                client->pass = m_pass;
+
+            Push(client);
+        }
+    }
+
+    /*! \brief     Get pass value of the task.
+        \param[in] task: Task.
+    */
+    uint64_t GetPass(IKernelTask *task) { return GetClient(task)->pass; }
+
+private:
+    enum { HEAP_NONE = 0xFFFFFFFF };
+
+    /*! \class Client
+        \brief Scheduling state of the task.
+    */
+    struct Client
+    {
+        IKernelTask *task;   //!< task, NULL if not used
+        uint64_t     pass;   //!< pass value (virtual time)
+        uint32_t     stride; //!< pass increment per tick
+        uint32_t     heap;   //!< index in the heap, HEAP_NONE if task is out of the heap (sleeping)
+    };
+
+    __stk_forceinline Client *GetClient(IKernelTask *task)
+    {
+        STK_ASSERT(task != NULL);
+        STK_ASSERT((task->GetIndex() < TASKS_MAX) && (m_clients[task->GetIndex()].task == task));
+
+        return &m_clients[task->GetIndex()];
+    }
+
+    Client *GetFollowing(Client *client)
+    {
+        uint32_t start = (client != NULL ? (uint32_t)(client - m_clients) : TASKS_MAX - 1);
+
+        for (uint32_t i = 1; i <= TASKS_MAX; ++i)
+        {
+            Client *next = &m_clients[(start + i) % TASKS_MAX];
+
+            if (next->task != NULL)
+                return next;
+        }
+
+        return client;
+    }
+
+    IKernelTask *Select(Client *client)
+    {
+        m_active = client;
+        m_cursor = (client != NULL ? client->task : NULL);
+        return m_cursor;
+    }
+
+    bool IsLess(uint32_t a, uint32_t b) const
+    {
+        const Client &ca = m_clients[m_heap[a]], &cb = m_clients[m_heap[b]];
+
+        // equal pass: task added earlier goes first
+        return (ca.pass < cb.pass) || ((ca.pass == cb.pass) && (m_heap[a] < m_heap[b]));
+    }
+
+    void Swap(uint32_t a, uint32_t b)
+    {
+        uint32_t tmp = m_heap[a];
+        m_heap[a] = m_heap[b];
+        m_heap[b] = tmp;
+
+        m_clients[m_heap[a]].heap = a;
+        m_clients[m_heap[b]].heap = b;
+    }
+
+    void SiftUp(uint32_t i)
+    {
+        while ((i != 0) && IsLess(i, (i - 1) / 2))
+        {
+            Swap(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void SiftDown(uint32_t i)
+    {
+        for (;;)
+        {
+            uint32_t min = i, left = (2 * i) + 1, right = left + 1;
+
+            if ((left < m_heap_size) && IsLess(left, min))
+                min = left;
+
+            if ((right < m_heap_size) && IsLess(right, min))
+                min = right;
+
+            if (min == i)
+                break;
+
+            Swap(i, min);
+            i = min;
+        }
+    }
+
+    void Push(Client *client)
+    {
+        uint32_t i = m_heap_size++;
+
+        m_heap[i]    = (uint32_t)(client - m_clients);
+        client->heap = i;
+
+        SiftUp(i);
+    }
+
+    void Erase(uint32_t i)
+    {
+        m_clients[m_heap[i]].heap = HEAP_NONE;
+
+        if (i != --m_heap_size)
+        {
+            m_heap[i] = m_heap[m_heap_size];
+            m_clients[m_heap[i]].heap = i;
+
+            SiftUp(i);
+            SiftDown(i);
+        }
+    }
+
+    Client       m_clients[TASKS_MAX]; //!< scheduling state of the tasks
+    uint32_t     m_heap[TASKS_MAX];    //!< min-heap of the ready tasks on pass values (indexes of m_clients)
+    uint32_t     m_size;               //!< number of tasks
+    uint32_t     m_heap_size;          //!< number of tasks in the heap
+    uint64_t     m_pass;               //!< global pass (pass of the last selected task)
+    Client      *m_active;             //!< task being charged for the ticks
+    IKernelTask *m_cursor;             //!< task returned by the last GetNext call within the current tick
+    bool         m_fetched;            //!< true if GetNext was called within the current tick
+
+    // If hit here: number of tasks must not be 0.
+    STK_STATIC_ASSERT_N(STRIDE_TASKS_MAX, _TasksMax != 0);
+};
+
+} // namespace stk
+
+#endif /* STK_STRATEGY_STRIDE_H_ */
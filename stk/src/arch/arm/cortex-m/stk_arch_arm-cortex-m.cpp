@@ -96,6 +96,14 @@ __stk_forceinline void ScheduleContextSwitch()
 //! Platform events overrider.
 static IPlatform::IEventOverrider *g_Overrider = NULL;
 
+//! Critical section state (see PlatformArmCortexM::EnterCriticalSection).
+static struct CriticalSection
+{
+    uint32_t nesting; //!< nesting depth
+    uint32_t ses;     //!< PRIMASK saved by the outermost critical section
+}
+g_CriticalSection = {};
+
 //! Internal context.
 static struct Context : public PlatformContext
 {
@@ -369,11 +377,16 @@ static void OnTaskExit()
 
     g_Context.m_handler->OnTaskExit(g_Context.m_stack_active);
 
+    // switch to the next task right away instead of waiting for the end of the time slot, PendSV is taken
+    // when interrupts are enabled (before SysTick of the same priority)
+    if (g_Context.m_handler->OnReschedule(&g_Context.m_stack_idle, &g_Context.m_stack_active))
+        ScheduleContextSwitch();
+
     STK_CORTEX_M_CRITICAL_SECTION_END(cs);
 
     for (;;)
     {
-        __WFI(); // enter standby mode until time slot expires
+        __WFI(); // enter standby mode until time slot expires (if switch was not possible)
     }
 }
 
@@ -425,8 +438,9 @@ bool PlatformArmCortexM::InitStack(EStackType stack_type, Stack *stack, IStackMe
 {
     STK_ASSERT(stack_memory->GetStackSize() > STK_CORTEX_M_REGISTER_COUNT);
 
-    // initialize stack memory
-    size_t *stack_top = g_Context.InitStackMemory(stack_memory);
+    // initialize stack memory, restarted task keeps it and gets initial frame only
+    size_t *stack_top = (stack_type == STACK_USER_TASK_RESTART ?
+        g_Context.InitStackFrame(stack_memory, STK_CORTEX_M_REGISTER_COUNT) : g_Context.InitStackMemory(stack_memory));
 
     // initialize Stack Pointer (SP)
     stack->SP = (size_t)(stack_top - STK_CORTEX_M_REGISTER_COUNT);
@@ -442,7 +456,8 @@ bool PlatformArmCortexM::InitStack(EStackType stack_type, Stack *stack, IStackMe
     // initialize registers for the user task's first start
     switch (stack_type)
     {
-    case STACK_USER_TASK: {
+    case STACK_USER_TASK:
+    case STACK_USER_TASK_RESTART: {
         PC = (size_t)user_task->GetFunc() & ~0x1UL; // "Bit [0] is always 0, so instructions are always aligned to halfword boundaries" (https://developer.arm.com/documentation/ddi0413/c/programmer-s-model/registers/general-purpose-registers)
         LR = (size_t)OnTaskExit;
         R0 = (size_t)user_task->GetFuncUserData();
@@ -525,6 +540,13 @@ void PlatformArmCortexM::SleepTicks(uint32_t ticks)
     g_Context.m_handler->OnTaskSleep(::GetCallerSP(), ticks);
 }
 
+void PlatformArmCortexM::Reschedule()
+{
+    // called within a critical section, PendSV is taken when interrupts are enabled
+    if (g_Context.m_handler->OnReschedule(&g_Context.m_stack_idle, &g_Context.m_stack_active))
+        ScheduleContextSwitch();
+}
+
 void PlatformArmCortexM::ProcessHardFault()
 {
     if ((g_Overrider == NULL) || !g_Overrider->OnHardFault())
@@ -544,4 +566,23 @@ size_t PlatformArmCortexM::GetCallerSP()
     return ::GetCallerSP();
 }
 
+void PlatformArmCortexM::EnterCriticalSection()
+{
+    uint32_t ses;
+    STK_CORTEX_M_CRITICAL_SECTION_START(ses);
+
+    if (g_CriticalSection.nesting++ == 0)
+        g_CriticalSection.ses = ses;
+}
+
+void PlatformArmCortexM::ExitCriticalSection()
+{
+    STK_ASSERT(g_CriticalSection.nesting != 0);
+
+    if (--g_CriticalSection.nesting == 0)
+    {
+        STK_CORTEX_M_CRITICAL_SECTION_END(g_CriticalSection.ses);
+    }
+}
+
 #endif // _STK_ARCH_ARM_CORTEX_M
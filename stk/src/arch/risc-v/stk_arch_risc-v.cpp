@@ -60,6 +60,11 @@ using namespace stk;
     #define _STK_SYSTICK_HANDLER riscv_mtvec_mti // see vector_table.h/vector_table.c
 #endif
 
+//! Software interrupt handler (see PlatformRiscV::Reschedule).
+#ifndef _STK_MSI_HANDLER
+    #define _STK_MSI_HANDLER riscv_mtvec_msi // see vector_table.h/vector_table.c
+#endif
+
 //! Exception handler.
 #ifndef _STK_SVC_HANDLER
     #define _STK_SVC_HANDLER riscv_mtvec_exception // see vector_table.h/vector_table.c
@@ -231,6 +236,16 @@ static __stk_forceinline void SetMtimecmp(uint64_t advance)
 #endif
 }
 
+/*! \brief     Set or clear pending machine software interrupt (msip register) of the current hart.
+    \param[in] pending: 1 to raise interrupt, 0 to acknowledge it.
+*/
+static __stk_forceinline void SetMsip(uint32_t pending)
+{
+    uint32_t hart = read_csr(mhartid);
+
+    ((volatile uint32_t *)STK_RISCV_CLINT_MSIP_ADDR)[hart] = pending;
+}
+
 /*! \brief Get SP of the calling process.
 */
 static __stk_forceinline size_t GetCallerSP()
@@ -262,6 +277,14 @@ static IPlatform::IEventOverrider *g_Overrider = NULL;
 //! Platform-specific event handler.
 static PlatformRiscV::ISpecificEventHandler *g_Specific = NULL;
 
+//! Critical section state (see PlatformRiscV::EnterCriticalSection).
+static struct CriticalSection
+{
+    size_t nesting; //!< nesting depth
+    size_t ses;     //!< session value of the outermost critical section
+}
+g_CriticalSection = {};
+
 //! ISR handler's stack memory.
 #ifndef STK_RISCV_USE_MAIN_STACK_FOR_ISR
 typedef StackMemoryDef<128> TIsrStackMemory;
@@ -607,6 +630,43 @@ extern "C" __attribute__ ((interrupt ("machine"))) void _STK_SYSTICK_HANDLER()
     : /* clobbers: none */);
 }
 #else
+extern "C" __stk_attr_used void TryReschedule() // __stk_attr_used for LTO
+{
+    STK_ASSERT(g_Context.m_handler != NULL);
+
+    // acknowledge software interrupt
+    SetMsip(0);
+
+    // switch to the next task if allowed, context of the current task is saved into the active stack already,
+    // therefore switch is made in the same way as by the timer interrupt (see _STK_SYSTICK_HANDLER)
+    if (g_Context.m_started)
+        g_Context.m_handler->OnReschedule(&g_Context.m_stack_idle, &g_Context.m_stack_active);
+}
+
+extern "C" __stk_attr_naked void _STK_MSI_HANDLER()
+{
+    // save current context (unconditionally)
+    SaveContext();
+
+    // internal ISR processing
+    {
+        // load SP of the main stack to handle ISR
+        LoadMainSP();
+
+        // try switch context (do via asm function call to avoid inlining)
+        __asm volatile(
+        "jal ra, TryReschedule"
+        : /* output: none */
+        : /* input: none */
+        : /* clobbers: none */);
+    }
+
+    // load context of the active task (the same one if switch was not made)
+    LoadContext();
+
+    STK_RISCV_EXIT_FROM_HANDLER();
+}
+
 extern "C" __stk_attr_naked void _STK_SYSTICK_HANDLER()
 {
     // save current context (unconditionally)
@@ -655,8 +715,8 @@ static __stk_forceinline void StartScheduling()
     g_Context.m_started  = true;
     g_Context.m_starting = false;
 
-    // enable timer interrupt
-    set_csr(mie, MIP_MTIP);
+    // enable timer and software (see PlatformRiscV::Reschedule) interrupts
+    set_csr(mie, MIP_MTIP | MIP_MSIP);
 }
 
 extern "C" __attribute__ ((interrupt ("machine"))) void _STK_SVC_HANDLER()
@@ -712,11 +772,15 @@ static void OnTaskExit()
 
     g_Context.m_handler->OnTaskExit(g_Context.m_stack_active);
 
+    // switch to the next task right away instead of waiting for the end of the time slot, software interrupt is
+    // taken when interrupts are enabled and asks the event handler for the switch (see TryReschedule)
+    SetMsip(1);
+
     STK_RISCV_CRITICAL_SECTION_END(cs);
 
     for (;;)
     {
-        STK_RISCV_WFI(); // enter standby mode until time slot expires
+        STK_RISCV_WFI(); // enter standby mode until time slot expires (if switch was not possible)
     }
 }
 
@@ -768,8 +832,10 @@ bool PlatformRiscV::InitStack(EStackType stack_type, Stack *stack, IStackMemory
 {
     STK_ASSERT(stack_memory->GetStackSize() > (STK_RISCV_REGISTER_COUNT + STK_SERVICE_SLOTS));
 
-    // initialize stack memory
-    size_t *stack_top = g_Context.InitStackMemory(stack_memory);
+    // initialize stack memory, restarted task keeps it and gets initial frame only
+    size_t *stack_top = (stack_type == STACK_USER_TASK_RESTART ?
+        g_Context.InitStackFrame(stack_memory, STK_RISCV_REGISTER_COUNT + STK_SERVICE_SLOTS) :
+        g_Context.InitStackMemory(stack_memory));
 
     // initialize Stack Pointer (SP)
     stack->SP = (size_t)(stack_top - (STK_RISCV_REGISTER_COUNT + STK_SERVICE_SLOTS));
@@ -783,7 +849,8 @@ bool PlatformRiscV::InitStack(EStackType stack_type, Stack *stack, IStackMemory
     // initialize registers for the user task's first start
     switch (stack_type)
     {
-    case STACK_USER_TASK: {
+    case STACK_USER_TASK:
+    case STACK_USER_TASK_RESTART: {
         MEPC = (size_t)user_task->GetFunc();
         RA   = (size_t)OnTaskExit;
         X10  = (size_t)user_task->GetFuncUserData();
@@ -819,7 +886,8 @@ bool PlatformRiscV::InitStack(EStackType stack_type, Stack *stack, IStackMemory
 
 static void SysTick_Stop()
 {
-    clear_csr(mie, MIP_MTIP);
+    clear_csr(mie, MIP_MTIP | MIP_MSIP);
+    SetMsip(0);
 }
 
 void PlatformRiscV::Stop()
@@ -857,6 +925,12 @@ void PlatformRiscV::SleepTicks(uint32_t ticks)
     g_Context.m_handler->OnTaskSleep(::GetCallerSP(), ticks);
 }
 
+void PlatformRiscV::Reschedule()
+{
+    // switch is made by the software interrupt handler when interrupts are enabled (see TryReschedule)
+    SetMsip(1);
+}
+
 void PlatformRiscV::ProcessHardFault()
 {
     if ((g_Overrider == NULL) || !g_Overrider->OnHardFault())
@@ -882,4 +956,20 @@ void PlatformRiscV::SetSpecificEventHandler(ISpecificEventHandler *handler)
     g_Specific = handler;
 }
 
+void PlatformRiscV::EnterCriticalSection()
+{
+    size_t ses = ::EnterCriticalSection();
+
+    if (g_CriticalSection.nesting++ == 0)
+        g_CriticalSection.ses = ses;
+}
+
+void PlatformRiscV::ExitCriticalSection()
+{
+    STK_ASSERT(g_CriticalSection.nesting != 0);
+
+    if (--g_CriticalSection.nesting == 0)
+        ::ExitCriticalSection(g_CriticalSection.ses);
+}
+
 #endif // _STK_ARCH_RISC_V
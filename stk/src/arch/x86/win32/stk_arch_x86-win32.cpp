@@ -30,8 +30,8 @@ static timeBeginPeriodF timeBeginPeriod = NULL;
 
 #define STK_X86_WIN32_CRITICAL_SECTION CRITICAL_SECTION
 #define STK_X86_WIN32_CRITICAL_SECTION_INIT(SES) InitializeCriticalSection(SES)
-#define STK_X86_WIN32_CRITICAL_SECTION_START(SES) EnterCriticalSection(SES)
-#define STK_X86_WIN32_CRITICAL_SECTION_END(SES) LeaveCriticalSection(SES)
+#define STK_X86_WIN32_CRITICAL_SECTION_START(SES) ::EnterCriticalSection(SES)
+#define STK_X86_WIN32_CRITICAL_SECTION_END(SES) ::LeaveCriticalSection(SES)
 #define STK_X86_WIN32_MIN_RESOLUTION (1000)
 #define STK_X86_WIN32_GET_SP(STACK) (STACK + 2) // +2 to overcome stack filler check inside Kernel (adjusting to +2 preserves 8-byte alignment)
 
@@ -40,6 +40,12 @@ using namespace stk;
 //! Internal context.
 static struct Context : public PlatformContext
 {
+    Context()
+    {
+        // critical section is accessible by the user before the start (see PlatformX86Win32::EnterCriticalSection)
+        STK_X86_WIN32_CRITICAL_SECTION_INIT(&m_cs);
+    }
+
     void Initialize(IPlatform::IEventHandler *handler, Stack *exit_trap, int32_t resolution_us)
     {
         PlatformContext::Initialize(handler, exit_trap, resolution_us);
@@ -48,8 +54,6 @@ static struct Context : public PlatformContext
         m_timer_thread = NULL;
         m_started      = false;
 
-        STK_X86_WIN32_CRITICAL_SECTION_INIT(&m_cs);
-
         LoadWindowsAPI();
     }
     ~Context()
@@ -312,7 +316,9 @@ bool Context::InitStack(EStackType stack_type, Stack *stack, IStackMemory *stack
 
     switch (stack_type)
     {
-    case STACK_USER_TASK: {
+    // task runs in its own thread, therefore restarted task gets a new thread
+    case STACK_USER_TASK:
+    case STACK_USER_TASK_RESTART: {
         TaskContext *ctx = (TaskContext *)stack_top;
 
         ctx->Initialize(user_task, stack);
@@ -374,6 +380,11 @@ void PlatformX86Win32::SleepTicks(uint32_t ticks)
     g_Context.SleepTicks(ticks);
 }
 
+void PlatformX86Win32::Reschedule()
+{
+    // tasks are threads suspended by the timer thread, switch is made on the next tick
+}
+
 void PlatformX86Win32::ProcessTick()
 {
     g_Context.ProcessTick();
@@ -399,4 +410,15 @@ size_t PlatformX86Win32::GetCallerSP()
     return g_Context.GetCallerSP();
 }
 
+void PlatformX86Win32::EnterCriticalSection()
+{
+    // tick thread is entering the same critical section, therefore tick is deferred while it is held
+    STK_X86_WIN32_CRITICAL_SECTION_START(&g_Context.m_cs);
+}
+
+void PlatformX86Win32::ExitCriticalSection()
+{
+    STK_X86_WIN32_CRITICAL_SECTION_END(&g_Context.m_cs);
+}
+
 #endif // _STK_ARCH_X86_WIN32
@@ -0,0 +1,174 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ================================ LoanChannel =============================== //
+// ============================================================================ //
+
+TEST_GROUP(LoanChannel)
+{
+    void setup() {}
+    void teardown() {}
+
+    struct Runner
+    {
+        Runner() : platform((PlatformTestMock *)kernel.GetPlatform())
+        {
+            kernel.Initialize();
+            kernel.AddTask(&task1);
+            kernel.AddTask(&task2);
+            kernel.Start();
+        }
+
+        Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+        TaskMock<ACCESS_USER> task1, task2;
+        PlatformTestMock *platform;
+    };
+};
+
+typedef LoanChannel<10, 2> Channel;
+
+static struct ChannelRelaxCpuContext
+{
+    ChannelRelaxCpuContext() : counter(0), release_at(0), stop_at(0), release(NULL), channel(NULL), platform(NULL) {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          release_at;
+    uint32_t          stop_at;
+    uint8_t          *release;
+    Channel          *channel;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop(); // leave infinite wait
+
+        platform->ProcessTick();
+
+        // simulate ISR (e.g. DMA completion)
+        if (counter == release_at)
+            channel->Release(release);
+    }
+}
+g_ChannelRelaxCpuContext;
+
+static void ChannelRelaxCpu()
+{
+    g_ChannelRelaxCpuContext.Process();
+}
+
+TEST(LoanChannel, SendReceive)
+{
+    Runner r;
+    Channel channel;
+    uint32_t length = 0;
+
+    CHECK_EQUAL(10, channel.GetBufferSize());
+    CHECK_EQUAL(0, channel.GetInFlight());
+
+    uint8_t *buffer1 = channel.Acquire();
+    uint8_t *buffer2 = channel.Acquire();
+    CHECK_TRUE((buffer1 != NULL) && (buffer2 != NULL) && (buffer1 != buffer2));
+    CHECK_EQUAL(0, ((size_t)buffer1 % sizeof(size_t)));
+
+    buffer1[0] = 1;
+    buffer2[0] = 2;
+
+    channel.Send(buffer2, 5);
+    channel.Send(buffer1, 10);
+    CHECK_EQUAL(2, channel.GetPending());
+
+    // ownership is passed in the order of sending, payload is not copied
+    uint8_t *received = channel.Receive(length);
+    CHECK_EQUAL(buffer2, received);
+    CHECK_EQUAL(5, length);
+    CHECK_EQUAL(2, received[0]);
+
+    received = channel.Receive(length);
+    CHECK_EQUAL(buffer1, received);
+    CHECK_EQUAL(10, length);
+
+    CHECK_TRUE(channel.Receive(length, 0) == NULL);
+
+    CHECK_EQUAL(2, channel.GetInFlight());
+    channel.Release(buffer1);
+    channel.Release(buffer2);
+
+    CHECK_EQUAL(0, channel.GetInFlight());
+    CHECK_EQUAL(2, channel.GetInFlightMax());
+    CHECK_EQUAL(2, channel.GetSentTotal());
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(LoanChannel, ReleaseForeign)
+{
+    Runner r;
+    Channel channel;
+    uint8_t foreign[16];
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        channel.Release(foreign);
+        CHECK_TEXT(false, "expecting assertion for the buffer which does not belong to the channel");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(LoanChannel, AcquireBlocks)
+{
+    Runner r;
+    Channel channel;
+
+    uint8_t *buffer1 = channel.Acquire();
+    channel.Acquire();
+
+    // pool is exhausted
+    CHECK_TRUE(channel.Acquire(0) == NULL);
+
+    g_ChannelRelaxCpuContext = ChannelRelaxCpuContext();
+    g_ChannelRelaxCpuContext.platform   = r.platform;
+    g_ChannelRelaxCpuContext.channel    = &channel;
+    g_ChannelRelaxCpuContext.stop_at    = 100;
+    g_RelaxCpuHandler = ChannelRelaxCpu;
+
+    CHECK_TRUE(channel.Acquire(3) == NULL);
+    CHECK_EQUAL(3, g_ChannelRelaxCpuContext.counter);
+
+    // producer is woken up by the release from ISR
+    g_ChannelRelaxCpuContext = ChannelRelaxCpuContext();
+    g_ChannelRelaxCpuContext.platform   = r.platform;
+    g_ChannelRelaxCpuContext.channel    = &channel;
+    g_ChannelRelaxCpuContext.release    = buffer1;
+    g_ChannelRelaxCpuContext.release_at = 4;
+    g_ChannelRelaxCpuContext.stop_at    = 100;
+
+    CHECK_EQUAL(buffer1, channel.Acquire());
+    CHECK_EQUAL(4, g_ChannelRelaxCpuContext.counter);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(2, channel.GetInFlight());
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+} // namespace stk
+} // namespace test
@@ -0,0 +1,195 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// =============================== DeferredQueue ============================== //
+// ============================================================================ //
+
+TEST_GROUP(DeferredQueue)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+static struct DeferredCallContext
+{
+    DeferredCallContext() : count(0), repost(NULL)
+    {
+        for (uint32_t i = 0; i < ARGS_MAX; ++i)
+            args[i] = 0;
+    }
+
+    enum { ARGS_MAX = 8 };
+
+    uint32_t            count;
+    size_t              args[ARGS_MAX];
+    DeferredQueue<4>   *repost;
+}
+g_DeferredCallContext;
+
+static void DeferredCall(void *arg)
+{
+    if (g_DeferredCallContext.count < DeferredCallContext::ARGS_MAX)
+        g_DeferredCallContext.args[g_DeferredCallContext.count] = (size_t)arg;
+
+    ++g_DeferredCallContext.count;
+
+    // post from the deferred call itself
+    if (g_DeferredCallContext.repost != NULL)
+    {
+        DeferredQueue<4> *queue = g_DeferredCallContext.repost;
+        g_DeferredCallContext.repost = NULL;
+
+        queue->Post(&DeferredCall, (void *)100);
+    }
+}
+
+TEST(DeferredQueue, PostProcess)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    DeferredQueue<4> queue;
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    g_DeferredCallContext = DeferredCallContext();
+
+    CHECK_TRUE(queue.Post(&DeferredCall, (void *)1));
+    CHECK_TRUE(queue.Post(&DeferredCall, (void *)2));
+    CHECK_TRUE(queue.Post(&DeferredCall, (void *)3));
+    CHECK_EQUAL(3, queue.GetSize());
+    CHECK_EQUAL(0, g_DeferredCallContext.count);
+
+    // calls are executed in the order of posting
+    CHECK_EQUAL(3, queue.Process());
+    CHECK_EQUAL(0, queue.GetSize());
+    CHECK_EQUAL(3, g_DeferredCallContext.count);
+    CHECK_EQUAL(1, g_DeferredCallContext.args[0]);
+    CHECK_EQUAL(2, g_DeferredCallContext.args[1]);
+    CHECK_EQUAL(3, g_DeferredCallContext.args[2]);
+
+    // ring buffer wraps around, call posted by the call is executed within the same Process
+    g_DeferredCallContext = DeferredCallContext();
+    g_DeferredCallContext.repost = &queue;
+
+    CHECK_TRUE(queue.Post(&DeferredCall, (void *)4));
+    CHECK_TRUE(queue.Post(&DeferredCall, (void *)5));
+    CHECK_EQUAL(3, queue.Process());
+    CHECK_EQUAL(4, g_DeferredCallContext.args[0]);
+    CHECK_EQUAL(5, g_DeferredCallContext.args[1]);
+    CHECK_EQUAL(100, g_DeferredCallContext.args[2]);
+
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(DeferredQueue, Overflow)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    DeferredQueue<2> queue;
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    CHECK_TRUE(queue.Post(&DeferredCall, NULL));
+    CHECK_TRUE(queue.Post(&DeferredCall, NULL));
+    CHECK_FALSE(queue.Post(&DeferredCall, NULL));
+
+    CHECK_EQUAL(2, queue.GetSize());
+    CHECK_EQUAL(1, queue.GetDroppedCount());
+}
+
+static struct DeferredRelaxCpuContext
+{
+    DeferredRelaxCpuContext() : counter(0), post_at(0), scheduled(0), queue(NULL), platform(NULL) {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          post_at;
+    uint32_t          scheduled;
+    DeferredQueue<4> *queue;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        if (++counter > post_at)
+            throw Stop(); // leave infinite loop of the worker task when it waits again
+
+        platform->ProcessTick();
+
+        if (platform->m_stack_active->SP == (size_t)queue->GetStack())
+            ++scheduled;
+
+        // simulate ISR
+        if (counter == post_at)
+            queue->Post(&DeferredCall, (void *)7);
+    }
+}
+g_DeferredRelaxCpuContext;
+
+static void DeferredRelaxCpu()
+{
+    g_DeferredRelaxCpuContext.Process();
+}
+
+TEST(DeferredQueue, WorkerTask)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    DeferredQueue<4> queue;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    CHECK_EQUAL(&queue, queue.GetFuncUserData());
+    CHECK_EQUAL(ACCESS_PRIVILEGED, queue.GetAccessMode());
+
+    kernel.Initialize();
+    kernel.AddTask(&queue);
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)queue.GetStack(), platform->m_stack_active->SP);
+
+    g_DeferredCallContext = DeferredCallContext();
+    g_DeferredRelaxCpuContext = DeferredRelaxCpuContext();
+    g_DeferredRelaxCpuContext.platform = platform;
+    g_DeferredRelaxCpuContext.queue    = &queue;
+    g_DeferredRelaxCpuContext.post_at  = 5;
+    g_RelaxCpuHandler = DeferredRelaxCpu;
+
+    try
+    {
+        // worker waits while queue is empty and is woken up by the post
+        queue.GetFunc()(queue.GetFuncUserData());
+    }
+    catch (DeferredRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(1, g_DeferredCallContext.count);
+    CHECK_EQUAL(7, g_DeferredCallContext.args[0]);
+
+    // waiting worker is not scheduled while queue is empty
+    CHECK_EQUAL(0, g_DeferredRelaxCpuContext.scheduled);
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+} // namespace stk
+} // namespace test
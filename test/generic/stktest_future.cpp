@@ -0,0 +1,239 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ============================== Promise/Future ============================== //
+// ============================================================================ //
+
+TEST_GROUP(Future)
+{
+    void setup() {}
+    void teardown() {}
+
+    struct Runner
+    {
+        Runner() : platform((PlatformTestMock *)kernel.GetPlatform())
+        {
+            kernel.Initialize();
+            kernel.AddTask(&task1);
+            kernel.AddTask(&task2);
+            kernel.Start();
+        }
+
+        Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+        TaskMock<ACCESS_USER> task1, task2;
+        PlatformTestMock *platform;
+    };
+};
+
+static struct FutureRelaxCpuContext
+{
+    FutureRelaxCpuContext() : counter(0), set_at(0), stop_at(0), promise(NULL), platform(NULL), notify(NULL) {}
+
+    struct Stop {};
+
+    uint32_t           counter;
+    uint32_t           set_at;
+    uint32_t           stop_at;
+    Promise<uint32_t> *promise;
+    PlatformTestMock  *platform;
+    ITask             *notify;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop(); // leave infinite wait
+
+        // simulate stale notification, task is woken up by the tick
+        if (notify != NULL)
+            g_KernelService->Notify(notify);
+
+        platform->ProcessTick();
+
+        // simulate ISR
+        if (counter == set_at)
+            promise->Set(counter * 10);
+    }
+}
+g_FutureRelaxCpuContext;
+
+static void FutureRelaxCpu()
+{
+    g_FutureRelaxCpuContext.Process();
+}
+
+TEST(Future, SetGet)
+{
+    Runner r;
+    Promise<uint32_t> promise;
+    Future<uint32_t> future;
+    uint32_t value = 0;
+
+    CHECK_FALSE(future.IsValid());
+
+    future = promise.GetFuture();
+
+    CHECK_TRUE(future.IsValid());
+    CHECK_FALSE(future.IsReady());
+
+    CHECK_TRUE(promise.Set(5));
+    CHECK_TRUE(future.IsReady());
+
+    // value is set once
+    CHECK_FALSE(promise.Set(6));
+
+    // ready value is returned without waiting
+    CHECK_TRUE(future.Get(value));
+    CHECK_EQUAL(5, value);
+
+    promise.Reset();
+    CHECK_FALSE(future.IsReady());
+
+    CHECK_TRUE(promise.Set(7));
+    CHECK_TRUE(future.Get(value));
+    CHECK_EQUAL(7, value);
+
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(Future, GetBlocks)
+{
+    Runner r;
+    Promise<uint32_t> promise;
+    uint32_t value = 0;
+
+    g_FutureRelaxCpuContext = FutureRelaxCpuContext();
+    g_FutureRelaxCpuContext.platform = r.platform;
+    g_FutureRelaxCpuContext.promise  = &promise;
+    g_FutureRelaxCpuContext.set_at   = 3;
+    g_FutureRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = FutureRelaxCpu;
+
+    // task1 is not scheduled until value is set
+    CHECK_TRUE(promise.GetFuture().Get(value));
+    CHECK_EQUAL((size_t)r.task2.GetStack(), r.platform->m_stack_active->SP);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(3, g_FutureRelaxCpuContext.counter);
+    CHECK_EQUAL(30, value);
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(Future, GetTimeout)
+{
+    Runner r;
+    Promise<uint32_t> promise;
+    uint32_t value = 0;
+
+    g_FutureRelaxCpuContext = FutureRelaxCpuContext();
+    g_FutureRelaxCpuContext.platform = r.platform;
+    g_FutureRelaxCpuContext.promise  = &promise;
+    g_FutureRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = FutureRelaxCpu;
+
+    CHECK_FALSE(promise.GetFuture().Get(value, 10));
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(10, g_FutureRelaxCpuContext.counter);
+    CHECK_EQUAL(0, value);
+    CHECK_FALSE(promise.IsReady());
+}
+
+TEST(Future, GetTimeoutNotExtended)
+{
+    Runner r;
+    Promise<uint32_t> promise;
+    uint32_t value = 0;
+
+    g_FutureRelaxCpuContext = FutureRelaxCpuContext();
+    g_FutureRelaxCpuContext.platform = r.platform;
+    g_FutureRelaxCpuContext.promise  = &promise;
+    g_FutureRelaxCpuContext.notify   = &r.task1;
+    g_FutureRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = FutureRelaxCpu;
+
+    // task is woken up on every tick but waits for the remaining time only
+    CHECK_FALSE(promise.GetFuture().Get(value, 10));
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(10, g_FutureRelaxCpuContext.counter);
+    CHECK_FALSE(promise.IsReady());
+}
+
+// Continuation which completes the next Promise with a transformed value.
+struct ChainContinuation : public Continuation<uint32_t>
+{
+    ChainContinuation() : next(NULL), calls(0), order(0) {}
+
+    void OnReady(const uint32_t &value)
+    {
+        order = ++g_Order;
+        ++calls;
+
+        if (next != NULL)
+            next->Set(value + 1);
+    }
+
+    static uint32_t g_Order;
+
+    Promise<uint32_t> *next;
+    uint32_t           calls;
+    uint32_t           order;
+};
+
+uint32_t ChainContinuation::g_Order = 0;
+
+TEST(Future, Continuation)
+{
+    Runner r;
+    Promise<uint32_t> first, second;
+    ChainContinuation cont1, cont2, cont3, late;
+    uint32_t value = 0;
+
+    ChainContinuation::g_Order = 0;
+
+    // first -> cont1 -> second, cont2 and cont3 are attached to the same promise
+    cont1.next = &second;
+    first.GetFuture().Then(&cont1);
+    first.GetFuture().Then(&cont2);
+    second.GetFuture().Then(&cont3);
+
+    CHECK_EQUAL(0, cont1.calls);
+
+    first.Set(10);
+
+    CHECK_EQUAL(1, cont1.calls);
+    CHECK_EQUAL(1, cont2.calls);
+    CHECK_EQUAL(1, cont3.calls);
+
+    // order of attachment is kept, chained continuation is called by the first one
+    CHECK_EQUAL(1, cont1.order);
+    CHECK_EQUAL(2, cont3.order);
+    CHECK_EQUAL(3, cont2.order);
+
+    CHECK_TRUE(second.GetFuture().Get(value));
+    CHECK_EQUAL(11, value);
+
+    // continuation attached to the ready promise is called immediately
+    first.GetFuture().Then(&late);
+    CHECK_EQUAL(1, late.calls);
+
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+} // namespace stk
+} // namespace test
@@ -0,0 +1,168 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ================================ IpcEndpoint =============================== //
+// ============================================================================ //
+
+TEST_GROUP(IpcEndpoint)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+typedef IpcEndpoint<uint32_t> Endpoint;
+
+static struct IpcRelaxCpuContext
+{
+    IpcRelaxCpuContext() : counter(0), serve_at(0), call_at(0), stop_at(0), received(0), reply(0), stop_active(0),
+        stop_ticks(0), endpoint(NULL), platform(NULL)
+    {
+        active[0] = active[1] = 0;
+    }
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          serve_at;
+    uint32_t          call_at;
+    uint32_t          stop_at;
+    uint32_t          received;
+    uint32_t          reply;
+    size_t            active[2];
+    size_t            stop_active;
+    int64_t           stop_ticks;
+    Endpoint         *endpoint;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+        {
+            // task which is active when the task acted by the test waits (see IPlatform::Reschedule)
+            stop_active = platform->m_stack_active->SP;
+            stop_ticks  = g_KernelService->GetTicks();
+
+            throw Stop(); // leave infinite wait of the server
+        }
+
+        platform->ProcessTick();
+
+        if (counter <= 2)
+            active[counter - 1] = platform->m_stack_active->SP;
+
+        // act as the server task which became active
+        if (counter == serve_at)
+        {
+            received = endpoint->Receive();
+            endpoint->ReplyWait(received * 2);
+        }
+
+        // act as the client task which became active
+        if (counter == call_at)
+            endpoint->Call(21, reply);
+    }
+}
+g_IpcRelaxCpuContext;
+
+static void IpcRelaxCpu()
+{
+    g_IpcRelaxCpuContext.Process();
+}
+
+TEST(IpcEndpoint, ReplyHandoff)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> client, server, other;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Endpoint endpoint;
+    uint32_t reply = 0;
+
+    kernel.Initialize();
+    kernel.AddTask(&client);
+    kernel.AddTask(&server);
+    kernel.AddTask(&other);
+    kernel.Start();
+
+    g_IpcRelaxCpuContext = IpcRelaxCpuContext();
+    g_IpcRelaxCpuContext.platform = platform;
+    g_IpcRelaxCpuContext.endpoint = &endpoint;
+    g_IpcRelaxCpuContext.serve_at = 1;
+    g_IpcRelaxCpuContext.stop_at  = 1;
+    g_RelaxCpuHandler = IpcRelaxCpu;
+
+    try
+    {
+        // client blocks, server is scheduled, replies and waits for the next call
+        endpoint.Call(10, reply);
+    }
+    catch (IpcRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(10, g_IpcRelaxCpuContext.received);
+    CHECK_EQUAL(20, reply);
+    CHECK_EQUAL(0, endpoint.GetPending());
+
+    // reply switched back to the client directly when server started waiting: other task was skipped and client
+    // resumed without waiting for the next tick
+    CHECK_EQUAL((size_t)server.GetStack(), g_IpcRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)client.GetStack(), g_IpcRelaxCpuContext.stop_active);
+    CHECK_EQUAL(1, (int32_t)g_IpcRelaxCpuContext.stop_ticks);
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(IpcEndpoint, CallHandoff)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> server, client, other;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Endpoint endpoint;
+
+    kernel.Initialize();
+    kernel.AddTask(&server);
+    kernel.AddTask(&client);
+    kernel.AddTask(&other);
+    kernel.Start();
+
+    g_IpcRelaxCpuContext = IpcRelaxCpuContext();
+    g_IpcRelaxCpuContext.platform = platform;
+    g_IpcRelaxCpuContext.endpoint = &endpoint;
+    g_IpcRelaxCpuContext.call_at  = 1;
+    g_IpcRelaxCpuContext.stop_at  = 1;
+    g_RelaxCpuHandler = IpcRelaxCpu;
+
+    try
+    {
+        // server waits, client is scheduled and calls
+        endpoint.Receive();
+    }
+    catch (IpcRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(1, endpoint.GetPending());
+
+    // call switched to the waiting server directly when client started waiting, without waiting for the next tick
+    CHECK_EQUAL((size_t)client.GetStack(), g_IpcRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)server.GetStack(), g_IpcRelaxCpuContext.stop_active);
+    CHECK_EQUAL(1, (int32_t)g_IpcRelaxCpuContext.stop_ticks);
+}
+
+} // namespace stk
+} // namespace test
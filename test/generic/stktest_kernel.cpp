@@ -571,6 +571,49 @@ TEST(Kernel, OnTaskExit)
     CHECK_EQUAL(platform->m_exit_trap, active);
 }
 
+TEST(Kernel, OnTaskExitReschedule)
+{
+    Kernel<KERNEL_DYNAMIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_PRIVILEGED> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    ITaskSwitchStrategy *strategy = ((IKernel &)kernel).GetSwitchStrategy();
+    Stack *&active = platform->m_stack_active;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    int64_t ticks = g_KernelService->GetTicks();
+
+    // task1 exited, kernel switches to task2 without waiting for the tick
+    platform->EventTaskExit(active);
+    platform->EventReschedule();
+
+    CHECK_EQUAL((size_t)task2.GetStack(), active->SP);
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_idle->SP);
+    CHECK_EQUAL(1, platform->m_context_switch_nr);
+    CHECK_EQUAL(ticks, g_KernelService->GetTicks());
+
+    platform->EventTaskExit(active);
+    platform->EventReschedule();
+
+    CHECK_EQUAL((size_t)task3.GetStack(), active->SP);
+
+    // last task exits on the tick (exit from scheduling is made by the ISR)
+    platform->EventTaskExit(active);
+    platform->EventReschedule();
+
+    CHECK_EQUAL((size_t)task3.GetStack(), active->SP);
+    CHECK_EQUAL(2, platform->m_context_switch_nr);
+
+    // slots of the switched out tasks are released when strategy iterates them
+    platform->ProcessTick();
+    CHECK_EQUAL(0, strategy->GetSize());
+    CHECK_EQUAL(platform->m_exit_trap, active);
+}
+
 TEST(Kernel, OnTaskExitUnknownOrNull)
 {
     Kernel<KERNEL_DYNAMIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
@@ -700,6 +743,79 @@ TEST(Kernel, HrtAddNonHrt)
     }
 }
 
+TEST(Kernel, HrtAdmission)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 4, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3, task4;
+    SwitchStrategyRoundRobin *strategy = (SwitchStrategyRoundRobin *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+
+    // task without WCET hint is not accounted by the analysis
+    kernel.AddTask(&task1, 2, 2, 0);
+
+    // U = 75%, job of each task waits for at most one job of the other task with Round-Robin
+    kernel.AddTask(&task2, 4, 4, 0, 1);
+    kernel.AddTask(&task3, 6, 6, 0, 3);
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        // U = 83.3% but job of task2 would wait for the jobs of both other tasks (response is 5 ticks)
+        kernel.AddTask(&task4, 12, 12, 0, 1);
+        CHECK_TEXT(false, "expecting rejection of task which makes task set unschedulable");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+
+    CHECK_EQUAL(3, strategy->GetSize());
+}
+
+TEST(Kernel, HrtAdmissionDeadline)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    SwitchStrategyRoundRobin *strategy = (SwitchStrategyRoundRobin *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1, 4, 4, 0, 2);
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        // U = 100% but with Round-Robin job of task2 waits for the whole job of task1 (response is 4 ticks)
+        kernel.AddTask(&task2, 4, 3, 0, 2);
+        CHECK_TEXT(false, "expecting rejection of task which can not meet its deadline");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+
+    CHECK_EQUAL(1, strategy->GetSize());
+}
+
+TEST(Kernel, HrtTryAddTask)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    SwitchStrategyRoundRobin *strategy = (SwitchStrategyRoundRobin *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    CHECK_TRUE(kernel.TryAddTask(&task1, 4, 4, 0, 2));
+
+    // rejection is reported without assertion
+    CHECK_FALSE(kernel.TryAddTask(&task2, 4, 3, 0, 2));
+    CHECK_EQUAL(1, strategy->GetSize());
+
+    CHECK_TRUE(kernel.TryAddTask(&task2, 4, 4, 0, 2));
+    CHECK_EQUAL(2, strategy->GetSize());
+}
+
 TEST(Kernel, HrtAddNotAllowedForNonHrtMode)
 {
     Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
@@ -859,7 +975,7 @@ TEST(Kernel, HrtTaskExitDuringSleepState)
 
     kernel.Initialize();
     kernel.AddTask(&task1, 1, 1, 0);
-    kernel.AddTask(&task2, 1, 1, 2);
+    kernel.AddTask(&task2, 2, 2, 2); // task2 runs for 2 ticks after wake up, its deadline must not be missed
     kernel.Start();
 
     // task returns (exiting) without calling SwitchToNext
@@ -891,5 +1007,1078 @@ TEST(Kernel, HrtSleepingAwakeningStateChange)
     CHECK_EQUAL(platform->m_stack_active->SP, (size_t)task.GetStack());
 }
 
+TEST(Kernel, HrtMixedAddSoft)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT | KERNEL_MIXED, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_hrt, task_soft;
+    SwitchStrategyRoundRobin *strategy = (SwitchStrategyRoundRobin *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_hrt, 4, 2, 0);
+    kernel.AddTask(&task_soft);
+
+    CHECK_EQUAL(2, strategy->GetSize());
+}
+
+TEST(Kernel, HrtMixedSoftFirstStart)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT | KERNEL_MIXED, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_hrt, task_soft;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_soft);
+    kernel.AddTask(&task_hrt, 4, 2, 0);
+    kernel.Start();
+
+    // HRT task is ready therefore it is preferred to the soft task which was added first
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), platform->m_stack_active->SP);
+
+    // soft task does not preempt running HRT task
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), platform->m_stack_active->SP);
+}
+
+static struct HrtMixedRelaxCpuContext
+{
+    HrtMixedRelaxCpuContext()
+    {
+        counter  = 0;
+        platform = NULL;
+
+        for (uint32_t i = 0; i < ACTIVE_MAX; ++i)
+            active[i] = 0;
+    }
+
+    enum { ACTIVE_MAX = 8 };
+
+    uint32_t          counter;
+    PlatformTestMock *platform;
+    size_t            active[ACTIVE_MAX];
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter < ACTIVE_MAX)
+            active[counter] = platform->m_stack_active->SP;
+
+        ++counter;
+    }
+}
+g_HrtMixedRelaxCpuContext;
+
+static void HrtMixedRelaxCpu()
+{
+    g_HrtMixedRelaxCpuContext.Process();
+}
+
+TEST(Kernel, HrtMixedSoftInSlackTime)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT | KERNEL_MIXED, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_hrt, task_soft;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_hrt, 4, 2, 0);
+    kernel.AddTask(&task_soft);
+    kernel.Start();
+
+    // HRT task works for 1 tick
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), platform->m_stack_active->SP);
+
+    g_HrtMixedRelaxCpuContext = HrtMixedRelaxCpuContext();
+    g_HrtMixedRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = HrtMixedRelaxCpu;
+
+    // HRT task completes its work and waits until its next period
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    // HRT task's job was completed within 2 ticks, then soft task runs in a slack time of 2 ticks, and then
+    // HRT task is released again
+    CHECK_EQUAL(3, g_HrtMixedRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task_soft.GetStack(), g_HrtMixedRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task_soft.GetStack(), g_HrtMixedRelaxCpuContext.active[1]);
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), g_HrtMixedRelaxCpuContext.active[2]);
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+TEST(Kernel, HrtMixedSoftSleep)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT | KERNEL_MIXED, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_hrt, task_soft;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_hrt, 10, 2, 5);
+    kernel.AddTask(&task_soft);
+    kernel.Start(1000);
+
+    // HRT task has a delayed start, soft task is running
+    CHECK_EQUAL((size_t)task_soft.GetStack(), platform->m_stack_active->SP);
+
+    g_HrtMixedRelaxCpuContext = HrtMixedRelaxCpuContext();
+    g_HrtMixedRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = HrtMixedRelaxCpu;
+
+    // soft task is allowed to sleep in KERNEL_MIXED mode
+    g_KernelService->Sleep(2);
+
+    g_RelaxCpuHandler = NULL;
+
+    // no tasks are ready, Kernel enters a sleep state and then wakes the soft task up
+    CHECK_EQUAL(2, g_HrtMixedRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)platform->m_stack_info[STACK_SLEEP_TRAP].stack->SP, g_HrtMixedRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task_soft.GetStack(), g_HrtMixedRelaxCpuContext.active[1]);
+
+    // HRT task is released and preempts the soft task
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task_soft.GetStack(), platform->m_stack_active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), platform->m_stack_active->SP);
+}
+
+TEST(Kernel, HrtDeadlineMissedOnTick)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task, 4, 2, 0);
+    kernel.Start();
+
+    platform->ProcessTick();
+    platform->ProcessTick();
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        // task is never switched out but its overrun is detected on the tick when deadline is exceeded
+        platform->ProcessTick();
+        CHECK_TEXT(false, "expecting assertion when HRT task deadline is missed");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+
+    CHECK_TRUE(platform->m_hard_fault);
+    CHECK_EQUAL(3, task.m_deadline_missed);
+}
+
+TEST(Kernel, HrtDeadlineMissSkipNext)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    task.m_deadline_miss_policy = DEADLINE_MISS_SKIP_NEXT;
+
+    kernel.Initialize();
+    kernel.AddTask(&task, 4, 2, 0);
+    kernel.Start();
+
+    platform->ProcessTick();
+    platform->ProcessTick();
+    platform->ProcessTick();
+
+    // deadline miss is reported but late job continues
+    CHECK_EQUAL(3, task.m_deadline_missed);
+    CHECK_EQUAL((size_t)task.GetStack(), platform->m_stack_active->SP);
+
+    g_HrtMixedRelaxCpuContext = HrtMixedRelaxCpuContext();
+    g_HrtMixedRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = HrtMixedRelaxCpu;
+
+    // late job completes
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    // job completed at the period boundary (tick 4), next job (tick 4) is skipped and task is released at tick 8
+    CHECK_EQUAL(5, g_HrtMixedRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)platform->m_stack_info[STACK_SLEEP_TRAP].stack->SP, g_HrtMixedRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task.GetStack(), g_HrtMixedRelaxCpuContext.active[4]);
+    CHECK_EQUAL(3, task.m_deadline_missed);
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+TEST(Kernel, HrtDeadlineMissRestart)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    task.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+
+    kernel.Initialize();
+    kernel.AddTask(&task, 4, 2, 0);
+    kernel.Start();
+
+    platform->ProcessTick();
+    platform->ProcessTick();
+
+    platform->m_stack_info[STACK_USER_TASK_RESTART].task = NULL;
+
+    // late job is aborted on the tick when deadline is exceeded
+    platform->ProcessTick();
+    CHECK_EQUAL(3, task.m_deadline_missed);
+    CHECK_EQUAL(platform->m_stack_info[STACK_SLEEP_TRAP].stack, platform->m_stack_active);
+    CHECK_TRUE(platform->m_stack_info[STACK_USER_TASK_RESTART].task == NULL);
+
+    // task is restarted from its entry function at its next period
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task.GetStack(), platform->m_stack_active->SP);
+    CHECK_EQUAL(&task, platform->m_stack_info[STACK_USER_TASK_RESTART].task);
+    CHECK_FALSE(platform->m_hard_fault);
+
+    // restarted task has a new job
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL(3, task.m_deadline_missed);
+    CHECK_EQUAL((size_t)task.GetStack(), platform->m_stack_active->SP);
+}
+
+TEST(Kernel, HrtDeadlineMissDemote)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    task1.m_deadline_miss_policy = DEADLINE_MISS_DEMOTE;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1, 4, 1, 0);
+    kernel.AddTask(&task2, 4, 1, 2);
+    kernel.Start();
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // task1 is demoted and HRT task2 preempts it
+    platform->ProcessTick();
+    CHECK_EQUAL(2, task1.m_deadline_missed);
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+
+    g_HrtMixedRelaxCpuContext = HrtMixedRelaxCpuContext();
+    g_HrtMixedRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = HrtMixedRelaxCpu;
+
+    // task2 completes its job
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    // demoted task1 runs in the slack time of task2 until task2 is released again
+    CHECK_EQUAL(4, g_HrtMixedRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task1.GetStack(), g_HrtMixedRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task1.GetStack(), g_HrtMixedRelaxCpuContext.active[2]);
+    CHECK_EQUAL((size_t)task2.GetStack(), g_HrtMixedRelaxCpuContext.active[3]);
+    CHECK_EQUAL(2, task1.m_deadline_missed);
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+TEST(Kernel, BudgetIsolation)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_bursty, task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_bursty);
+    kernel.AddTask(&task);
+    kernel.SetTaskBudget(&task_bursty, 1, 4);
+    kernel.Start();
+
+    uint32_t bursty_ticks = 0, task_ticks = 0;
+
+    // bursty task never yields but gets only 1 tick of every 4 ticks instead of a half of CPU time
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        if (platform->m_stack_active->SP == (size_t)task_bursty.GetStack())
+            ++bursty_ticks;
+        else
+        if (platform->m_stack_active->SP == (size_t)task.GetStack())
+            ++task_ticks;
+
+        platform->ProcessTick();
+    }
+
+    CHECK_EQUAL(4, bursty_ticks);
+    CHECK_EQUAL(12, task_ticks);
+}
+
+TEST(Kernel, BudgetThrottle)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.SetTaskBudget(&task, 2, 5);
+    kernel.Start();
+
+    const size_t trap = platform->m_stack_info[STACK_SLEEP_TRAP].stack->SP;
+
+    // budget of 2 ticks is exhausted, Kernel sleeps until budget is replenished at the next period
+    const size_t expect[] = {
+        (size_t)task.GetStack(), (size_t)task.GetStack(), trap, trap, trap, // 0 - 4
+        (size_t)task.GetStack(), (size_t)task.GetStack(), trap, trap, trap, // 5 - 9
+        (size_t)task.GetStack()                                             // 10
+    };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+}
+
+TEST(Kernel, BudgetSleepLongerThanPeriod)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.SetTaskBudget(&task, 1, 2);
+    kernel.Start(1000);
+
+    g_HrtMixedRelaxCpuContext = HrtMixedRelaxCpuContext();
+    g_HrtMixedRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = HrtMixedRelaxCpu;
+
+    // task exhausts its budget when going to sleep but its own sleep is not shortened by replenishment
+    g_KernelService->Sleep(5);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(5, g_HrtMixedRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task.GetStack(), platform->m_stack_active->SP);
+}
+
+TEST(Kernel, BudgetFailHrt)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+
+    kernel.Initialize();
+    kernel.AddTask(&task, 4, 2, 0);
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.SetTaskBudget(&task, 1, 4);
+        CHECK_TEXT(false, "budget is not supported for HRT tasks");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(Kernel, BudgetFailMixedHrtTask)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT | KERNEL_MIXED, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_hrt, task_soft;
+
+    kernel.Initialize();
+    kernel.AddTask(&task_hrt, 4, 2, 0);
+    kernel.AddTask(&task_soft);
+
+    // soft task of the mixed mode can have a budget
+    kernel.SetTaskBudget(&task_soft, 1, 4);
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.SetTaskBudget(&task_hrt, 1, 4);
+        CHECK_TEXT(false, "budget is not supported for HRT tasks");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+static struct WaitRelaxCpuContext
+{
+    WaitRelaxCpuContext() : counter(0), notify_at(0), notify(NULL), platform(NULL), active(0) {}
+
+    uint32_t          counter;
+    uint32_t          notify_at;
+    ITask            *notify;
+    PlatformTestMock *platform;
+    size_t            active;
+
+    void Process()
+    {
+        platform->ProcessTick();
+        ++counter;
+
+        if (counter == 1)
+            active = platform->m_stack_active->SP;
+
+        if ((notify != NULL) && (counter == notify_at))
+            g_KernelService->Notify(notify);
+    }
+}
+g_WaitRelaxCpuContext;
+
+static void WaitRelaxCpu()
+{
+    g_WaitRelaxCpuContext.Process();
+}
+
+TEST(Kernel, WaitNotify)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    CHECK_EQUAL(&task1, g_KernelService->GetCurrentTask());
+
+    g_WaitRelaxCpuContext = WaitRelaxCpuContext();
+    g_WaitRelaxCpuContext.platform  = platform;
+    g_WaitRelaxCpuContext.notify    = &task1;
+    g_WaitRelaxCpuContext.notify_at = 3;
+    g_RelaxCpuHandler = WaitRelaxCpu;
+
+    // waiting task is not scheduled until notified
+    CHECK_TRUE(g_KernelService->Wait(WAIT_INFINITE));
+
+    CHECK_EQUAL(3, g_WaitRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task2.GetStack(), g_WaitRelaxCpuContext.active);
+
+    // pending notification is consumed without waiting (by the task which is active now)
+    ITask *active = g_KernelService->GetCurrentTask();
+    CHECK_TRUE(active != NULL);
+    g_KernelService->Notify(active);
+    g_WaitRelaxCpuContext = WaitRelaxCpuContext();
+    g_WaitRelaxCpuContext.platform = platform;
+
+    CHECK_TRUE(g_KernelService->Wait(WAIT_INFINITE));
+    CHECK_EQUAL(0, g_WaitRelaxCpuContext.counter);
+
+    // timeout
+    CHECK_FALSE(g_KernelService->Wait(2));
+    CHECK_EQUAL(2, g_WaitRelaxCpuContext.counter);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(Kernel, WaitHrtNotAllowed)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+
+    kernel.Initialize();
+    kernel.AddTask(&task, 1, 1, 0);
+    kernel.Start();
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        g_KernelService->Wait(1);
+        CHECK_TEXT(false, "IKernelService::Wait not allowed in HRT mode");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+static struct HandoffRelaxCpuContext
+{
+    HandoffRelaxCpuContext() : counter(0), target(NULL), platform(NULL)
+    {
+        active[0] = active[1] = active[2] = 0;
+    }
+
+    uint32_t          counter;
+    ITask            *target;
+    PlatformTestMock *platform;
+    size_t            active[3];
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter < 3)
+            active[counter] = platform->m_stack_active->SP;
+
+        // hand over to the task which is waiting
+        if (++counter == 1)
+            g_KernelService->Handoff(target);
+    }
+}
+g_HandoffRelaxCpuContext;
+
+static void HandoffRelaxCpu()
+{
+    g_HandoffRelaxCpuContext.Process();
+}
+
+TEST(Kernel, Handoff)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // directed switch bypasses the strategy (task2 is next in the round-robin order)
+    g_KernelService->Handoff(&task3);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+
+    // hint is consumed, strategy continues from the new task
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // hint is ignored if task is not ready to run
+    g_HandoffRelaxCpuContext = HandoffRelaxCpuContext();
+    g_HandoffRelaxCpuContext.platform = platform;
+    g_HandoffRelaxCpuContext.target   = &task1;
+    g_RelaxCpuHandler = HandoffRelaxCpu;
+
+    CHECK_FALSE(g_KernelService->Wait(3));
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(3, g_HandoffRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task2.GetStack(), g_HandoffRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task3.GetStack(), g_HandoffRelaxCpuContext.active[1]);
+    CHECK_EQUAL((size_t)task1.GetStack(), g_HandoffRelaxCpuContext.active[2]);
+}
+
+TEST(Kernel, SuspendResume)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    ITaskSwitchStrategy *strategy = ((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // task which is not running is taken off the strategy immediately
+    kernel.Suspend(&task2);
+    CHECK_EQUAL(2, strategy->GetSize());
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // suspended task is not scheduled until resumed
+    kernel.Suspend(&task2);
+    kernel.Resume(&task2);
+    CHECK_EQUAL(3, strategy->GetSize());
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+static struct SuspendRelaxCpuContext
+{
+    SuspendRelaxCpuContext() : counter(0), resume_at(0), task(NULL), kernel(NULL), platform(NULL)
+    {
+        active[0] = active[1] = active[2] = 0;
+        size[0] = size[1] = size[2] = 0;
+    }
+
+    uint32_t          counter;
+    uint32_t          resume_at;
+    ITask            *task;
+    IKernel          *kernel;
+    PlatformTestMock *platform;
+    size_t            active[3];
+    size_t            size[3];
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter < 3)
+        {
+            active[counter] = platform->m_stack_active->SP;
+            size[counter]   = kernel->GetSwitchStrategy()->GetSize();
+        }
+
+        if (++counter == resume_at)
+            kernel->Resume(task);
+    }
+}
+g_SuspendRelaxCpuContext;
+
+static void SuspendRelaxCpu()
+{
+    g_SuspendRelaxCpuContext.Process();
+}
+
+TEST(Kernel, SuspendSelf)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    g_SuspendRelaxCpuContext = SuspendRelaxCpuContext();
+    g_SuspendRelaxCpuContext.platform  = platform;
+    g_SuspendRelaxCpuContext.kernel    = &kernel;
+    g_SuspendRelaxCpuContext.task      = &task1;
+    g_SuspendRelaxCpuContext.resume_at = 3;
+    g_RelaxCpuHandler = SuspendRelaxCpu;
+
+    // running task is taken off the strategy when it is switched out
+    kernel.Suspend(&task1);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(3, g_SuspendRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task2.GetStack(), g_SuspendRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task3.GetStack(), g_SuspendRelaxCpuContext.active[1]);
+    CHECK_EQUAL((size_t)task2.GetStack(), g_SuspendRelaxCpuContext.active[2]);
+    CHECK_EQUAL(2, g_SuspendRelaxCpuContext.size[0]);
+    CHECK_EQUAL(2, g_SuspendRelaxCpuContext.size[2]);
+    CHECK_EQUAL(3, ((IKernel &)kernel).GetSwitchStrategy()->GetSize());
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(Kernel, SuspendHrtNotAllowed)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+
+    kernel.Initialize();
+    kernel.AddTask(&task, 1, 1, 0);
+    kernel.Start();
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.Suspend(&task);
+        CHECK_TEXT(false, "expecting assertion when suspending HRT task");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(Kernel, Kill)
+{
+    Kernel<KERNEL_DYNAMIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    ITaskSwitchStrategy *strategy = ((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    // task which is not running is removed immediately
+    kernel.Kill(&task2);
+    CHECK_EQUAL(2, strategy->GetSize());
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+
+    // suspended task is removed too
+    kernel.Suspend(&task1);
+    kernel.Kill(&task1);
+    CHECK_EQUAL(1, strategy->GetSize());
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+static struct KillRelaxCpuContext
+{
+    KillRelaxCpuContext() : counter(0), stop_at(0), platform(NULL) {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          stop_at;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop(); // leave infinite loop of the killed task
+
+        platform->ProcessTick();
+    }
+}
+g_KillRelaxCpuContext;
+
+static void KillRelaxCpu()
+{
+    g_KillRelaxCpuContext.Process();
+}
+
+TEST(Kernel, KillSelf)
+{
+    Kernel<KERNEL_DYNAMIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    g_KillRelaxCpuContext = KillRelaxCpuContext();
+    g_KillRelaxCpuContext.platform = platform;
+    g_KillRelaxCpuContext.stop_at  = 3;
+    g_RelaxCpuHandler = KillRelaxCpu;
+
+    try
+    {
+        kernel.Kill(&task1);
+        CHECK_TEXT(false, "expecting killed task to not return");
+    }
+    catch (KillRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    // task was switched out and removed when iterated next time
+    CHECK_EQUAL(2, ((IKernel &)kernel).GetSwitchStrategy()->GetSize());
+    CHECK_TRUE(platform->m_stack_active->SP != (size_t)task1.GetStack());
+}
+
+static struct JoinRelaxCpuContext
+{
+    JoinRelaxCpuContext() : counter(0), stop_at(0), notify_at(0), exited(false), exit_code(0), task(NULL),
+        notify(NULL), platform(NULL)
+    {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          stop_at;
+    uint32_t          notify_at;
+    bool              exited;
+    int32_t           exit_code;
+    ITask            *task;
+    ITask            *notify;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop();
+
+        platform->ProcessTick();
+
+        // act as the task which became active: its Run function returns
+        if ((task != NULL) && !exited && (platform->m_stack_active->SP == (size_t)task->GetStack()))
+        {
+            g_KernelService->SetExitCode(exit_code);
+            platform->EventTaskExit(platform->m_stack_active);
+            exited = true;
+        }
+
+        // stale notification of the joining task
+        if (counter == notify_at)
+            g_KernelService->Notify(notify);
+    }
+}
+g_JoinRelaxCpuContext;
+
+static void JoinRelaxCpu()
+{
+    g_JoinRelaxCpuContext.Process();
+}
+
+TEST(Kernel, Join)
+{
+    Kernel<KERNEL_DYNAMIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    int32_t exit_code = 0;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    g_JoinRelaxCpuContext = JoinRelaxCpuContext();
+    g_JoinRelaxCpuContext.platform  = platform;
+    g_JoinRelaxCpuContext.task      = &task2;
+    g_JoinRelaxCpuContext.exit_code = 7;
+    g_JoinRelaxCpuContext.stop_at   = 10;
+    g_RelaxCpuHandler = JoinRelaxCpu;
+
+    // task1 waits until task2 exits and its slot is released
+    CHECK_TRUE(kernel.Join(&task2, WAIT_INFINITE, &exit_code));
+    CHECK_TRUE(g_JoinRelaxCpuContext.exited);
+    CHECK_EQUAL(7, exit_code);
+    CHECK_EQUAL(2, ((IKernel &)kernel).GetSwitchStrategy()->GetSize());
+
+    // task which exited already is joined immediately
+    uint32_t counter = g_JoinRelaxCpuContext.counter;
+    CHECK_TRUE(kernel.Join(&task2));
+    CHECK_EQUAL(counter, g_JoinRelaxCpuContext.counter);
+
+    g_RelaxCpuHandler = NULL;
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(Kernel, JoinTimeout)
+{
+    Kernel<KERNEL_DYNAMIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    int32_t exit_code = -1;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    g_JoinRelaxCpuContext = JoinRelaxCpuContext();
+    g_JoinRelaxCpuContext.platform = platform;
+    g_JoinRelaxCpuContext.stop_at  = 10;
+    g_RelaxCpuHandler = JoinRelaxCpu;
+
+    CHECK_FALSE(kernel.Join(&task2, 2, &exit_code));
+    CHECK_EQUAL(-1, exit_code);
+    CHECK_TRUE(g_JoinRelaxCpuContext.counter < 10);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(2, ((IKernel &)kernel).GetSwitchStrategy()->GetSize());
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(Kernel, JoinTimeoutTicks)
+{
+    Kernel<KERNEL_DYNAMIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start(1500);
+
+    g_JoinRelaxCpuContext = JoinRelaxCpuContext();
+    g_JoinRelaxCpuContext.platform  = platform;
+    g_JoinRelaxCpuContext.notify    = &task1;
+    g_JoinRelaxCpuContext.notify_at = 1;
+    g_JoinRelaxCpuContext.stop_at   = 10;
+    g_RelaxCpuHandler = JoinRelaxCpu;
+
+    // 6 ms is 4 ticks of 1.5 ms, wait after the stale notification keeps the deadline without rounding it down
+    CHECK_FALSE(kernel.Join(&task2, 6));
+    CHECK_EQUAL(4, g_JoinRelaxCpuContext.counter);
+    CHECK_EQUAL(4, g_KernelService->GetTicks());
+
+    g_RelaxCpuHandler = NULL;
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+static struct KillJoinerRelaxCpuContext
+{
+    KillJoinerRelaxCpuContext() : counter(0), kill_at(0), kernel(NULL), joiner(NULL), platform(NULL) {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          kill_at;
+    IKernel          *kernel;
+    ITask            *joiner;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        // another task kills the joining task, killed task never returns from Join
+        if (++counter == kill_at)
+        {
+            kernel->Kill(joiner);
+            throw Stop();
+        }
+    }
+}
+g_KillJoinerRelaxCpuContext;
+
+static void KillJoinerRelaxCpu()
+{
+    g_KillJoinerRelaxCpuContext.Process();
+}
+
+TEST(Kernel, JoinerKilled)
+{
+    Kernel<KERNEL_DYNAMIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    g_KillJoinerRelaxCpuContext = KillJoinerRelaxCpuContext();
+    g_KillJoinerRelaxCpuContext.platform = platform;
+    g_KillJoinerRelaxCpuContext.kernel   = &kernel;
+    g_KillJoinerRelaxCpuContext.joiner   = &task1;
+    g_KillJoinerRelaxCpuContext.kill_at  = 2;
+    g_RelaxCpuHandler = KillJoinerRelaxCpu;
+
+    try
+    {
+        kernel.Join(&task2);
+        CHECK_TEXT(false, "expecting killed task to not return");
+    }
+    catch (KillJoinerRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(2, ((IKernel &)kernel).GetSwitchStrategy()->GetSize());
+
+    while (platform->m_stack_active->SP != (size_t)task3.GetStack())
+        platform->ProcessTick();
+
+    g_JoinRelaxCpuContext = JoinRelaxCpuContext();
+    g_JoinRelaxCpuContext.platform = platform;
+    g_JoinRelaxCpuContext.stop_at  = 10;
+    g_RelaxCpuHandler = JoinRelaxCpu;
+
+    // request of the killed task is cancelled, task2 can be joined by another task
+    CHECK_FALSE(kernel.Join(&task2, 2));
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(Kernel, Restart)
+{
+    Kernel<KERNEL_DYNAMIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    ITaskSwitchStrategy *strategy = ((IKernel &)kernel).GetSwitchStrategy();
+    Stack *&active = platform->m_stack_active;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    // task1 exited, it is pending removal when switched out
+    platform->EventTaskExit(active);
+    platform->EventReschedule();
+    CHECK_EQUAL((size_t)task2.GetStack(), active->SP);
+
+    task1.GetStack()[1] = 0x1234;
+
+    // exited task keeps its slot, only initial frame is rebuilt (stack memory is not refilled)
+    CHECK_TRUE(kernel.Restart(&task1));
+    CHECK_EQUAL(&task1, platform->m_stack_info[STACK_USER_TASK_RESTART].task);
+    CHECK_EQUAL(0x1234, task1.GetStack()[1]);
+    CHECK_EQUAL(3, strategy->GetSize());
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), active->SP);
+    CHECK_EQUAL(3, strategy->GetSize());
+
+    // suspended task is put back on the strategy
+    kernel.Suspend(&task3);
+    CHECK_EQUAL(2, strategy->GetSize());
+    CHECK_TRUE(kernel.Restart(&task3));
+    CHECK_EQUAL(3, strategy->GetSize());
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task2.GetStack(), active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), active->SP);
+
+    // task which slot is released must be added again
+    kernel.Kill(&task1);
+    CHECK_FALSE(kernel.Restart(&task1));
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(Kernel, RestartRunningTaskNotAllowed)
+{
+    Kernel<KERNEL_DYNAMIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.Restart(&task1);
+        CHECK_TEXT(false, "expecting assertion when restarting running task");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
 } // namespace stk
 } // namespace test
@@ -350,5 +350,56 @@ TEST(KernelService, SleepAllAndWake)
     g_RelaxCpuHandler = NULL;
 }
 
+static struct SleepUntilRelaxCpuContext
+{
+    SleepUntilRelaxCpuContext() : counter(0), platform(NULL) {}
+
+    uint32_t          counter;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        platform->ProcessTick();
+        ++counter;
+    }
+}
+g_SleepUntilRelaxCpuContext;
+
+static void SleepUntilRelaxCpu()
+{
+    g_SleepUntilRelaxCpuContext.Process();
+}
+
+TEST(KernelService, SleepUntil)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    g_SleepUntilRelaxCpuContext = SleepUntilRelaxCpuContext();
+    g_SleepUntilRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = SleepUntilRelaxCpu;
+
+    int64_t wake = g_KernelService->GetTicks() + 5;
+
+    // task1 wakes up at the absolute tick
+    g_KernelService->SleepUntil(wake);
+    CHECK_EQUAL(wake, g_KernelService->GetTicks());
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // tick which is reached already does not put task into a sleep state
+    g_KernelService->SleepUntil(wake);
+    CHECK_EQUAL(5, g_SleepUntilRelaxCpuContext.counter);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
 } // namespace stk
 } // namespace test
@@ -0,0 +1,207 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ==================================== Rcu =================================== //
+// ============================================================================ //
+
+TEST_GROUP(Rcu)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+static struct RcuRelaxCpuContext
+{
+    RcuRelaxCpuContext() : counter(0), stop_at(0), yield_mask(0), platform(NULL), service(NULL)
+    {
+        tasks[0] = tasks[1] = NULL;
+    }
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          stop_at;
+    uint32_t          yield_mask;
+    ITask            *tasks[2];
+    PlatformTestMock *platform;
+    IKernelService   *service;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop();
+
+        platform->ProcessTick();
+
+        // act as the reader task which became active: give CPU up voluntarily if allowed
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            if ((yield_mask & (1 << i)) && (platform->m_stack_active->SP == (size_t)tasks[i]->GetStack()))
+                service->Wait(0);
+        }
+    }
+}
+g_RcuRelaxCpuContext;
+
+static void RcuRelaxCpu()
+{
+    g_RcuRelaxCpuContext.Process();
+}
+
+TEST(Rcu, GracePeriod)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> writer, reader1, reader2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&writer);
+    kernel.AddTask(&reader1);
+    kernel.AddTask(&reader2);
+    kernel.Start();
+
+    IKernelService *service = Singleton<IKernelService *>::Get();
+
+    uint32_t gp = Rcu::StartGracePeriod();
+    CHECK_FALSE(Rcu::IsCompleted(gp));
+
+    // preemption is not a quiescent state
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)reader1.GetStack(), platform->m_stack_active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)reader2.GetStack(), platform->m_stack_active->SP);
+    CHECK_FALSE(Rcu::IsCompleted(gp));
+
+    service->Wait(0);
+    CHECK_FALSE(Rcu::IsCompleted(gp));
+
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)reader1.GetStack(), platform->m_stack_active->SP);
+
+    // request made while grace period is running waits for the next one
+    uint32_t gp_next = Rcu::StartGracePeriod();
+    CHECK_EQUAL(gp + 1, gp_next);
+
+    service->Wait(0);
+    CHECK_TRUE(Rcu::IsCompleted(gp));
+    CHECK_FALSE(Rcu::IsCompleted(gp_next));
+
+    // next grace period started when the previous one completed
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)reader2.GetStack(), platform->m_stack_active->SP);
+    service->Wait(0);
+    CHECK_FALSE(Rcu::IsCompleted(gp_next));
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)writer.GetStack(), platform->m_stack_active->SP);
+    service->Wait(0);
+    CHECK_TRUE(Rcu::IsCompleted(gp_next));
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(Rcu, Synchronize)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> writer, reader1, reader2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    uint32_t versions[2] = { 1, 2 };
+    RcuPointer<uint32_t> ptr(&versions[0]);
+
+    kernel.Initialize();
+    kernel.AddTask(&writer);
+    kernel.AddTask(&reader1);
+    kernel.AddTask(&reader2);
+    kernel.Start();
+
+    g_RcuRelaxCpuContext = RcuRelaxCpuContext();
+    g_RcuRelaxCpuContext.platform   = platform;
+    g_RcuRelaxCpuContext.service    = Singleton<IKernelService *>::Get();
+    g_RcuRelaxCpuContext.tasks[0]   = &reader1;
+    g_RcuRelaxCpuContext.tasks[1]   = &reader2;
+    g_RcuRelaxCpuContext.yield_mask = 1 | 2;
+    g_RcuRelaxCpuContext.stop_at    = 100;
+    g_RelaxCpuHandler = RcuRelaxCpu;
+
+    // readers give CPU up, old version is released
+    CHECK_EQUAL(&versions[0], ptr.Update(&versions[1]));
+    CHECK_EQUAL(&versions[1], ptr.Read());
+    CHECK_TRUE(g_RcuRelaxCpuContext.counter < 100);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+static uint32_t g_RcuFreed = 0;
+
+static void RcuFree(void *ptr)
+{
+    ++(*(uint32_t *)ptr);
+    ++g_RcuFreed;
+}
+
+TEST(Rcu, RetireList)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> writer, reader;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    RcuRetireList<2> list;
+    uint32_t versions[3] = {};
+
+    kernel.Initialize();
+    kernel.AddTask(&writer);
+    kernel.AddTask(&reader);
+    kernel.Start();
+
+    IKernelService *service = Singleton<IKernelService *>::Get();
+
+    g_RcuFreed = 0;
+
+    CHECK_TRUE(list.Retire(&versions[0], RcuFree));
+    CHECK_TRUE(list.Retire(&versions[1], RcuFree));
+    CHECK_FALSE(list.Retire(&versions[2], RcuFree));
+    CHECK_EQUAL(2, list.GetPending());
+
+    // nothing is reclaimed before grace period completes
+    CHECK_EQUAL(0, list.Reclaim());
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)reader.GetStack(), platform->m_stack_active->SP);
+    service->Wait(0);
+
+    CHECK_EQUAL(1, list.Reclaim());
+    CHECK_EQUAL(1, versions[0]);
+    CHECK_EQUAL(0, versions[1]);
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)writer.GetStack(), platform->m_stack_active->SP);
+    service->Wait(0);
+
+    CHECK_TRUE(list.Retire(&versions[2], RcuFree));
+    CHECK_EQUAL(1, list.Reclaim());
+    CHECK_EQUAL(1, versions[1]);
+
+    platform->ProcessTick();
+    service->Wait(0);
+
+    CHECK_EQUAL(1, list.Reclaim());
+    CHECK_EQUAL(1, versions[2]);
+    CHECK_EQUAL(0, list.GetPending());
+    CHECK_EQUAL(3, g_RcuFreed);
+}
+
+} // namespace stk
+} // namespace test
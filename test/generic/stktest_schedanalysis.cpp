@@ -0,0 +1,131 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ============================== SchedAnalysis =============================== //
+// ============================================================================ //
+
+TEST_GROUP(SchedAnalysis)
+{
+    void setup() {}
+    void teardown() {}
+
+    // U = 83.3% exceeds Liu & Layland bound but is schedulable by RTA with Rate-Monotonic
+    typedef SchedTaskList<SchedTask<4, 1>, SchedTask<6, 2>, SchedTask<12, 3> > TaskSetRta;
+
+    // U = 100%, unschedulable with Rate-Monotonic and Round-Robin
+    typedef SchedTaskList<SchedTask<4, 2>, SchedTask<6, 3> > TaskSetFull;
+
+    // U > 100%
+    typedef SchedTaskList<SchedTask<4, 2>, SchedTask<6, 4> > TaskSetOverload;
+};
+
+TEST(SchedAnalysis, Utilization)
+{
+    const SchedTaskInfo tasks[] = { { 4, 1, 4 }, { 6, 2, 6 }, { 12, 3, 12 } };
+
+    CHECK_EQUAL(250000, SchedAnalysis::GetUtilization(tasks[0]));
+    CHECK_EQUAL(333334, SchedAnalysis::GetUtilization(tasks[1])); // rounded up
+    CHECK_EQUAL(833334, SchedAnalysis::GetUtilization(tasks, 3));
+    CHECK_EQUAL(0, SchedAnalysis::GetUtilization(tasks, 0));
+
+    CHECK_EQUAL(833334, TaskSetRta::GetUtilization());
+    CHECK_EQUAL(1000000, TaskSetFull::GetUtilization());
+}
+
+TEST(SchedAnalysis, LiuLaylandBound)
+{
+    CHECK_EQUAL(SchedAnalysis::UTILIZATION_FULL, SchedAnalysis::GetLiuLaylandBound(1));
+    CHECK_EQUAL(828427, SchedAnalysis::GetLiuLaylandBound(2));
+    CHECK_EQUAL(717734, SchedAnalysis::GetLiuLaylandBound(10));
+    CHECK_EQUAL(693147, SchedAnalysis::GetLiuLaylandBound(100));
+
+    // bound is decreasing with the number of tasks towards its limit
+    for (uint32_t i = 1; i <= 10; ++i)
+        CHECK_TRUE(SchedAnalysis::GetLiuLaylandBound(i + 1) < SchedAnalysis::GetLiuLaylandBound(i));
+}
+
+TEST(SchedAnalysis, ResponseTimeRateMonotonic)
+{
+    const SchedTaskInfo tasks[] = { { 4, 1, 4 }, { 6, 2, 6 }, { 12, 3, 12 } };
+
+    CHECK_EQUAL(1, SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, tasks, 3, 0));
+    CHECK_EQUAL(3, SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, tasks, 3, 1));
+    CHECK_EQUAL(10, SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, tasks, 3, 2));
+    CHECK_TRUE(SchedAnalysis::IsSchedulable(SCHED_POLICY_RATE_MONOTONIC, tasks, 3));
+
+    // priority does not depend on the order of tasks
+    const SchedTaskInfo reversed[] = { { 12, 3, 12 }, { 6, 2, 6 }, { 4, 1, 4 } };
+
+    CHECK_EQUAL(10, SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, reversed, 3, 0));
+    CHECK_EQUAL(1, SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, reversed, 3, 2));
+
+    // tighter deadline of the lowest priority task is missed
+    const SchedTaskInfo missed[] = { { 4, 1, 4 }, { 6, 2, 6 }, { 12, 3, 9 } };
+
+    CHECK_TRUE(SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, missed, 3, 2) > 9);
+    CHECK_FALSE(SchedAnalysis::IsSchedulable(SCHED_POLICY_RATE_MONOTONIC, missed, 3));
+}
+
+TEST(SchedAnalysis, ResponseTimeRoundRobin)
+{
+    const SchedTaskInfo tasks[] = { { 4, 1, 4 }, { 6, 3, 6 } };
+
+    // job waits for the whole job of the other task
+    CHECK_EQUAL(4, SchedAnalysis::GetResponseTime(SCHED_POLICY_ROUND_ROBIN, tasks, 2, 0));
+    CHECK_EQUAL(4, SchedAnalysis::GetResponseTime(SCHED_POLICY_ROUND_ROBIN, tasks, 2, 1));
+    CHECK_TRUE(SchedAnalysis::IsSchedulable(SCHED_POLICY_ROUND_ROBIN, tasks, 2));
+
+    // job is not preempted by the rotation, therefore tighter deadline is missed
+    const SchedTaskInfo tight[] = { { 4, 2, 3 }, { 6, 2, 6 } };
+
+    CHECK_EQUAL(4, SchedAnalysis::GetResponseTime(SCHED_POLICY_ROUND_ROBIN, tight, 2, 0));
+    CHECK_FALSE(SchedAnalysis::IsSchedulable(SCHED_POLICY_ROUND_ROBIN, tight, 2));
+
+    // same task set is schedulable with Rate-Monotonic which preempts the job of the lower priority
+    CHECK_EQUAL(4, SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, tight, 2, 1));
+    CHECK_TRUE(SchedAnalysis::IsSchedulable(SCHED_POLICY_RATE_MONOTONIC, tight, 2));
+}
+
+TEST(SchedAnalysis, Overload)
+{
+    const SchedTaskInfo tasks[] = { { 4, 2, 4 }, { 6, 4, 6 } };
+
+    CHECK_FALSE(SchedAnalysis::IsSchedulable(SCHED_POLICY_NONE, tasks, 2));
+    CHECK_FALSE(SchedAnalysis::IsSchedulable(SCHED_POLICY_ROUND_ROBIN, tasks, 2));
+    CHECK_FALSE(SchedAnalysis::IsSchedulable(SCHED_POLICY_RATE_MONOTONIC, tasks, 2));
+
+    // only utilization is checked
+    CHECK_TRUE(SchedAnalysis::IsSchedulable(SCHED_POLICY_NONE, tasks, 1));
+}
+
+TEST(SchedAnalysis, CompileTime)
+{
+    STK_STATIC_ASSERT_N(RTA_RM, TaskSetRta::IsSchedulable(SCHED_POLICY_RATE_MONOTONIC));
+    STK_STATIC_ASSERT_N(RTA_RM_R, TaskSetRta::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, 2) == 10);
+    STK_STATIC_ASSERT_N(FULL_RM, !TaskSetFull::IsSchedulable(SCHED_POLICY_RATE_MONOTONIC));
+    STK_STATIC_ASSERT_N(FULL_RR, !TaskSetFull::IsSchedulable(SCHED_POLICY_ROUND_ROBIN));
+    STK_STATIC_ASSERT_N(FULL_NONE, TaskSetFull::IsSchedulable(SCHED_POLICY_NONE));
+    STK_STATIC_ASSERT_N(OVERLOAD, !TaskSetOverload::IsSchedulable(SCHED_POLICY_NONE));
+
+    // compile-time and run-time results match
+    for (uint32_t i = 0; i < TaskSetRta::SIZE; ++i)
+    {
+        CHECK_EQUAL(SchedAnalysis::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, TaskSetRta::TASKS, TaskSetRta::SIZE, i),
+            TaskSetRta::GetResponseTime(SCHED_POLICY_RATE_MONOTONIC, i));
+    }
+}
+
+} // namespace stk
+} // namespace test
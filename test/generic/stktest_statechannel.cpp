@@ -0,0 +1,136 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ===================== SeqLockChannel, TripleBufferChannel ================== //
+// ============================================================================ //
+
+TEST_GROUP(StateChannel)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+// State which calls a hook in the middle of its copy to emulate preemption of the copying side.
+struct PreemptedState
+{
+    PreemptedState() : a(0), b(0) {}
+    explicit PreemptedState(uint32_t value) : a(value), b(value) {}
+
+    PreemptedState &operator = (const PreemptedState &other)
+    {
+        a = other.a;
+
+        if (g_Hook != NULL)
+        {
+            void (*hook)() = g_Hook;
+            g_Hook = NULL;
+            hook();
+        }
+
+        b = other.b;
+        return *this;
+    }
+
+    bool IsConsistent() const { return (a == b); }
+
+    static void (*g_Hook)();
+
+    uint32_t a, b;
+};
+
+void (*PreemptedState::g_Hook)() = NULL;
+
+static SeqLockChannel<PreemptedState> *g_SeqLock = NULL;
+static PreemptedState g_SeqLockRead;
+static uint32_t g_SeqLockReadSeq = 0;
+
+static void SeqLockReaderPreempts()
+{
+    g_SeqLockReadSeq = g_SeqLock->Read(g_SeqLockRead);
+}
+
+static void SeqLockWriterPreempts()
+{
+    g_SeqLock->Write(PreemptedState(3));
+}
+
+TEST(StateChannel, SeqLock)
+{
+    SeqLockChannel<PreemptedState> channel;
+    PreemptedState value;
+
+    CHECK_EQUAL(0, channel.GetSequence());
+
+    channel.Write(PreemptedState(1));
+    CHECK_EQUAL(1, channel.Read(value));
+    CHECK_EQUAL(1, value.a);
+    CHECK_TRUE(value.IsConsistent());
+
+    g_SeqLock = &channel;
+
+    // reader preempts writer in the middle of the update: previous value is read without waiting
+    PreemptedState::g_Hook = SeqLockReaderPreempts;
+    channel.Write(PreemptedState(2));
+
+    CHECK_TRUE(g_SeqLockRead.IsConsistent());
+    CHECK_EQUAL(1, g_SeqLockRead.a);
+    CHECK_EQUAL(1, g_SeqLockReadSeq);
+
+    // writer preempts reader in the middle of the copy: torn copy is discarded and latest value is read
+    PreemptedState::g_Hook = SeqLockWriterPreempts;
+    CHECK_EQUAL(3, channel.Read(value));
+
+    CHECK_TRUE(value.IsConsistent());
+    CHECK_EQUAL(3, value.a);
+    CHECK_EQUAL(3, channel.GetSequence());
+
+    g_SeqLock = NULL;
+}
+
+TEST(StateChannel, TripleBuffer)
+{
+    TripleBufferChannel<uint32_t> channel;
+
+    CHECK_FALSE(channel.HasNew());
+    CHECK_EQUAL(0, channel.Read());
+
+    channel.Write(1);
+    CHECK_TRUE(channel.HasNew());
+    CHECK_EQUAL(1, channel.GetSequence());
+
+    // reader accesses latest buffer in place
+    const uint32_t &value = channel.Read();
+    CHECK_EQUAL(1, value);
+    CHECK_FALSE(channel.HasNew());
+
+    // writer does not touch buffer which is being read
+    for (uint32_t i = 2; i < 10; ++i)
+    {
+        uint32_t &buffer = channel.BeginWrite();
+        CHECK_TRUE(&buffer != &value);
+
+        buffer = i;
+        channel.EndWrite();
+    }
+
+    CHECK_EQUAL(1, value);
+    CHECK_TRUE(channel.HasNew());
+
+    CHECK_EQUAL(9, channel.Read());
+    CHECK_EQUAL(9, channel.GetSequence());
+}
+
+} // namespace stk
+} // namespace test
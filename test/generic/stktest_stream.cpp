@@ -0,0 +1,235 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// =============================== StreamBuffer =============================== //
+// ============================================================================ //
+
+TEST_GROUP(StreamBuffer)
+{
+    void setup() {}
+    void teardown() {}
+
+    struct Runner
+    {
+        Runner() : platform((PlatformTestMock *)kernel.GetPlatform())
+        {
+            kernel.Initialize();
+            kernel.AddTask(&task1);
+            kernel.AddTask(&task2);
+            kernel.Start();
+        }
+
+        Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+        TaskMock<ACCESS_USER> task1, task2;
+        PlatformTestMock *platform;
+    };
+};
+
+typedef StreamBuffer<8> Stream;
+
+TEST(StreamBuffer, Regions)
+{
+    Runner r;
+    Stream stream;
+    uint8_t *wr;
+    const uint8_t *rd;
+
+    CHECK_EQUAL(0, stream.GetAvailable());
+    CHECK_EQUAL(8, stream.GetFree());
+    CHECK_EQUAL(0, stream.GetReadRegion(&rd));
+
+    // whole buffer is contiguous
+    CHECK_EQUAL(8, stream.GetWriteRegion(&wr));
+    CHECK_EQUAL(0, ((size_t)wr % sizeof(size_t)));
+
+    for (uint32_t i = 0; i < 6; ++i)
+        wr[i] = (uint8_t)i;
+
+    stream.CommitWrite(6);
+    CHECK_EQUAL(6, stream.GetAvailable());
+
+    // read region points to the written data
+    CHECK_EQUAL(6, stream.GetReadRegion(&rd));
+    CHECK_EQUAL(wr, rd);
+    stream.CommitRead(5);
+
+    // free region is limited by the end of the memory
+    CHECK_EQUAL(2, stream.GetWriteRegion(&wr));
+    wr[0] = 6;
+    wr[1] = 7;
+    stream.CommitWrite(2);
+
+    CHECK_EQUAL(5, stream.GetWriteRegion(&wr));
+    wr[0] = 8;
+    stream.CommitWrite(1);
+
+    // read region is limited by the end of the memory, rest is at the start
+    CHECK_EQUAL(3, stream.GetReadRegion(&rd));
+    CHECK_EQUAL(5, rd[0]);
+    CHECK_EQUAL(7, rd[2]);
+    stream.CommitRead(3);
+
+    CHECK_EQUAL(1, stream.GetReadRegion(&rd));
+    CHECK_EQUAL(8, rd[0]);
+}
+
+TEST(StreamBuffer, ReadWrite)
+{
+    Runner r;
+    Stream stream;
+    const uint8_t data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    uint8_t out[10] = {};
+
+    CHECK_EQUAL(5, stream.Write(data, 5));
+    CHECK_EQUAL(3, stream.Read(out, 3));
+
+    // wraps around, capacity is limited
+    CHECK_EQUAL(5, stream.Write(data + 5, 5));
+    CHECK_EQUAL(1, stream.Write(data, 2));
+    CHECK_EQUAL(0, stream.GetFree());
+
+    CHECK_EQUAL(7, stream.Read(out + 3, 7));
+
+    for (uint32_t i = 0; i < 10; ++i)
+        CHECK_EQUAL(data[i], out[i]);
+
+    CHECK_EQUAL(1, stream.Read(out, 10));
+    CHECK_EQUAL(data[0], out[0]);
+    CHECK_EQUAL(0, stream.GetAvailable());
+}
+
+static struct StreamRelaxCpuContext
+{
+    StreamRelaxCpuContext() : counter(0), stop_at(0), write(false), stream(NULL), platform(NULL), notify(NULL) {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          stop_at;
+    bool              write;
+    Stream           *stream;
+    PlatformTestMock *platform;
+    ITask            *notify;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop(); // leave infinite wait
+
+        // simulate stale notification, task is woken up by the tick
+        if (notify != NULL)
+            g_KernelService->Notify(notify);
+
+        platform->ProcessTick();
+
+        // simulate ISR writing or reading one byte per tick
+        uint8_t byte = (uint8_t)counter;
+        if (write)
+            stream->Write(&byte, 1);
+        else
+            stream->Read(&byte, 1);
+    }
+}
+g_StreamRelaxCpuContext;
+
+static void StreamRelaxCpu()
+{
+    g_StreamRelaxCpuContext.Process();
+}
+
+TEST(StreamBuffer, WaitReadable)
+{
+    Runner r;
+    Stream stream;
+
+    g_StreamRelaxCpuContext = StreamRelaxCpuContext();
+    g_StreamRelaxCpuContext.platform = r.platform;
+    g_StreamRelaxCpuContext.stream   = &stream;
+    g_StreamRelaxCpuContext.write    = true;
+    g_StreamRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = StreamRelaxCpu;
+
+    // reader is woken up when trigger level is reached
+    stream.SetTriggerLevel(3);
+    CHECK_TRUE(stream.WaitReadable());
+    CHECK_EQUAL(3, g_StreamRelaxCpuContext.counter);
+    CHECK_EQUAL(3, stream.GetAvailable());
+
+    // explicit number of bytes
+    CHECK_TRUE(stream.WaitReadable(5));
+    CHECK_EQUAL(5, g_StreamRelaxCpuContext.counter);
+
+    // available bytes do not wait
+    CHECK_TRUE(stream.WaitReadable(1));
+    CHECK_EQUAL(5, g_StreamRelaxCpuContext.counter);
+
+    g_StreamRelaxCpuContext.write = false;
+
+    // nothing is written, timeout
+    CHECK_FALSE(stream.WaitReadable(8, 2));
+    CHECK_EQUAL(7, g_StreamRelaxCpuContext.counter);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(StreamBuffer, WaitWritable)
+{
+    Runner r;
+    Stream stream;
+    const uint8_t data[8] = {};
+
+    CHECK_EQUAL(8, stream.Write(data, 8));
+
+    g_StreamRelaxCpuContext = StreamRelaxCpuContext();
+    g_StreamRelaxCpuContext.platform = r.platform;
+    g_StreamRelaxCpuContext.stream   = &stream;
+    g_StreamRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = StreamRelaxCpu;
+
+    // writer is woken up when enough bytes are consumed
+    CHECK_TRUE(stream.WaitWritable(4));
+    CHECK_EQUAL(4, g_StreamRelaxCpuContext.counter);
+    CHECK_EQUAL(4, stream.GetFree());
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(StreamBuffer, WaitTimeoutNotExtended)
+{
+    Runner r;
+    Stream stream;
+
+    g_StreamRelaxCpuContext = StreamRelaxCpuContext();
+    g_StreamRelaxCpuContext.platform = r.platform;
+    g_StreamRelaxCpuContext.stream   = &stream;
+    g_StreamRelaxCpuContext.notify   = &r.task1;
+    g_StreamRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = StreamRelaxCpu;
+
+    // reader is woken up on every tick but waits for the remaining time only
+    CHECK_FALSE(stream.WaitReadable(1, 10));
+    CHECK_EQUAL(10, g_StreamRelaxCpuContext.counter);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+} // namespace stk
+} // namespace test
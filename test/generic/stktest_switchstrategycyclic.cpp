@@ -0,0 +1,324 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ============================ SwitchStrategyCyclic ========================== //
+// ============================================================================ //
+
+TEST_GROUP(SwitchStrategyCyclic)
+{
+    void setup() {}
+    void teardown() {}
+
+    //                     periodicity  WCET  deadline  offset
+    typedef CyclicSchedule<CyclicTask<10,    2,    5,        0>,
+                           CyclicTask<20,    3,    10,       2>,
+                           CyclicTask<40,    4,    20,       5> > Schedule;
+};
+
+TEST(SwitchStrategyCyclic, Hyperperiod)
+{
+    CHECK_EQUAL(3, Schedule::TASKS);
+    CHECK_EQUAL(40, Schedule::HYPERPERIOD);
+
+    CHECK_EQUAL(12, (CyclicSchedule<CyclicTask<4, 1, 1>, CyclicTask<6, 1, 1, 1> >::HYPERPERIOD));
+}
+
+TEST(SwitchStrategyCyclic, Feasibility)
+{
+    CHECK_TRUE((CyclicTaskList<CyclicTask<4, 1, 1, 0>, CyclicTask<4, 1, 1, 1> >::IsFeasible()));
+    CHECK_TRUE((CyclicTaskList<CyclicTask<4, 1, 1, 0>, CyclicTask<6, 1, 1, 1> >::IsFeasible()));
+
+    // overlap at the same release time
+    CHECK_FALSE((CyclicTaskList<CyclicTask<4, 1, 1, 0>, CyclicTask<4, 1, 1, 0> >::IsFeasible()));
+
+    // overlap of the window which is wrapping over the period boundary
+    CHECK_FALSE((CyclicTaskList<CyclicTask<4, 1, 1, 0>, CyclicTask<4, 2, 2, 3> >::IsFeasible()));
+
+    // overlap within hyperperiod only: 0, 4, 8 vs 2, 8
+    CHECK_FALSE((CyclicTaskList<CyclicTask<4, 1, 1, 0>, CyclicTask<6, 1, 1, 2> >::IsFeasible()));
+
+    // overlap at the same release time is resolved by shifting the window within the deadline
+    CHECK_TRUE((CyclicTaskList<CyclicTask<10, 2, 5, 0>, CyclicTask<10, 2, 5, 0> >::IsFeasible()));
+    CHECK_TRUE((CyclicTaskList<CyclicTask<4, 1, 1, 0>, CyclicTask<6, 1, 2, 2> >::IsFeasible()));
+
+    // deadline leaves no room for the shift
+    CHECK_FALSE((CyclicTaskList<CyclicTask<10, 2, 5, 0>, CyclicTask<10, 2, 5, 0>,
+        CyclicTask<10, 2, 5, 0> >::IsFeasible()));
+}
+
+TEST(SwitchStrategyCyclic, Placement)
+{
+    typedef CyclicSchedule<CyclicTask<10, 2, 5, 0>, CyclicTask<10, 2, 5, 0>, CyclicTask<20, 1, 10, 0> > Placed;
+
+    CHECK_EQUAL(0, Placed::GetShift(0));
+    CHECK_EQUAL(2, Placed::GetShift(1));
+    CHECK_EQUAL(4, Placed::GetShift(2));
+
+    // windows of the existing schedule are disjoint already
+    for (uint32_t i = 0; i < Schedule::TASKS; ++i)
+        CHECK_EQUAL(0, Schedule::GetShift(i));
+
+    const uint8_t IDLE = Placed::SLOT_IDLE;
+    const uint8_t expect[Placed::HYPERPERIOD] = {
+        0,    0,    1,    1,    2,    IDLE, IDLE, IDLE, IDLE, IDLE, // 0 - 9
+        0,    0,    1,    1,    IDLE, IDLE, IDLE, IDLE, IDLE, IDLE  // 10 - 19
+    };
+
+    for (uint32_t i = 0; i < Placed::HYPERPERIOD; ++i)
+        CHECK_EQUAL(expect[i], Placed::GetSlot(i));
+}
+
+TEST(SwitchStrategyCyclic, DispatchTable)
+{
+    const uint8_t IDLE = Schedule::SLOT_IDLE;
+    const uint8_t expect[Schedule::HYPERPERIOD] = {
+        0,    0,    1,    1,    1,    2,    2,    2,    2,    IDLE, // 0 - 9
+        0,    0,    IDLE, IDLE, IDLE, IDLE, IDLE, IDLE, IDLE, IDLE, // 10 - 19
+        0,    0,    1,    1,    1,    IDLE, IDLE, IDLE, IDLE, IDLE, // 20 - 29
+        0,    0,    IDLE, IDLE, IDLE, IDLE, IDLE, IDLE, IDLE, IDLE  // 30 - 39
+    };
+
+    for (uint32_t i = 0; i < Schedule::HYPERPERIOD; ++i)
+        CHECK_EQUAL(expect[i], Schedule::GetSlot(i));
+}
+
+TEST(SwitchStrategyCyclic, GetNext)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 3, SwitchStrategyCyclic<Schedule>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    ITaskSwitchStrategy *kstrategy = ((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    Schedule::AddTask(&kernel, 0, &task1);
+    Schedule::AddTask(&kernel, 1, &task2);
+    Schedule::AddTask(&kernel, 2, &task3);
+
+    CHECK_EQUAL(3, kstrategy->GetSize());
+    CHECK_EQUAL(&task1, kstrategy->GetFirst()->GetUserTask());
+
+    kstrategy->OnTick(2);
+    CHECK_EQUAL(&task2, kstrategy->GetNext(NULL)->GetUserTask());
+
+    kstrategy->OnTick(5 + Schedule::HYPERPERIOD);
+    CHECK_EQUAL(&task3, kstrategy->GetNext(NULL)->GetUserTask());
+
+    kstrategy->OnTick(9);
+    CHECK_TRUE(kstrategy->GetNext(NULL) == NULL);
+}
+
+TEST(SwitchStrategyCyclic, AddTaskFailMaxOut)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 4, SwitchStrategyCyclic<Schedule>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3, task4;
+
+    kernel.Initialize();
+    Schedule::AddTask(&kernel, 0, &task1);
+    Schedule::AddTask(&kernel, 1, &task2);
+    Schedule::AddTask(&kernel, 2, &task3);
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.AddTask(&task4, 10, 1, 0);
+        CHECK_TEXT(false, "expecting to fail adding task without descriptor");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(SwitchStrategyCyclic, Dispatch)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 3, SwitchStrategyCyclic<Schedule>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    // jobs never complete, therefore every job overruns its window and is restarted with the next period
+    task1.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+    task2.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+    task3.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+
+    kernel.Initialize();
+    Schedule::AddTask(&kernel, 0, &task1);
+    Schedule::AddTask(&kernel, 1, &task2);
+    Schedule::AddTask(&kernel, 2, &task3);
+    kernel.Start();
+
+    const size_t sleep = platform->m_stack_info[STACK_SLEEP_TRAP].stack->SP;
+    const size_t t1 = (size_t)task1.GetStack(), t2 = (size_t)task2.GetStack(), t3 = (size_t)task3.GetStack();
+
+    // first hyperperiod has the same layout as the dispatch table because all tasks take their whole WCET
+    const size_t expect[] = {
+        t1,    t1,    t2,    t2,    t2,    t3,    t3,    t3,    t3,    sleep, // 0 - 9
+        t1,    t1,    sleep, sleep, sleep, sleep, sleep, sleep, sleep, sleep, // 10 - 19
+        t1,    t1,    t2,    t2,    t2,    sleep                              // 20 - 25
+    };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+
+    // overrun is reported with the duration of the window
+    CHECK_EQUAL(2, task1.m_deadline_missed);
+    CHECK_EQUAL(3, task2.m_deadline_missed);
+    CHECK_EQUAL(4, task3.m_deadline_missed);
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+TEST(SwitchStrategyCyclic, DispatchShifted)
+{
+    typedef CyclicSchedule<CyclicTask<10, 2, 5, 0>, CyclicTask<10, 2, 5, 0> > Placed;
+
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 2, SwitchStrategyCyclic<Placed>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    task1.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+    task2.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+
+    kernel.Initialize();
+    Placed::AddTask(&kernel, 0, &task1);
+    Placed::AddTask(&kernel, 1, &task2);
+    kernel.Start();
+
+    const size_t sleep = platform->m_stack_info[STACK_SLEEP_TRAP].stack->SP;
+    const size_t t1 = (size_t)task1.GetStack(), t2 = (size_t)task2.GetStack();
+
+    // task2 is started at its shifted window and keeps it in the next period
+    const size_t expect[] = {
+        t1,    t1,    t2,    t2,    sleep, sleep, sleep, sleep, sleep, sleep, // 0 - 9
+        t1,    t1,    t2,    t2,    sleep                                     // 10 - 14
+    };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+TEST(SwitchStrategyCyclic, WindowOverrun)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 3, SwitchStrategyCyclic<Schedule>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    Schedule::AddTask(&kernel, 0, &task1);
+    Schedule::AddTask(&kernel, 1, &task2);
+    Schedule::AddTask(&kernel, 2, &task3);
+    kernel.Start();
+
+    platform->ProcessTick();
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        // job of task1 did not complete within its 2-tick window
+        platform->ProcessTick();
+        CHECK_TEXT(false, "expecting assertion when HRT job overruns its window");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+
+    CHECK_TRUE(platform->m_hard_fault);
+    CHECK_EQUAL(2, task1.m_deadline_missed);
+}
+
+static struct CyclicRelaxCpuContext
+{
+    CyclicRelaxCpuContext() : counter(0), platform(NULL)
+    {
+        for (uint32_t i = 0; i < ACTIVE_MAX; ++i)
+            active[i] = 0;
+    }
+
+    enum { ACTIVE_MAX = 16 };
+
+    uint32_t          counter;
+    PlatformTestMock *platform;
+    size_t            active[ACTIVE_MAX];
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter < ACTIVE_MAX)
+            active[counter] = platform->m_stack_active->SP;
+
+        ++counter;
+    }
+}
+g_CyclicRelaxCpuContext;
+
+static void CyclicRelaxCpu()
+{
+    g_CyclicRelaxCpuContext.Process();
+}
+
+TEST(SwitchStrategyCyclic, JobCompletedEarly)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 3, SwitchStrategyCyclic<Schedule>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    // jobs of task2 and task3 never complete
+    task2.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+    task3.m_deadline_miss_policy = DEADLINE_MISS_RESTART;
+
+    kernel.Initialize();
+    Schedule::AddTask(&kernel, 0, &task1);
+    Schedule::AddTask(&kernel, 1, &task2);
+    Schedule::AddTask(&kernel, 2, &task3);
+    kernel.Start();
+
+    g_CyclicRelaxCpuContext = CyclicRelaxCpuContext();
+    g_CyclicRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = CyclicRelaxCpu;
+
+    // task1 completes its job within the first tick of its 2-tick window
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    const size_t sleep = platform->m_stack_info[STACK_SLEEP_TRAP].stack->SP;
+
+    // remaining tick of the window is not given to other task but is idle, other tasks keep their windows,
+    // and then task1 is released again with its next period
+    CHECK_EQUAL(10, g_CyclicRelaxCpuContext.counter);
+    CHECK_EQUAL(sleep, g_CyclicRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task2.GetStack(), g_CyclicRelaxCpuContext.active[1]);
+    CHECK_EQUAL((size_t)task3.GetStack(), g_CyclicRelaxCpuContext.active[4]);
+    CHECK_EQUAL(sleep, g_CyclicRelaxCpuContext.active[8]);
+    CHECK_EQUAL((size_t)task1.GetStack(), g_CyclicRelaxCpuContext.active[9]);
+    CHECK_EQUAL(0, task1.m_deadline_missed);
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+} // namespace stk
+} // namespace test
@@ -0,0 +1,287 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ============================= SwitchStrategyMlfq =========================== //
+// ============================================================================ //
+
+TEST_GROUP(SwitchStrategyMlfq)
+{
+    void setup() {}
+    void teardown() {}
+
+    typedef SwitchStrategyMlfq<3, 100> Strategy;
+};
+
+TEST(SwitchStrategyMlfq, GetFirstEmpty)
+{
+    Strategy mlfq;
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        mlfq.GetFirst();
+        CHECK_TEXT(false, "expecting assertion when empty");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(SwitchStrategyMlfq, AddRemoveTask)
+{
+    Kernel<KERNEL_DYNAMIC, 2, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    Strategy *strategy = (Strategy *)((IKernel &)kernel).GetSwitchStrategy();
+
+    CHECK_EQUAL(1, Strategy::GetQuantum(0));
+    CHECK_EQUAL(4, Strategy::GetQuantum(2));
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+
+    // new tasks start at the highest level
+    CHECK_EQUAL(2, strategy->GetSize());
+    CHECK_EQUAL(&task1, strategy->GetFirst()->GetUserTask());
+    CHECK_EQUAL(0, strategy->GetTaskLevel(strategy->GetFirst()));
+
+    kernel.RemoveTask(&task1);
+
+    CHECK_EQUAL(1, strategy->GetSize());
+    CHECK_EQUAL(&task2, strategy->GetFirst()->GetUserTask());
+}
+
+TEST(SwitchStrategyMlfq, Demotion)
+{
+    Kernel<KERNEL_STATIC, 2, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Strategy *strategy = (Strategy *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    const size_t t1 = (size_t)task1.GetStack(), t2 = (size_t)task2.GetStack();
+
+    // CPU-bound tasks use their whole quanta and are demoted to the levels with longer quanta (1, 2, 4 ticks)
+    const size_t expect[] = { t1, t2, t1, t1, t2, t2, t1, t1, t1, t1, t2, t2, t2, t2, t1 };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+
+    CHECK_EQUAL(2, strategy->GetTaskLevel(strategy->GetFirst()));
+}
+
+static struct MlfqRelaxCpuContext
+{
+    MlfqRelaxCpuContext() : counter(0), platform(NULL)
+    {
+        for (uint32_t i = 0; i < ACTIVE_MAX; ++i)
+            active[i] = 0;
+    }
+
+    enum { ACTIVE_MAX = 8 };
+
+    uint32_t          counter;
+    PlatformTestMock *platform;
+    size_t            active[ACTIVE_MAX];
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter < ACTIVE_MAX)
+            active[counter] = platform->m_stack_active->SP;
+
+        ++counter;
+    }
+}
+g_MlfqRelaxCpuContext;
+
+static void MlfqRelaxCpu()
+{
+    g_MlfqRelaxCpuContext.Process();
+}
+
+TEST(SwitchStrategyMlfq, InteractivePreempts)
+{
+    Kernel<KERNEL_STATIC, 2, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_cpu, task_io;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Strategy *strategy = (Strategy *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_cpu);
+    kernel.AddTask(&task_io);
+    kernel.Start();
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task_io.GetStack(), platform->m_stack_active->SP);
+
+    g_MlfqRelaxCpuContext = MlfqRelaxCpuContext();
+    g_MlfqRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = MlfqRelaxCpu;
+
+    // I/O-bound task waits for the event
+    g_KernelService->Sleep(5);
+
+    g_RelaxCpuHandler = NULL;
+
+    // CPU-bound task is demoted while I/O-bound task sleeps, then I/O-bound task stays at the highest level and
+    // preempts CPU-bound task as soon as it wakes up although quantum of CPU-bound task did not expire yet
+    CHECK_EQUAL(5, g_MlfqRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task_cpu.GetStack(), g_MlfqRelaxCpuContext.active[3]);
+    CHECK_EQUAL((size_t)task_io.GetStack(), g_MlfqRelaxCpuContext.active[4]);
+
+    CHECK_EQUAL(0, strategy->GetTaskLevel(strategy->GetFirst()));
+    CHECK_EQUAL(&task_io, strategy->GetFirst()->GetUserTask());
+}
+
+TEST(SwitchStrategyMlfq, Boost)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyMlfq<3, 4>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    SwitchStrategyMlfq<3, 4> *strategy = (SwitchStrategyMlfq<3, 4> *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    platform->ProcessTick();
+    platform->ProcessTick();
+    platform->ProcessTick();
+
+    // both tasks are demoted
+    CHECK_EQUAL(1, strategy->GetTaskLevel(strategy->GetFirst()));
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // all tasks are boosted to the highest level, running task1 is demoted after its quantum
+    platform->ProcessTick();
+
+    CHECK_EQUAL(&task2, strategy->GetFirst()->GetUserTask());
+    CHECK_EQUAL(0, strategy->GetTaskLevel(strategy->GetFirst()));
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+}
+
+struct MlfqKernelTaskMock : public IKernelTask
+{
+    MlfqKernelTaskMock() : sleeping(false), sleep_checks(0) {}
+
+    ITask *GetUserTask() { return NULL; }
+    Stack *GetUserStack() { return NULL; }
+    bool IsSleeping() const { ++sleep_checks; return sleeping; }
+    uint32_t GetHrtPeriodicity() const { return 0; }
+    uint32_t GetHrtWcet() const { return 0; }
+    uint32_t GetIndex() const { return 0; }
+
+    bool             sleeping;
+    mutable uint32_t sleep_checks;
+};
+
+TEST(SwitchStrategyMlfq, ReadyBitmap)
+{
+    Strategy mlfq;
+    MlfqKernelTaskMock task0, task1, task2;
+
+    mlfq.AddTask(&task0);
+    mlfq.AddTask(&task1);
+    mlfq.AddTask(&task2);
+
+    CHECK_EQUAL(&task0, mlfq.GetFirst());
+
+    mlfq.OnTick(0);
+    CHECK_EQUAL(&task1, mlfq.GetNext(&task0));
+    CHECK_EQUAL(1, mlfq.GetTaskLevel(&task0));
+
+    // sleeping task keeps its level but is not checked on dispatch
+    task1.sleeping = true;
+    mlfq.OnTaskSleep(&task1);
+    task0.sleep_checks = task2.sleep_checks = 0;
+
+    mlfq.OnTick(1);
+    CHECK_EQUAL(&task2, mlfq.GetNext(&task1));
+    CHECK_EQUAL(0, mlfq.GetTaskLevel(&task1));
+
+    mlfq.OnTick(2);
+    CHECK_EQUAL(&task0, mlfq.GetNext(&task2));
+    CHECK_EQUAL(0, task0.sleep_checks);
+
+    // woken task of the higher level preempts
+    task1.sleeping = false;
+    mlfq.OnTaskWake(&task1);
+
+    mlfq.OnTick(3);
+    CHECK_EQUAL(&task1, mlfq.GetNext(&task0));
+    CHECK_EQUAL(0, mlfq.GetTaskLevel(&task1));
+
+    // no ready tasks
+    task0.sleeping = task1.sleeping = task2.sleeping = true;
+    mlfq.OnTaskSleep(&task0);
+    mlfq.OnTaskSleep(&task1);
+    mlfq.OnTaskSleep(&task2);
+
+    mlfq.OnTick(4);
+    CHECK_TRUE(mlfq.GetNext(&task1) == NULL);
+    CHECK_TRUE(mlfq.GetFirst() != NULL);
+
+    // sleeping task is added as not ready
+    MlfqKernelTaskMock task3;
+    task3.sleeping = true;
+    mlfq.AddTask(&task3);
+
+    mlfq.OnTick(5);
+    CHECK_TRUE(mlfq.GetNext(&task3) == NULL);
+
+    mlfq.RemoveTask(&task3);
+    CHECK_EQUAL(3, mlfq.GetSize());
+}
+
+TEST(SwitchStrategyMlfq, OnTaskExit)
+{
+    Kernel<KERNEL_DYNAMIC, 2, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_PRIVILEGED> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    ITaskSwitchStrategy *strategy = ((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    platform->EventTaskExit(platform->m_stack_active);
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL(1, strategy->GetSize());
+
+    platform->EventTaskExit(platform->m_stack_active);
+    platform->ProcessTick();
+
+    CHECK_EQUAL(0, strategy->GetSize());
+    CHECK_EQUAL(platform->m_exit_trap, platform->m_stack_active);
+}
+
+} // namespace stk
+} // namespace test
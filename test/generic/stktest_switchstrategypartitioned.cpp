@@ -0,0 +1,375 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ========================= SwitchStrategyPartitioned ======================== //
+// ============================================================================ //
+
+TEST_GROUP(SwitchStrategyPartitioned)
+{
+    void setup() {}
+    void teardown() {}
+
+    typedef SwitchStrategyPartitioned<
+        PartitionFrame<PartitionWindow<0, 3>, PartitionWindow<1, 2> >,
+        Partition<SwitchStrategyRoundRobin, 2>,
+        Partition<SwitchStrategyRoundRobin, 1> > Strategy;
+
+    typedef SwitchStrategyPartitioned<
+        PartitionFrame<PartitionWindow<0, 2>, PartitionWindow<1, 3, 0> >,
+        Partition<SwitchStrategyRoundRobin, 2>,
+        Partition<SwitchStrategyRoundRobin, 1> > StrategyDonating;
+
+    typedef SwitchStrategyPartitioned<
+        PartitionFrame<PartitionWindow<0, 2>, PartitionWindow<1, 3> >,
+        Partition<SwitchStrategyRoundRobin, 2>,
+        Partition<SwitchStrategyRoundRobin, 1> > StrategyIsolated;
+
+    typedef SwitchStrategyPartitioned<
+        PartitionFrame<PartitionWindow<0, 2>, PartitionWindow<1, 1>, PartitionWindow<2, 1> >,
+        Partition<SwitchStrategyRoundRobin, 2>,
+        Partition<SwitchStrategyRateMonotonic, 1>,
+        Partition<SwitchStrategyRateMonotonic, 1> > StrategyMixed;
+};
+
+TEST(SwitchStrategyPartitioned, Frame)
+{
+    typedef PartitionFrame<PartitionWindow<0, 3>, PartitionWindow<1, 2, 0> > Frame;
+
+    CHECK_EQUAL(2, Frame::WINDOWS);
+    CHECK_EQUAL(0, Frame::GetWindow(0).partition);
+    CHECK_EQUAL(PARTITION_NONE, Frame::GetWindow(0).donee);
+    CHECK_EQUAL(3, Frame::GetWindow(0).duration);
+    CHECK_EQUAL(1, Frame::GetWindow(1).partition);
+    CHECK_EQUAL(0, Frame::GetWindow(1).donee);
+    CHECK_EQUAL(2, Frame::GetWindow(1).duration);
+
+    CHECK_TRUE(Frame::IsValidFor(2));
+    CHECK_FALSE(Frame::IsValidFor(1));
+}
+
+TEST(SwitchStrategyPartitioned, AddTask)
+{
+    Kernel<KERNEL_DYNAMIC, 3, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    Strategy *strategy = (Strategy *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+
+    // tasks are bound to partitions in the order of addition
+    CHECK_EQUAL(3, strategy->GetSize());
+    CHECK_EQUAL(2, strategy->GetPartitionStrategy(0)->GetSize());
+    CHECK_EQUAL(1, strategy->GetPartitionStrategy(1)->GetSize());
+    CHECK_EQUAL(&task1, strategy->GetFirst()->GetUserTask());
+    CHECK_EQUAL(&task3, strategy->GetPartitionStrategy(1)->GetFirst()->GetUserTask());
+
+    kernel.RemoveTask(&task1);
+
+    CHECK_EQUAL(2, strategy->GetSize());
+    CHECK_EQUAL(1, strategy->GetPartitionStrategy(0)->GetSize());
+    CHECK_EQUAL(&task2, strategy->GetFirst()->GetUserTask());
+}
+
+TEST(SwitchStrategyPartitioned, AddTaskFailMaxOut)
+{
+    Kernel<KERNEL_STATIC, 4, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3, task4;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.AddTask(&task4);
+        CHECK_TEXT(false, "expecting to fail adding task exceeding capacity of partitions");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(SwitchStrategyPartitioned, BindTask)
+{
+    Kernel<KERNEL_DYNAMIC, 3, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3, task4;
+    Strategy *strategy = (Strategy *)((IKernel &)kernel).GetSwitchStrategy();
+
+    CHECK_TRUE(strategy->BindTask(&task1, 1));
+    CHECK_FALSE(strategy->BindTask(&task1, 0)); // already bound
+    CHECK_FALSE(strategy->BindTask(&task2, 1)); // no free capacity
+    CHECK_EQUAL(1, strategy->GetTaskPartition(&task1));
+    CHECK_EQUAL(PARTITION_NONE, strategy->GetTaskPartition(&task2));
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+
+    CHECK_EQUAL(2, strategy->GetPartitionStrategy(0)->GetSize());
+    CHECK_EQUAL(&task1, strategy->GetPartitionStrategy(1)->GetFirst()->GetUserTask());
+    CHECK_EQUAL(0, strategy->GetTaskPartition(&task2));
+    CHECK_EQUAL(0, strategy->GetTaskPartition(&task3));
+
+    // binding survives removal, capacity is released by unbinding only
+    kernel.RemoveTask(&task3);
+    CHECK_EQUAL(0, strategy->GetTaskPartition(&task3));
+    CHECK_FALSE(strategy->BindTask(&task4, 0));
+
+    strategy->UnbindTask(&task3);
+    CHECK_EQUAL(PARTITION_NONE, strategy->GetTaskPartition(&task3));
+    CHECK_TRUE(strategy->BindTask(&task4, 0));
+}
+
+TEST(SwitchStrategyPartitioned, SuspendResumeKeepsPartition)
+{
+    Kernel<KERNEL_STATIC, 3, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Strategy *strategy = (Strategy *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // take a task of each partition off the strategy
+    kernel.Suspend(&task2);
+    kernel.Suspend(&task3);
+    CHECK_EQUAL(1, strategy->GetSize());
+    CHECK_EQUAL(0, strategy->GetPartitionStrategy(1)->GetSize());
+
+    // resume in reverse order: tasks must return to their own partitions, not to the first one with free capacity
+    kernel.Resume(&task3);
+    kernel.Resume(&task2);
+
+    CHECK_EQUAL(3, strategy->GetSize());
+    CHECK_EQUAL(2, strategy->GetPartitionStrategy(0)->GetSize());
+    CHECK_EQUAL(1, strategy->GetPartitionStrategy(1)->GetSize());
+    CHECK_EQUAL(&task3, strategy->GetPartitionStrategy(1)->GetFirst()->GetUserTask());
+
+    // window of partition 0 (3 ticks) is followed by the window of partition 1 (2 ticks)
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+}
+
+TEST(SwitchStrategyPartitioned, OnTick)
+{
+    Strategy strategy;
+
+    CHECK_EQUAL(0, strategy.GetPartition());
+
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        strategy.OnTick(0);
+        strategy.OnTick(0);
+        CHECK_EQUAL(0, strategy.GetPartition());
+
+        strategy.OnTick(0);
+        CHECK_EQUAL(1, strategy.GetPartition());
+
+        strategy.OnTick(0);
+        CHECK_EQUAL(1, strategy.GetPartition());
+
+        strategy.OnTick(0);
+        CHECK_EQUAL(0, strategy.GetPartition());
+    }
+}
+
+TEST(SwitchStrategyPartitioned, Dispatch)
+{
+    Kernel<KERNEL_STATIC, 3, Strategy, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    const size_t t1 = (size_t)task1.GetStack(), t2 = (size_t)task2.GetStack(), t3 = (size_t)task3.GetStack();
+
+    // tasks of the partition 0 are switched within its window only, then partition 1 takes its window
+    const size_t expect[] = { t1, t2, t1, t3, t3, t1, t2, t1, t3, t3, t1 };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+}
+
+static struct PartitionedRelaxCpuContext
+{
+    PartitionedRelaxCpuContext() : counter(0), platform(NULL)
+    {
+        for (uint32_t i = 0; i < ACTIVE_MAX; ++i)
+            active[i] = 0;
+    }
+
+    enum { ACTIVE_MAX = 8 };
+
+    uint32_t          counter;
+    PlatformTestMock *platform;
+    size_t            active[ACTIVE_MAX];
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter < ACTIVE_MAX)
+            active[counter] = platform->m_stack_active->SP;
+
+        ++counter;
+    }
+}
+g_PartitionedRelaxCpuContext;
+
+static void PartitionedRelaxCpu()
+{
+    g_PartitionedRelaxCpuContext.Process();
+}
+
+TEST(SwitchStrategyPartitioned, Isolation)
+{
+    Kernel<KERNEL_STATIC, 3, StrategyIsolated, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    const size_t sleep = platform->m_stack_info[STACK_SLEEP_TRAP].stack->SP;
+
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+
+    g_PartitionedRelaxCpuContext = PartitionedRelaxCpuContext();
+    g_PartitionedRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = PartitionedRelaxCpu;
+
+    // task3 sleeps within its window
+    g_KernelService->Sleep(2);
+
+    g_RelaxCpuHandler = NULL;
+
+    // idle time of the window is not given to the tasks of the partition 0
+    CHECK_EQUAL(2, g_PartitionedRelaxCpuContext.counter);
+    CHECK_EQUAL(sleep, g_PartitionedRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task3.GetStack(), g_PartitionedRelaxCpuContext.active[1]);
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+}
+
+TEST(SwitchStrategyPartitioned, Donation)
+{
+    Kernel<KERNEL_STATIC, 3, StrategyDonating, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+
+    g_PartitionedRelaxCpuContext = PartitionedRelaxCpuContext();
+    g_PartitionedRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = PartitionedRelaxCpu;
+
+    // task3 sleeps within its window
+    g_KernelService->Sleep(2);
+
+    g_RelaxCpuHandler = NULL;
+
+    // idle time of the window is donated to the partition 0 until task3 is woken up
+    CHECK_EQUAL(2, g_PartitionedRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task1.GetStack(), g_PartitionedRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task3.GetStack(), g_PartitionedRelaxCpuContext.active[1]);
+
+    // partition 0 takes its own window
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+}
+
+TEST(SwitchStrategyPartitioned, MixedInnerStrategies)
+{
+    Kernel<KERNEL_DYNAMIC, 4, StrategyMixed, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3, task4;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    StrategyMixed *strategy = &kernel.GetStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.AddTask(&task4);
+
+    CHECK_EQUAL(2, strategy->GetPartitionStrategy(0)->GetSize());
+    CHECK_EQUAL(1, strategy->GetPartitionStrategy(1)->GetSize());
+    CHECK_EQUAL(1, strategy->GetPartitionStrategy(2)->GetSize());
+
+    // Rate-Monotonic does not link its tasks into a list, partition is resolved by the table
+    kernel.RemoveTask(&task4);
+    CHECK_EQUAL(1, strategy->GetPartitionStrategy(1)->GetSize());
+    CHECK_EQUAL(0, strategy->GetPartitionStrategy(2)->GetSize());
+
+    kernel.AddTask(&task4);
+    CHECK_EQUAL(1, strategy->GetPartitionStrategy(2)->GetSize());
+
+    kernel.Start();
+
+    const size_t t1 = (size_t)task1.GetStack(), t2 = (size_t)task2.GetStack(), t3 = (size_t)task3.GetStack(),
+        t4 = (size_t)task4.GetStack();
+    const size_t expect[] = { t1, t2, t3, t4, t1, t2, t3, t4 };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+}
+
+} // namespace stk
+} // namespace test
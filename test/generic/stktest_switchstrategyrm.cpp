@@ -0,0 +1,402 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ========================= SwitchStrategyRateMonotonic ====================== //
+// ============================================================================ //
+
+TEST_GROUP(SwitchStrategyRateMonotonic)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(SwitchStrategyRateMonotonic, GetFirstEmpty)
+{
+    SwitchStrategyRateMonotonic rm;
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        rm.GetFirst();
+        CHECK_TEXT(false, "expecting assertion when empty");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(SwitchStrategyRateMonotonic, Priority)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 4, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3, task4;
+    SwitchStrategyRateMonotonic *strategy = (SwitchStrategyRateMonotonic *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1, 12, 12, 0);
+    kernel.AddTask(&task2, 4, 4, 0);
+    kernel.AddTask(&task3, 6, 6, 0);
+    kernel.AddTask(&task4, 4, 4, 0);
+
+    CHECK_EQUAL(4, strategy->GetSize());
+    CHECK_EQUAL(&task2, strategy->GetFirst()->GetUserTask());
+
+    // shorter periodicity - higher priority, equal periodicity - order of addition
+    CHECK_EQUAL(&task2, strategy->GetTask(0)->GetUserTask());
+    CHECK_EQUAL(&task4, strategy->GetTask(1)->GetUserTask());
+    CHECK_EQUAL(&task3, strategy->GetTask(2)->GetUserTask());
+    CHECK_EQUAL(&task1, strategy->GetTask(3)->GetUserTask());
+    CHECK_EQUAL(3, strategy->GetPriority(strategy->GetTask(3)));
+    CHECK_EQUAL(12, strategy->GetTask(3)->GetHrtPeriodicity());
+
+    strategy->OnTick(0);
+    CHECK_EQUAL(&task2, strategy->GetNext(NULL)->GetUserTask());
+
+    SwitchStrategyRateMonotonic rm;
+    CHECK_EQUAL(-1, rm.GetPriority(strategy->GetFirst()));
+}
+
+TEST(SwitchStrategyRateMonotonic, UtilizationBound)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 3, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    SwitchStrategyRateMonotonic *strategy = &kernel.GetStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1, 4, 4, 0, 1);
+    kernel.AddTask(&task2, 6, 6, 0, 2);
+
+    CHECK_EQUAL(583334, strategy->GetUtilization());
+    CHECK_EQUAL(SchedAnalysis::GetLiuLaylandBound(2), strategy->GetUtilizationBound());
+    CHECK_TRUE(strategy->GetUtilization() <= strategy->GetUtilizationBound());
+
+    // exceeds the bound but is admitted by the response-time analysis
+    kernel.AddTask(&task3, 12, 12, 0, 3);
+
+    CHECK_EQUAL(3, strategy->GetSize());
+    CHECK_EQUAL(833334, strategy->GetUtilization());
+    CHECK_EQUAL(SchedAnalysis::GetLiuLaylandBound(3), strategy->GetUtilizationBound());
+    CHECK_TRUE(strategy->GetUtilization() > strategy->GetUtilizationBound());
+}
+
+static struct RmRelaxCpuContext
+{
+    RmRelaxCpuContext() : counter(0), platform(NULL)
+    {
+        for (uint32_t i = 0; i < ACTIVE_MAX; ++i)
+            active[i] = 0;
+    }
+
+    enum { ACTIVE_MAX = 8 };
+
+    uint32_t          counter;
+    PlatformTestMock *platform;
+    size_t            active[ACTIVE_MAX];
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter < ACTIVE_MAX)
+            active[counter] = platform->m_stack_active->SP;
+
+        ++counter;
+    }
+}
+g_RmRelaxCpuContext;
+
+static void RmRelaxCpu()
+{
+    g_RmRelaxCpuContext.Process();
+}
+
+TEST(SwitchStrategyRateMonotonic, Preemption)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 2, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_low, task_high;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_low, 10, 10, 0);
+    kernel.AddTask(&task_high, 4, 4, 1);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)task_low.GetStack(), platform->m_stack_active->SP);
+
+    // higher priority task is released and preempts the running one
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task_high.GetStack(), platform->m_stack_active->SP);
+
+    g_RmRelaxCpuContext = RmRelaxCpuContext();
+    g_RmRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = RmRelaxCpu;
+
+    // task_high completes its job
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    // preempted job of task_low is resumed (not completed) until task_high is released again
+    CHECK_EQUAL(4, g_RmRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task_low.GetStack(), g_RmRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task_low.GetStack(), g_RmRelaxCpuContext.active[2]);
+    CHECK_EQUAL((size_t)task_high.GetStack(), g_RmRelaxCpuContext.active[3]);
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+TEST(SwitchStrategyRateMonotonic, PreemptedDeadlineMissed)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT, 2, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_low, task_high;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_low, 6, 3, 0);
+    kernel.AddTask(&task_high, 3, 3, 1);
+    kernel.Start();
+
+    task_low.m_deadline_miss_policy = DEADLINE_MISS_SKIP_NEXT;
+
+    // task_high preempts task_low and keeps running
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task_high.GetStack(), platform->m_stack_active->SP);
+
+    // job of task_low keeps its start time while preempted, therefore its deadline is missed when it is switched
+    // in again
+    g_RmRelaxCpuContext = RmRelaxCpuContext();
+    g_RmRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = RmRelaxCpu;
+
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL((size_t)task_low.GetStack(), g_RmRelaxCpuContext.active[0]);
+    CHECK_EQUAL(4, task_low.m_deadline_missed); // duration since the start of the job
+    CHECK_FALSE(platform->m_hard_fault);
+}
+
+TEST(SwitchStrategyRateMonotonic, MixedSoftInSlackTime)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT | KERNEL_MIXED, 2, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_hrt, task_soft;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    SwitchStrategyRateMonotonic *strategy = (SwitchStrategyRateMonotonic *)((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_soft);
+    kernel.AddTask(&task_hrt, 4, 4, 0);
+    kernel.Start();
+
+    // soft task has the lowest priority
+    CHECK_EQUAL(&task_hrt, strategy->GetFirst()->GetUserTask());
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), platform->m_stack_active->SP);
+
+    g_RmRelaxCpuContext = RmRelaxCpuContext();
+    g_RmRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = RmRelaxCpu;
+
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    // soft task runs in slack time, then HRT task is released again
+    CHECK_EQUAL(4, g_RmRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task_soft.GetStack(), g_RmRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task_soft.GetStack(), g_RmRelaxCpuContext.active[2]);
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), g_RmRelaxCpuContext.active[3]);
+}
+
+TEST(SwitchStrategyRateMonotonic, MixedSoftRotation)
+{
+    Kernel<KERNEL_STATIC | KERNEL_HRT | KERNEL_MIXED, 3, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task_hrt, task_soft1, task_soft2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task_soft1);
+    kernel.AddTask(&task_soft2);
+    kernel.AddTask(&task_hrt, 5, 5, 0);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), platform->m_stack_active->SP);
+
+    g_RmRelaxCpuContext = RmRelaxCpuContext();
+    g_RmRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = RmRelaxCpu;
+
+    g_KernelService->SwitchToNext();
+
+    g_RelaxCpuHandler = NULL;
+
+    // soft tasks of the same priority level are rotated in slack time
+    CHECK_EQUAL(5, g_RmRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task_soft1.GetStack(), g_RmRelaxCpuContext.active[0]);
+    CHECK_EQUAL((size_t)task_soft2.GetStack(), g_RmRelaxCpuContext.active[1]);
+    CHECK_EQUAL((size_t)task_soft1.GetStack(), g_RmRelaxCpuContext.active[2]);
+    CHECK_EQUAL((size_t)task_soft2.GetStack(), g_RmRelaxCpuContext.active[3]);
+    CHECK_EQUAL((size_t)task_hrt.GetStack(), g_RmRelaxCpuContext.active[4]);
+}
+
+TEST(SwitchStrategyRateMonotonic, SoftRotation)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    SwitchStrategyRateMonotonic *strategy = &kernel.GetStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    const size_t expect[] = {
+        (size_t)task1.GetStack(), (size_t)task2.GetStack(), (size_t)task3.GetStack(), (size_t)task1.GetStack()
+    };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+
+    // sleeping task loses its turn
+    strategy->OnTaskSleep(strategy->GetTask(1));
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task3.GetStack(), platform->m_stack_active->SP);
+
+    // priorities are kept
+    CHECK_EQUAL(0, strategy->GetPriority(strategy->GetTask(0)));
+    CHECK_EQUAL(2, strategy->GetPriority(strategy->GetTask(2)));
+}
+
+struct RmKernelTaskMock : public IKernelTask
+{
+    RmKernelTaskMock(uint32_t _index, uint32_t _periodicity = 0) : index(_index), periodicity(_periodicity),
+        sleeping(false), sleep_checks(0)
+    {}
+
+    ITask *GetUserTask() { return NULL; }
+    Stack *GetUserStack() { return NULL; }
+    bool IsSleeping() const { ++sleep_checks; return sleeping; }
+    uint32_t GetHrtPeriodicity() const { return periodicity; }
+    uint32_t GetHrtWcet() const { return 0; }
+    uint32_t GetIndex() const { return index; }
+
+    uint32_t         index;
+    uint32_t         periodicity;
+    bool             sleeping;
+    mutable uint32_t sleep_checks;
+};
+
+TEST(SwitchStrategyRateMonotonic, ReadyBitmap)
+{
+    SwitchStrategyRateMonotonic strategy;
+    RmKernelTaskMock task0(0, 10), task1(1, 20), task2(2, 30), task_high(3, 2);
+
+    strategy.AddTask(&task0);
+    strategy.AddTask(&task1);
+    strategy.AddTask(&task2);
+
+    CHECK_EQUAL(&task0, strategy.GetNext(&task0));
+
+    // ready set is updated by the notifications, sleeping tasks are not checked on dispatch
+    task0.sleeping = true;
+    strategy.OnTaskSleep(&task0);
+    task1.sleeping = true;
+    strategy.OnTaskSleep(&task1);
+
+    task0.sleep_checks = task1.sleep_checks = task2.sleep_checks = 0;
+
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        strategy.OnTick(i);
+        CHECK_EQUAL(&task2, strategy.GetNext(&task2));
+    }
+
+    CHECK_EQUAL(0, task0.sleep_checks + task1.sleep_checks + task2.sleep_checks);
+
+    task0.sleeping = false;
+    strategy.OnTaskWake(&task0);
+    CHECK_EQUAL(&task0, strategy.GetNext(&task2));
+
+    // ready bits follow priorities when task of a higher priority is added and removed
+    strategy.AddTask(&task_high);
+    CHECK_EQUAL(0, strategy.GetPriority(&task_high));
+    CHECK_EQUAL(&task_high, strategy.GetNext(&task0));
+
+    task_high.sleeping = true;
+    strategy.OnTaskSleep(&task_high);
+    CHECK_EQUAL(&task0, strategy.GetNext(&task_high));
+
+    task0.sleeping = true;
+    strategy.OnTaskSleep(&task0);
+    strategy.OnTick(3);
+    CHECK_EQUAL(&task2, strategy.GetNext(&task0));
+
+    strategy.RemoveTask(&task_high);
+    task1.sleeping = false;
+    strategy.OnTaskWake(&task1);
+    strategy.OnTick(4);
+    CHECK_EQUAL(&task1, strategy.GetNext(&task2));
+
+    // sleeping task is added as not ready
+    RmKernelTaskMock task3(4);
+    task3.sleeping = true;
+    strategy.RemoveTask(&task1);
+    strategy.RemoveTask(&task2);
+    strategy.AddTask(&task3);
+    CHECK_TRUE(strategy.GetNext(&task3) == NULL);
+}
+
+TEST(SwitchStrategyRateMonotonic, OnTaskExit)
+{
+    Kernel<KERNEL_DYNAMIC, 2, SwitchStrategyRateMonotonic, PlatformTestMock> kernel;
+    TaskMock<ACCESS_PRIVILEGED> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    ITaskSwitchStrategy *strategy = ((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    // task1 is the first soft task and starts scheduling
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    // task1 exited, kernel switches to task2 and then removes task1
+    platform->EventTaskExit(platform->m_stack_active);
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+
+    platform->ProcessTick();
+    CHECK_EQUAL(1, strategy->GetSize());
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+
+    // last task exited
+    platform->EventTaskExit(platform->m_stack_active);
+    platform->ProcessTick();
+
+    CHECK_EQUAL(0, strategy->GetSize());
+    CHECK_EQUAL(platform->m_exit_trap, platform->m_stack_active);
+}
+
+} // namespace stk
+} // namespace test
@@ -104,5 +104,103 @@ TEST(SwitchStrategyRoundRobin, EndlessNext)
     CHECK_EQUAL_TEXT(&task2, next->GetUserTask(), "Expecting the next task2 (endless looping)");
 }
 
+TEST(SwitchStrategyRoundRobin, Quantum)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    SwitchStrategyRoundRobin *strategy = (SwitchStrategyRoundRobin *)((IKernel &)kernel).GetSwitchStrategy();
+
+    CHECK_EQUAL(SwitchStrategyRoundRobin::QUANTUM_DEFAULT, strategy->GetQuantum());
+
+    strategy->SetQuantum(2);
+    CHECK_EQUAL(2, strategy->GetQuantum());
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    const size_t t1 = (size_t)task1.GetStack(), t2 = (size_t)task2.GetStack(), t3 = (size_t)task3.GetStack();
+
+    // every task runs for 2 ticks before it is rotated
+    const size_t expect[] = { t1, t1, t2, t2, t3, t3, t1, t1 };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        strategy->SetQuantum(0);
+        CHECK_TEXT(false, "expecting assertion on zero quantum");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+static struct QuantumRelaxCpuContext
+{
+    QuantumRelaxCpuContext() : counter(0), platform(NULL), active(0) {}
+
+    uint32_t          counter;
+    PlatformTestMock *platform;
+    size_t            active;
+
+    void Process()
+    {
+        platform->ProcessTick();
+
+        if (counter == 0)
+            active = platform->m_stack_active->SP;
+
+        ++counter;
+    }
+}
+g_QuantumRelaxCpuContext;
+
+static void QuantumRelaxCpu()
+{
+    g_QuantumRelaxCpuContext.Process();
+}
+
+TEST(SwitchStrategyRoundRobin, QuantumSleep)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    ((SwitchStrategyRoundRobin *)((IKernel &)kernel).GetSwitchStrategy())->SetQuantum(10);
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    platform->ProcessTick();
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    g_QuantumRelaxCpuContext = QuantumRelaxCpuContext();
+    g_QuantumRelaxCpuContext.platform = platform;
+    g_RelaxCpuHandler = QuantumRelaxCpu;
+
+    // sleeping task is switched out on the next tick regardless of its quantum
+    g_KernelService->Sleep(2);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(2, g_QuantumRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)task2.GetStack(), g_QuantumRelaxCpuContext.active);
+}
+
 } // namespace stk
 } // namespace test
@@ -0,0 +1,232 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ============================ SwitchStrategyStride ========================== //
+// ============================================================================ //
+
+TEST_GROUP(SwitchStrategyStride)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(SwitchStrategyStride, GetFirstEmpty)
+{
+    SwitchStrategyStride<> stride;
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        stride.GetFirst();
+        CHECK_TEXT(false, "expecting assertion when empty");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+TEST(SwitchStrategyStride, AddTaskFail)
+{
+    Kernel<KERNEL_DYNAMIC, 3, SwitchStrategyStride<1>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.AddTask(&task2);
+        CHECK_TEXT(false, "expecting to fail adding task exceeding capacity");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+
+    kernel.RemoveTask(&task1);
+    task3.m_weight = 0;
+
+    try
+    {
+        g_TestContext.ExpectAssert(true);
+        kernel.AddTask(&task3);
+        CHECK_TEXT(false, "expecting to fail adding task without tickets");
+    }
+    catch (TestAssertPassed &pass)
+    {
+        CHECK(true);
+        g_TestContext.ExpectAssert(false);
+    }
+}
+
+// implements mandatory methods of ITask only
+struct StrideMinimalTask : public ITask
+{
+    size_t *GetStack() { return m_stack; }
+    uint32_t GetStackSize() const { return STACK_SIZE_MIN; }
+    RunFuncType GetFunc() { return NULL; }
+    void *GetFuncUserData() { return NULL; }
+    EAccessMode GetAccessMode() const { return ACCESS_USER; }
+    void OnDeadlineMissed(uint32_t duration) { (void)duration; }
+
+    size_t m_stack[STACK_SIZE_MIN];
+};
+
+TEST(SwitchStrategyStride, DefaultWeight)
+{
+    StrideMinimalTask task;
+
+    CHECK_EQUAL(1, ((ITask &)task).GetWeight());
+    CHECK_EQUAL(DEADLINE_MISS_HARD_FAULT, ((ITask &)task).GetDeadlineMissPolicy());
+}
+
+TEST(SwitchStrategyStride, Proportion)
+{
+    Kernel<KERNEL_STATIC, 3, SwitchStrategyStride<3>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2, task3;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    task1.m_weight = 6;
+    task2.m_weight = 3;
+    task3.m_weight = 1;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.AddTask(&task3);
+    kernel.Start();
+
+    uint32_t count[3] = {};
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        size_t active = platform->m_stack_active->SP;
+
+        if (active == (size_t)task1.GetStack())
+            ++count[0];
+        else
+        if (active == (size_t)task2.GetStack())
+            ++count[1];
+        else
+        if (active == (size_t)task3.GetStack())
+            ++count[2];
+
+        platform->ProcessTick();
+    }
+
+    // 60%, 30% and 10% of CPU time
+    CHECK_EQUAL(60, count[0]);
+    CHECK_EQUAL(30, count[1]);
+    CHECK_EQUAL(10, count[2]);
+}
+
+static struct StrideRelaxCpuContext
+{
+    StrideRelaxCpuContext() : counter(0), platform(NULL), strategy(NULL), first(NULL) {}
+
+    uint32_t             counter;
+    PlatformTestMock    *platform;
+    ITaskSwitchStrategy *strategy;
+    ITask               *first;
+
+    void Process()
+    {
+        // heap root right after the task went to sleep, before the tick
+        if ((counter == 0) && (strategy != NULL))
+            first = strategy->GetFirst()->GetUserTask();
+
+        platform->ProcessTick();
+        ++counter;
+    }
+}
+g_StrideRelaxCpuContext;
+
+static void StrideRelaxCpu()
+{
+    g_StrideRelaxCpuContext.Process();
+}
+
+TEST(SwitchStrategyStride, SleepNoCredit)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyStride<2>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)task1.GetStack(), platform->m_stack_active->SP);
+
+    g_StrideRelaxCpuContext = StrideRelaxCpuContext();
+    g_StrideRelaxCpuContext.platform = platform;
+    g_StrideRelaxCpuContext.strategy = ((IKernel &)kernel).GetSwitchStrategy();
+    g_RelaxCpuHandler = StrideRelaxCpu;
+
+    // task1 sleeps while task2 is running alone
+    g_KernelService->Sleep(10);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(10, g_StrideRelaxCpuContext.counter);
+
+    // sleeping task leaves the heap as soon as it goes to sleep
+    CHECK_EQUAL(&task2, g_StrideRelaxCpuContext.first);
+
+    // woken task1 joins at the global pass and does not monopolize CPU to compensate its sleep time, after the
+    // first tick tasks have equal pass values and alternate
+    const size_t t1 = (size_t)task1.GetStack(), t2 = (size_t)task2.GetStack();
+    const size_t expect[] = { t1, t1, t2, t1, t2, t1, t2 };
+
+    CHECK_EQUAL(expect[0], platform->m_stack_active->SP);
+
+    for (uint32_t i = 1; i < (sizeof(expect) / sizeof(expect[0])); ++i)
+    {
+        platform->ProcessTick();
+        CHECK_EQUAL(expect[i], platform->m_stack_active->SP);
+    }
+}
+
+TEST(SwitchStrategyStride, OnTaskExit)
+{
+    Kernel<KERNEL_DYNAMIC, 2, SwitchStrategyStride<2>, PlatformTestMock> kernel;
+    TaskMock<ACCESS_PRIVILEGED> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    ITaskSwitchStrategy *strategy = ((IKernel &)kernel).GetSwitchStrategy();
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    platform->EventTaskExit(platform->m_stack_active);
+    platform->ProcessTick();
+    platform->ProcessTick();
+    CHECK_EQUAL(1, strategy->GetSize());
+
+    platform->EventTaskExit(platform->m_stack_active);
+    platform->ProcessTick();
+
+    CHECK_EQUAL(0, strategy->GetSize());
+    CHECK_EQUAL(platform->m_exit_trap, platform->m_stack_active);
+}
+
+} // namespace stk
+} // namespace test
@@ -0,0 +1,262 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ========================= Semaphore, Event, WaitAny ======================== //
+// ============================================================================ //
+
+TEST_GROUP(Sync)
+{
+    void setup() {}
+    void teardown() {}
+
+    struct Runner
+    {
+        Runner() : platform((PlatformTestMock *)kernel.GetPlatform())
+        {
+            kernel.Initialize();
+            kernel.AddTask(&task1);
+            kernel.AddTask(&task2);
+            kernel.Start();
+        }
+
+        Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+        TaskMock<ACCESS_USER> task1, task2;
+        PlatformTestMock *platform;
+    };
+};
+
+static struct SyncRelaxCpuContext
+{
+    SyncRelaxCpuContext() : counter(0), signal_at(0), stop_at(0), kill_at(0), semaphore(NULL), event(NULL),
+        platform(NULL), kernel(NULL), kill(NULL), active(0)
+    {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          signal_at;
+    uint32_t          stop_at;
+    uint32_t          kill_at;
+    Semaphore        *semaphore;
+    Event            *event;
+    PlatformTestMock *platform;
+    IKernel          *kernel;
+    ITask            *kill;
+    size_t            active;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop(); // leave infinite wait
+
+        platform->ProcessTick();
+
+        if (counter == 1)
+            active = platform->m_stack_active->SP;
+
+        // simulate ISR
+        if (counter == signal_at)
+        {
+            if (semaphore != NULL)
+                semaphore->Signal();
+
+            if (event != NULL)
+                event->Set();
+        }
+
+        // killed task never returns from the wait
+        if (counter == kill_at)
+        {
+            kernel->Kill(kill);
+            throw Stop();
+        }
+    }
+}
+g_SyncRelaxCpuContext;
+
+static void SyncRelaxCpu()
+{
+    g_SyncRelaxCpuContext.Process();
+}
+
+TEST(Sync, Semaphore)
+{
+    Runner r;
+    Semaphore sem(1, 2);
+
+    CHECK_EQUAL(1, sem.GetCount());
+
+    CHECK_TRUE(sem.Wait(0));
+    CHECK_FALSE(sem.Wait(0));
+
+    // count is limited
+    sem.Signal();
+    sem.Signal();
+    sem.Signal();
+    CHECK_EQUAL(2, sem.GetCount());
+
+    CHECK_TRUE(sem.Wait());
+    CHECK_TRUE(sem.Wait());
+    CHECK_EQUAL(0, sem.GetCount());
+
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(Sync, Event)
+{
+    Runner r;
+    Event event;
+
+    CHECK_FALSE(event.IsSet());
+    CHECK_FALSE(event.Wait(0));
+
+    event.Set();
+    CHECK_TRUE(event.IsSet());
+
+    // auto-reset
+    CHECK_TRUE(event.Wait(0));
+    CHECK_FALSE(event.IsSet());
+
+    event.Set();
+    event.Reset();
+    CHECK_FALSE(event.Wait(0));
+}
+
+TEST(Sync, WaitAnyReady)
+{
+    Runner r;
+    Semaphore sem1, sem2(1);
+    Event event(true);
+    WaitObject *objects[] = { &sem1, &sem2, &event };
+
+    // lowest index of the ready objects is taken without waiting
+    CHECK_EQUAL(1, WaitAny(objects, 3));
+    CHECK_EQUAL(2, WaitAny(objects, 3));
+    CHECK_EQUAL(WAIT_ANY_TIMEOUT, WaitAny(objects, 3, 0));
+
+    CHECK_FALSE(sem1.HasWaiters());
+}
+
+TEST(Sync, WaitAnyBlocks)
+{
+    Runner r;
+    Semaphore sem;
+    Event event1, event2;
+    WaitObject *objects[] = { &sem, &event1, &event2 };
+
+    g_SyncRelaxCpuContext = SyncRelaxCpuContext();
+    g_SyncRelaxCpuContext.platform  = r.platform;
+    g_SyncRelaxCpuContext.event     = &event2;
+    g_SyncRelaxCpuContext.signal_at = 3;
+    g_SyncRelaxCpuContext.stop_at   = 100;
+    g_RelaxCpuHandler = SyncRelaxCpu;
+
+    // task1 is not scheduled until any object is ready
+    CHECK_EQUAL(2, WaitAny(objects, 3));
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(3, g_SyncRelaxCpuContext.counter);
+    CHECK_EQUAL((size_t)r.task2.GetStack(), g_SyncRelaxCpuContext.active);
+    CHECK_FALSE(event2.IsSet());
+
+    // registrations are removed from all objects
+    CHECK_FALSE(sem.HasWaiters());
+    CHECK_FALSE(event1.HasWaiters());
+    CHECK_FALSE(event2.HasWaiters());
+
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(Sync, WaitAnyTimeout)
+{
+    Runner r;
+    Semaphore sem;
+    Event event;
+    WaitObject *objects[] = { &sem, &event };
+
+    g_SyncRelaxCpuContext = SyncRelaxCpuContext();
+    g_SyncRelaxCpuContext.platform = r.platform;
+    g_SyncRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = SyncRelaxCpu;
+
+    CHECK_EQUAL(WAIT_ANY_TIMEOUT, WaitAny(objects, 2, 5));
+    CHECK_EQUAL(5, g_SyncRelaxCpuContext.counter);
+
+    // semaphore signaled before the timeout
+    g_SyncRelaxCpuContext = SyncRelaxCpuContext();
+    g_SyncRelaxCpuContext.platform  = r.platform;
+    g_SyncRelaxCpuContext.semaphore = &sem;
+    g_SyncRelaxCpuContext.signal_at = 2;
+    g_SyncRelaxCpuContext.stop_at   = 100;
+
+    // active task waits
+    CHECK_TRUE(sem.Wait(5));
+    CHECK_EQUAL(2, g_SyncRelaxCpuContext.counter);
+    CHECK_EQUAL(0, sem.GetCount());
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_FALSE(sem.HasWaiters());
+    CHECK_FALSE(event.HasWaiters());
+}
+
+TEST(Sync, WaitAnyKilled)
+{
+    Kernel<KERNEL_DYNAMIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Semaphore sem;
+    Event event;
+    WaitObject *objects[] = { &sem, &event };
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    g_SyncRelaxCpuContext = SyncRelaxCpuContext();
+    g_SyncRelaxCpuContext.platform = platform;
+    g_SyncRelaxCpuContext.kernel   = &kernel;
+    g_SyncRelaxCpuContext.kill     = &task1;
+    g_SyncRelaxCpuContext.kill_at  = 2;
+    g_SyncRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = SyncRelaxCpu;
+
+    // task1 is killed by task2 while waiting
+    try
+    {
+        WaitAny(objects, 2);
+        CHECK_TEXT(false, "expecting killed task to not return");
+    }
+    catch (SyncRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    // registrations located on the stack of the killed task are removed
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+    CHECK_FALSE(sem.HasWaiters());
+    CHECK_FALSE(event.HasWaiters());
+    CHECK_EQUAL(1, ((IKernel &)kernel).GetSwitchStrategy()->GetSize());
+
+    // signal does not reference the killed task
+    sem.Signal();
+    CHECK_EQUAL(1, sem.GetCount());
+}
+
+} // namespace stk
+} // namespace test
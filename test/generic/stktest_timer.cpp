@@ -0,0 +1,425 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ================================= TimerHost ================================ //
+// ============================================================================ //
+
+TEST_GROUP(TimerHost)
+{
+    void setup() {}
+    void teardown() {}
+
+    typedef TimerHost<STACK_SIZE_MIN> Host;
+    typedef TimerHost<STACK_SIZE_MIN, 2, 2> HostSmall; // wheel range is 16 ticks
+
+    template <class _TyHost>
+    struct TimerMock : public Timer
+    {
+        TimerMock() : host(NULL), expired(0), expired_at(-1), stop_after(0) {}
+
+        void OnExpired()
+        {
+            ++expired;
+            expired_at = host->GetTicks();
+
+            if ((stop_after != 0) && (expired == stop_after))
+                host->Stop(this);
+        }
+
+        _TyHost  *host;
+        uint32_t  expired;
+        int64_t   expired_at;
+        uint32_t  stop_after;
+    };
+
+    template <class _TyHost>
+    struct Runner
+    {
+        Runner() : platform((PlatformTestMock *)kernel.GetPlatform())
+        {
+            kernel.Initialize();
+            kernel.AddTask(&task);
+            kernel.Start();
+        }
+
+        void Tick(uint32_t count = 1)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                platform->ProcessTick();
+                host.Process();
+            }
+        }
+
+        Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+        TaskMock<ACCESS_USER> task;
+        PlatformTestMock *platform;
+        _TyHost host;
+    };
+};
+
+TEST(TimerHost, OneShot)
+{
+    Runner<Host> r;
+    TimerMock<Host> timer;
+    timer.host = &r.host;
+
+    CHECK_FALSE(timer.IsActive());
+
+    r.host.Start(&timer, 5);
+
+    CHECK_TRUE(timer.IsActive());
+    CHECK_EQUAL(0, timer.GetPeriod());
+    CHECK_EQUAL(5, (int32_t)timer.GetExpiry());
+
+    r.Tick(4);
+    CHECK_EQUAL(0, timer.expired);
+
+    r.Tick();
+    CHECK_EQUAL(1, timer.expired);
+    CHECK_EQUAL(5, (int32_t)timer.expired_at);
+    CHECK_FALSE(timer.IsActive());
+
+    r.Tick(100);
+    CHECK_EQUAL(1, timer.expired);
+
+    // critical sections are balanced
+    CHECK_EQUAL(0, r.platform->m_cs_nesting);
+}
+
+TEST(TimerHost, Periodic)
+{
+    Runner<Host> r;
+    TimerMock<Host> timer;
+    timer.host = &r.host;
+
+    r.host.Start(&timer, 3, 10);
+
+    r.Tick(3);
+    CHECK_EQUAL(1, timer.expired);
+    CHECK_EQUAL(3, (int32_t)timer.expired_at);
+    CHECK_TRUE(timer.IsActive());
+
+    r.Tick(20);
+    CHECK_EQUAL(3, timer.expired);
+    CHECK_EQUAL(23, (int32_t)timer.expired_at);
+
+    CHECK_TRUE(r.host.Stop(&timer));
+    CHECK_FALSE(r.host.Stop(&timer));
+
+    r.Tick(100);
+    CHECK_EQUAL(3, timer.expired);
+}
+
+TEST(TimerHost, StopFromCallback)
+{
+    Runner<Host> r;
+    TimerMock<Host> timer;
+    timer.host       = &r.host;
+    timer.stop_after = 2;
+
+    r.host.Start(&timer, 1, 1);
+
+    r.Tick(10);
+    CHECK_EQUAL(2, timer.expired);
+    CHECK_FALSE(timer.IsActive());
+}
+
+TEST(TimerHost, Reset)
+{
+    Runner<Host> r;
+    TimerMock<Host> timer;
+    timer.host = &r.host;
+
+    r.host.Start(&timer, 5);
+    r.Tick(3);
+
+    // delay is counted from the current tick
+    r.host.Reset(&timer);
+
+    r.Tick(4);
+    CHECK_EQUAL(0, timer.expired);
+
+    r.Tick();
+    CHECK_EQUAL(1, timer.expired);
+    CHECK_EQUAL(8, (int32_t)timer.expired_at);
+
+    // expired one-shot timer is started again
+    r.host.Reset(&timer);
+    CHECK_TRUE(timer.IsActive());
+
+    r.Tick(5);
+    CHECK_EQUAL(2, timer.expired);
+    CHECK_EQUAL(13, (int32_t)timer.expired_at);
+}
+
+TEST(TimerHost, Cascade)
+{
+    Runner<HostSmall> r;
+
+    enum { TIMERS = 6 };
+    const uint32_t delay[TIMERS] = { 1, 4, 15, 16, 17, 1000 };
+    TimerMock<HostSmall> timer[TIMERS];
+
+    // start at a non-zero tick to not align with the wheel windows
+    r.Tick(3);
+
+    for (uint32_t i = 0; i < TIMERS; ++i)
+    {
+        timer[i].host = &r.host;
+        r.host.Start(&timer[i], delay[i]);
+    }
+
+    r.Tick(1000);
+
+    // timers beyond the wheel range are cascaded and expire on the exact tick
+    for (uint32_t i = 0; i < TIMERS; ++i)
+    {
+        CHECK_EQUAL(1, timer[i].expired);
+        CHECK_EQUAL(3 + delay[i], (uint32_t)timer[i].expired_at);
+    }
+}
+
+TEST(TimerHost, CatchUp)
+{
+    Runner<HostSmall> r;
+    TimerMock<HostSmall> timer1, timer2;
+    timer1.host = &r.host;
+    timer2.host = &r.host;
+
+    r.host.Start(&timer1, 2, 2);
+    r.host.Start(&timer2, 7);
+
+    // daemon task did not run for 10 ticks
+    for (uint32_t i = 0; i < 10; ++i)
+        r.platform->ProcessTick();
+
+    CHECK_EQUAL(0, timer1.expired);
+
+    r.host.Process();
+
+    // missed ticks are processed in order
+    CHECK_EQUAL(10, (int32_t)r.host.GetTicks());
+    CHECK_EQUAL(5, timer1.expired);
+    CHECK_EQUAL(10, (int32_t)timer1.expired_at);
+    CHECK_EQUAL(1, timer2.expired);
+    CHECK_EQUAL(7, (int32_t)timer2.expired_at);
+}
+
+static struct TimerRelaxCpuContext
+{
+    TimerRelaxCpuContext() : counter(0), stop_at(0), platform(NULL) {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          stop_at;
+    PlatformTestMock *platform;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop(); // leave infinite loop of the daemon task
+
+        platform->ProcessTick();
+    }
+}
+g_TimerRelaxCpuContext;
+
+static void TimerRelaxCpu()
+{
+    g_TimerRelaxCpuContext.Process();
+}
+
+TEST(TimerHost, DaemonTask)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TimerMock<Host> timer;
+    Host host;
+    timer.host = &host;
+
+    CHECK_EQUAL(&host, host.GetFuncUserData());
+    CHECK_EQUAL(ACCESS_PRIVILEGED, host.GetAccessMode());
+
+    kernel.Initialize();
+    kernel.AddTask(&host);
+    kernel.Start();
+
+    host.Start(&timer, 2, 3);
+
+    g_TimerRelaxCpuContext = TimerRelaxCpuContext();
+    g_TimerRelaxCpuContext.platform = (PlatformTestMock *)kernel.GetPlatform();
+    g_TimerRelaxCpuContext.stop_at  = 10;
+    g_RelaxCpuHandler = TimerRelaxCpu;
+
+    try
+    {
+        // daemon task waits until the next expiry
+        host.GetFunc()(host.GetFuncUserData());
+    }
+    catch (TimerRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    // expired at 2, 5, 8, ticks 9 and 10 are not processed while daemon waits for the expiry at 11
+    CHECK_EQUAL(3, timer.expired);
+    CHECK_EQUAL(8, (int32_t)timer.expired_at);
+    CHECK_EQUAL(8, (int32_t)host.GetTicks());
+}
+
+static struct TimerLateRelaxCpuContext
+{
+    TimerLateRelaxCpuContext() : counter(0), platform(NULL), host(NULL), timer(NULL) {}
+
+    uint32_t                   counter;
+    PlatformTestMock          *platform;
+    TimerHost<STACK_SIZE_MIN> *host;
+    Timer                     *timer;
+
+    void Process()
+    {
+        ++counter;
+
+        // idle daemon does not process ticks
+        if (counter == 5)
+        {
+            CHECK_EQUAL(1000, (int32_t)host->GetTicks());
+            host->Start(timer, 3);
+        }
+        else
+        if (counter > 10)
+        {
+            throw TimerRelaxCpuContext::Stop();
+        }
+
+        platform->ProcessTick();
+    }
+}
+g_TimerLateRelaxCpuContext;
+
+static void TimerLateRelaxCpu()
+{
+    g_TimerLateRelaxCpuContext.Process();
+}
+
+TEST(TimerHost, DaemonStartedLate)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TimerMock<Host> timer;
+    Host host;
+    timer.host = &host;
+
+    kernel.Initialize();
+    kernel.AddTask(&host);
+    kernel.Start();
+
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+
+    // daemon task is started when Kernel runs for a while already
+    for (uint32_t i = 0; i < 1000; ++i)
+        platform->ProcessTick();
+
+    g_TimerLateRelaxCpuContext = TimerLateRelaxCpuContext();
+    g_TimerLateRelaxCpuContext.platform = platform;
+    g_TimerLateRelaxCpuContext.host     = &host;
+    g_TimerLateRelaxCpuContext.timer    = &timer;
+    g_RelaxCpuHandler = TimerLateRelaxCpu;
+
+    try
+    {
+        host.GetFunc()(host.GetFuncUserData());
+    }
+    catch (TimerRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    // started timer wakes daemon task up and expires on time
+    CHECK_EQUAL(1, timer.expired);
+    CHECK_EQUAL(1007, (int32_t)timer.expired_at);
+    CHECK_EQUAL(1007, (int32_t)host.GetTicks());
+}
+
+// ============================================================================ //
+// =============================== PeriodicTimer ============================== //
+// ============================================================================ //
+
+TEST_GROUP(PeriodicTimer)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(PeriodicTimer, Release)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    PeriodicTimer timer(4);
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    g_TimerRelaxCpuContext = TimerRelaxCpuContext();
+    g_TimerRelaxCpuContext.platform = platform;
+    g_TimerRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = TimerRelaxCpu;
+
+    int64_t start = g_KernelService->GetTicks();
+
+    timer.Start();
+    CHECK_EQUAL(4, timer.GetPeriod());
+    CHECK_EQUAL(start + 4, timer.GetNextRelease());
+
+    CHECK_EQUAL(0, timer.Wait());
+    CHECK_EQUAL(start + 4, g_KernelService->GetTicks());
+
+    // work took 3 ticks, release does not drift by the execution time
+    for (int32_t i = 0; i < 3; ++i)
+        platform->ProcessTick();
+
+    CHECK_EQUAL(0, timer.Wait());
+    CHECK_EQUAL(start + 8, g_KernelService->GetTicks());
+
+    // overrun: work took 5 ticks, task is released immediately
+    for (int32_t i = 0; i < 5; ++i)
+        platform->ProcessTick();
+
+    CHECK_EQUAL(1, timer.Wait());
+    CHECK_EQUAL(start + 13, g_KernelService->GetTicks());
+    CHECK_EQUAL(start + 16, timer.GetNextRelease());
+
+    // releases which elapsed while working are skipped, phase is kept
+    for (int32_t i = 0; i < 10; ++i)
+        platform->ProcessTick();
+
+    CHECK_EQUAL(2, timer.Wait());
+    CHECK_EQUAL(start + 24, timer.GetNextRelease());
+
+    CHECK_EQUAL(0, timer.Wait());
+    CHECK_EQUAL(start + 24, g_KernelService->GetTicks());
+    CHECK_EQUAL(3, timer.GetOverruns());
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+} // namespace stk
+} // namespace test
@@ -0,0 +1,276 @@
+/*
+ * SuperTinyKernel: Minimalistic thread scheduling kernel for Embedded systems.
+ *
+ * Source: http://github.com/dmitrykos/stk
+ *
+ * Copyright (c) 2022 Dmitry Kostjucenko <dmitry.kostjucenko@gmail.com>
+ * License: MIT License, see LICENSE for a full text.
+ */
+
+#include "stktest.h"
+
+namespace stk {
+namespace test {
+
+// ============================================================================ //
+// ================================ WorkerPool ================================ //
+// ============================================================================ //
+
+TEST_GROUP(WorkerPool)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+typedef WorkerPool<2, 4, STACK_SIZE_MIN> Pool;
+
+static void JobAdd(void *arg)
+{
+    ++(*(uint32_t *)arg);
+}
+
+TEST(WorkerPool, SubmitProcess)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Pool pool;
+    JobGroup group;
+    uint32_t sum = 0;
+
+    CHECK_EQUAL(2, pool.GetWorkerCount());
+    CHECK_EQUAL(ACCESS_PRIVILEGED, pool.GetWorker(1)->GetAccessMode());
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    CHECK_TRUE(group.IsDone());
+
+    CHECK_TRUE(pool.Submit(&JobAdd, &sum, &group));
+    CHECK_TRUE(pool.Submit(&JobAdd, &sum, &group));
+    CHECK_TRUE(pool.Submit(&JobAdd, &sum));
+    CHECK_EQUAL(3, pool.GetSize());
+    CHECK_EQUAL(2, group.GetPending());
+
+    CHECK_EQUAL(3, pool.Process());
+    CHECK_EQUAL(3, sum);
+    CHECK_EQUAL(0, pool.GetSize());
+    CHECK_TRUE(group.IsDone());
+
+    // completed group is joined without waiting
+    CHECK_TRUE(group.Join());
+
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(WorkerPool, SubmitFull)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    WorkerPool<1, 2, STACK_SIZE_MIN> pool;
+    JobGroup group;
+    uint32_t sum = 0;
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    CHECK_TRUE(pool.Submit(&JobAdd, &sum, &group));
+    CHECK_TRUE(pool.Submit(&JobAdd, &sum, &group));
+    CHECK_FALSE(pool.Submit(&JobAdd, &sum, &group));
+
+    // rejected job is not counted in the group
+    CHECK_EQUAL(2, group.GetPending());
+}
+
+static struct WorkerPoolRelaxCpuContext
+{
+    WorkerPoolRelaxCpuContext() : counter(0), submit_at(0), process_at(0), stop_at(0), sum(0), pool(NULL),
+        group(NULL), platform(NULL), notify(NULL)
+    {}
+
+    struct Stop {};
+
+    uint32_t          counter;
+    uint32_t          submit_at;
+    uint32_t          process_at;
+    uint32_t          stop_at;
+    uint32_t          sum;
+    Pool             *pool;
+    JobGroup         *group;
+    PlatformTestMock *platform;
+    ITask            *notify;
+
+    void Process()
+    {
+        if (++counter > stop_at)
+            throw Stop(); // leave infinite wait
+
+        // simulate stale notification, task is woken up by the tick
+        if (notify != NULL)
+            g_KernelService->Notify(notify);
+
+        platform->ProcessTick();
+
+        // simulate ISR
+        if (counter == submit_at)
+            pool->Submit(&JobAdd, &sum, group);
+
+        // simulate worker
+        if (counter == process_at)
+            pool->Process();
+    }
+}
+g_WorkerPoolRelaxCpuContext;
+
+static void WorkerPoolRelaxCpu()
+{
+    g_WorkerPoolRelaxCpuContext.Process();
+}
+
+TEST(WorkerPool, Join)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task1, task2;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Pool pool;
+    JobGroup group;
+
+    kernel.Initialize();
+    kernel.AddTask(&task1);
+    kernel.AddTask(&task2);
+    kernel.Start();
+
+    g_WorkerPoolRelaxCpuContext = WorkerPoolRelaxCpuContext();
+    g_WorkerPoolRelaxCpuContext.platform   = platform;
+    g_WorkerPoolRelaxCpuContext.pool       = &pool;
+    g_WorkerPoolRelaxCpuContext.process_at = 5;
+    g_WorkerPoolRelaxCpuContext.stop_at    = 100;
+    g_RelaxCpuHandler = WorkerPoolRelaxCpu;
+
+    pool.Submit(&JobAdd, &g_WorkerPoolRelaxCpuContext.sum, &group);
+    pool.Submit(&JobAdd, &g_WorkerPoolRelaxCpuContext.sum, &group);
+
+    // task1 is not scheduled until all jobs are completed
+    CHECK_TRUE(group.Join());
+    CHECK_EQUAL((size_t)task2.GetStack(), platform->m_stack_active->SP);
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(5, g_WorkerPoolRelaxCpuContext.counter);
+    CHECK_EQUAL(2, g_WorkerPoolRelaxCpuContext.sum);
+    CHECK_TRUE(group.IsDone());
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+TEST(WorkerPool, JoinTimeout)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Pool pool;
+    JobGroup group;
+    uint32_t sum = 0;
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    g_WorkerPoolRelaxCpuContext = WorkerPoolRelaxCpuContext();
+    g_WorkerPoolRelaxCpuContext.platform = platform;
+    g_WorkerPoolRelaxCpuContext.pool     = &pool;
+    g_WorkerPoolRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = WorkerPoolRelaxCpu;
+
+    pool.Submit(&JobAdd, &sum, &group);
+
+    // job is not taken by a worker
+    CHECK_FALSE(group.Join(10));
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(10, g_WorkerPoolRelaxCpuContext.counter);
+    CHECK_EQUAL(1, group.GetPending());
+
+    // group can be joined again
+    CHECK_EQUAL(1, pool.Process());
+    CHECK_TRUE(group.Join(10));
+}
+
+TEST(WorkerPool, JoinTimeoutNotExtended)
+{
+    Kernel<KERNEL_STATIC, 1, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Pool pool;
+    JobGroup group;
+    uint32_t sum = 0;
+
+    kernel.Initialize();
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    g_WorkerPoolRelaxCpuContext = WorkerPoolRelaxCpuContext();
+    g_WorkerPoolRelaxCpuContext.platform = platform;
+    g_WorkerPoolRelaxCpuContext.pool     = &pool;
+    g_WorkerPoolRelaxCpuContext.notify   = &task;
+    g_WorkerPoolRelaxCpuContext.stop_at  = 100;
+    g_RelaxCpuHandler = WorkerPoolRelaxCpu;
+
+    pool.Submit(&JobAdd, &sum, &group);
+
+    // task is woken up on every tick but waits for the remaining time only
+    CHECK_FALSE(group.Join(10));
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(10, g_WorkerPoolRelaxCpuContext.counter);
+    CHECK_EQUAL(1, group.GetPending());
+}
+
+TEST(WorkerPool, WorkerTask)
+{
+    Kernel<KERNEL_STATIC, 2, SwitchStrategyRoundRobin, PlatformTestMock> kernel;
+    TaskMock<ACCESS_USER> task;
+    PlatformTestMock *platform = (PlatformTestMock *)kernel.GetPlatform();
+    Pool pool;
+    JobGroup group;
+    ITask *worker = pool.GetWorker(0);
+
+    kernel.Initialize();
+    kernel.AddTask(worker);
+    kernel.AddTask(&task);
+    kernel.Start();
+
+    CHECK_EQUAL((size_t)worker->GetStack(), platform->m_stack_active->SP);
+
+    g_WorkerPoolRelaxCpuContext = WorkerPoolRelaxCpuContext();
+    g_WorkerPoolRelaxCpuContext.platform  = platform;
+    g_WorkerPoolRelaxCpuContext.pool      = &pool;
+    g_WorkerPoolRelaxCpuContext.group     = &group;
+    g_WorkerPoolRelaxCpuContext.submit_at = 3;
+    g_WorkerPoolRelaxCpuContext.stop_at   = 3;
+    g_RelaxCpuHandler = WorkerPoolRelaxCpu;
+
+    try
+    {
+        // idle worker waits for a job and is woken up by Submit
+        worker->GetFunc()(worker->GetFuncUserData());
+    }
+    catch (WorkerPoolRelaxCpuContext::Stop &)
+    {
+    }
+
+    g_RelaxCpuHandler = NULL;
+
+    CHECK_EQUAL(1, g_WorkerPoolRelaxCpuContext.sum);
+    CHECK_TRUE(group.IsDone());
+
+    // worker is idle again
+    CHECK_EQUAL(1, pool.GetIdleCount());
+    CHECK_EQUAL(0, platform->m_cs_nesting);
+}
+
+} // namespace stk
+} // namespace test
@@ -77,6 +77,7 @@ public:
         m_stack_idle        = NULL;
         m_stack_active      = NULL;
         m_overrider         = NULL;
+        m_cs_nesting        = 0;
     }
 
     virtual ~PlatformTestMock()
@@ -107,8 +108,9 @@ public:
         m_stack_info[type].memory = stack_memory;
         m_stack_info[type].task   = user_task;
 
-        // required to pass assertion checks when switching tasks
-        PlatformContext::InitStackMemory(stack_memory);
+        // required to pass assertion checks when switching tasks, restarted task keeps its stack memory
+        if (type != STACK_USER_TASK_RESTART)
+            PlatformContext::InitStackMemory(stack_memory);
 
         stack->SP = (size_t)stack_memory->GetStack();
         return true;
@@ -135,6 +137,11 @@ public:
         m_event_handler->OnTaskSleep(m_stack_active->SP, ticks);
     }
 
+    void Reschedule()
+    {
+        EventReschedule();
+    }
+
     void ProcessHardFault()
     {
         m_hard_fault = true;
@@ -163,6 +170,12 @@ public:
         m_event_handler->OnTaskExit(stack);
     }
 
+    void EventReschedule()
+    {
+        if (m_event_handler->OnReschedule(&m_stack_idle, &m_stack_active))
+            ++m_context_switch_nr;
+    }
+
     void EventTaskSwitch(size_t caller_SP)
     {
         m_event_handler->OnTaskSwitch(caller_SP);
@@ -178,6 +191,17 @@ public:
         return m_stack_active->SP;
     }
 
+    void EnterCriticalSection()
+    {
+        ++m_cs_nesting;
+    }
+
+    void ExitCriticalSection()
+    {
+        STK_ASSERT(m_cs_nesting != 0);
+        --m_cs_nesting;
+    }
+
     Stack           *m_exit_trap;
     bool             m_fail_InitStack;
     int32_t          m_resolution;
@@ -189,7 +213,8 @@ public:
     IEventOverrider *m_overrider;
     Stack           *m_stack_idle;
     Stack           *m_stack_active;
-    StackInfo        m_stack_info[STACK_EXIT_TRAP + 1];
+    StackInfo        m_stack_info[STACK_USER_TASK_RESTART + 1];
+    uint32_t         m_cs_nesting;
 
 protected:
     IEventHandler *m_event_handler;
@@ -207,6 +232,7 @@ public:
         m_switch_to_next = false;
         m_ticks          = 0;
         m_resolution     = 0;
+        m_cs_nesting     = 0;
     }
     virtual ~KernelServiceMock()
     { }
@@ -234,15 +260,79 @@ public:
         (void)sleep_ms;
     }
 
+    void SleepUntil(int64_t ticks)
+    {
+        (void)ticks;
+    }
+
     void SwitchToNext()
     {
         m_switch_to_next = true;
     }
 
-    bool    m_inc_ticks;
-    bool    m_switch_to_next;
-    int64_t m_ticks;
-    int32_t m_resolution;
+    bool Wait(uint32_t timeout_ms)
+    {
+        (void)timeout_ms;
+        return false;
+    }
+
+    bool WaitUntil(int64_t ticks)
+    {
+        (void)ticks;
+        return false;
+    }
+
+    void Notify(ITask *user_task)
+    {
+        (void)user_task;
+    }
+
+    void Handoff(ITask *user_task)
+    {
+        (void)user_task;
+    }
+
+    uint32_t StartGracePeriod()
+    {
+        return 0;
+    }
+
+    bool IsGracePeriodCompleted(uint32_t gp) const
+    {
+        (void)gp;
+        return true;
+    }
+
+    void SetWaitRegistration(IWaitRegistration *reg)
+    {
+        (void)reg;
+    }
+
+    void SetExitCode(int32_t exit_code)
+    {
+        (void)exit_code;
+    }
+
+    ITask *GetCurrentTask()
+    {
+        return NULL;
+    }
+
+    void EnterCriticalSection()
+    {
+        ++m_cs_nesting;
+    }
+
+    void ExitCriticalSection()
+    {
+        --m_cs_nesting;
+    }
+
+    bool     m_inc_ticks;
+    bool     m_switch_to_next;
+    int64_t  m_ticks;
+    int32_t  m_resolution;
+    uint32_t m_cs_nesting;
 };
 
 /*! \class TaskMock
@@ -253,10 +343,14 @@ template <EAccessMode _AccessMode>
 class TaskMock : public Task<STACK_SIZE_MIN, _AccessMode>
 {
 public:
+    TaskMock() : m_deadline_missed(0), m_deadline_miss_policy(DEADLINE_MISS_HARD_FAULT), m_weight(1) {}
+
     RunFuncType GetFunc() { return &Run; }
     void *GetFuncUserData() { return this; }
 
-    uint32_t m_deadline_missed; //!< duration of workload if deadline is missed in HRT mode
+    uint32_t            m_deadline_missed;      //!< duration of workload if deadline is missed in HRT mode
+    EDeadlineMissPolicy m_deadline_miss_policy; //!< reaction to the missed deadline in HRT mode
+    uint32_t            m_weight;               //!< weight for the proportional-share scheduling
 
 private:
     static void Run(void *user_data)
@@ -273,6 +367,22 @@ private:
 
         m_deadline_missed = duration;
     }
+
+    EDeadlineMissPolicy GetDeadlineMissPolicy() const
+    {
+        // call base (to achieve full coverage)
+        Task<STACK_SIZE_MIN, _AccessMode>::GetDeadlineMissPolicy();
+
+        return m_deadline_miss_policy;
+    }
+
+    uint32_t GetWeight() const
+    {
+        // call base (to achieve full coverage)
+        Task<STACK_SIZE_MIN, _AccessMode>::GetWeight();
+
+        return m_weight;
+    }
 };
 
 } // namespace test